@@ -36,6 +36,9 @@ function getToolkitFunction(VerovioModule, method) {
     // char *getElementsAtTime(Toolkit *ic, int time)
     mapping.getElementsAtTime = VerovioModule.cwrap("vrvToolkit_getElementsAtTime", "string", ["number", "number"]);
 
+    // char *getElementsInTimeRange(Toolkit *ic, int startTime, int endTime)
+    mapping.getElementsInTimeRange = VerovioModule.cwrap("vrvToolkit_getElementsInTimeRange", "string", ["number", "number", "number"]);
+
     // char *vrvToolkit_getExpansionIdsForElement(Toolkit *tk, const char *xmlId);
     mapping.getExpansionIdsForElement = VerovioModule.cwrap("vrvToolkit_getExpansionIdsForElement", "string", ["number", "string"]);
 
@@ -75,6 +78,9 @@ function getToolkitFunction(VerovioModule, method) {
     // char *getTimesForElement(Toolkit *ic, const char *xmlId)
     mapping.getTimesForElement = VerovioModule.cwrap("vrvToolkit_getTimesForElement", "string", ["number", "string"]);
 
+    // char *getTimesForElements(Toolkit *ic, const char *c_options)
+    mapping.getTimesForElements = VerovioModule.cwrap("vrvToolkit_getTimesForElements", "string", ["number", "string"]);
+
     // char *getMIDIValuesForElement(Toolkit *ic, const char *xmlId)
     mapping.getMIDIValuesForElement = VerovioModule.cwrap("vrvToolkit_getMIDIValuesForElement", "string", ["number", "string"]);
 
@@ -99,15 +105,42 @@ function getToolkitFunction(VerovioModule, method) {
     // char *renderData(Toolkit *ic, const char *data, const char *options)
     mapping.renderData = VerovioModule.cwrap("vrvToolkit_renderData", "string", ["number", "string", "string"]);
 
+    // unsigned char *renderToBinaryBuffer(Toolkit *ic, int pageNo)
+    mapping.renderToBinaryBuffer = VerovioModule.cwrap("vrvToolkit_renderToBinaryBuffer", "number", ["number", "number"]);
+
+    // int getBinaryBufferSize(Toolkit *ic)
+    mapping.getBinaryBufferSize = VerovioModule.cwrap("vrvToolkit_getBinaryBufferSize", "number", ["number"]);
+
     // char *renderToMidi(Toolkit *ic, const char *rendering_options)
     mapping.renderToMIDI = VerovioModule.cwrap("vrvToolkit_renderToMIDI", "string", ["number", "string"]);
 
+    // char *renderToMIDIChunk(Toolkit *ic, const char *c_options)
+    mapping.renderToMIDIChunk = VerovioModule.cwrap("vrvToolkit_renderToMIDIChunk", "string", ["number", "string"]);
+
+    // char *renderToMIDIEvents(Toolkit *ic)
+    mapping.renderToMIDIEvents = VerovioModule.cwrap("vrvToolkit_renderToMIDIEvents", "string", ["number"]);
+
     // char *renderToPAE(Toolkit *ic)
     mapping.renderToPAE = VerovioModule.cwrap("vrvToolkit_renderToPAE", "string");
 
+    // unsigned char *renderToPNGBuffer(Toolkit *ic, int pageNo)
+    mapping.renderToPNGBuffer = VerovioModule.cwrap("vrvToolkit_renderToPNGBuffer", "number", ["number", "number"]);
+
     // char *renderToSvg(Toolkit *ic, int pageNo, int xmlDeclaration)
     mapping.renderToSVG = VerovioModule.cwrap("vrvToolkit_renderToSVG", "string", ["number", "number", "number"]);
 
+    // char *renderToSVGDocument(Toolkit *ic, const char *options)
+    mapping.renderToSVGDocument = VerovioModule.cwrap("vrvToolkit_renderToSVGDocument", "string", ["number", "string"]);
+
+    // char *renderToSVGPages(Toolkit *ic, const char *options)
+    mapping.renderToSVGPages = VerovioModule.cwrap("vrvToolkit_renderToSVGPages", "string", ["number", "string"]);
+
+    // char *renderToSVGRegion(Toolkit *ic, int pageNo, const char *options)
+    mapping.renderToSVGRegion = VerovioModule.cwrap("vrvToolkit_renderToSVGRegion", "string", ["number", "number", "string"]);
+
+    // unsigned char *renderToSVGZBuffer(Toolkit *ic, int pageNo)
+    mapping.renderToSVGZBuffer = VerovioModule.cwrap("vrvToolkit_renderToSVGZBuffer", "number", ["number", "number"]);
+
     // char *renderToTimemap(Toolkit *ic)
     mapping.renderToTimemap = VerovioModule.cwrap("vrvToolkit_renderToTimemap", "string", ["number", "string"]);
 
@@ -44,6 +44,10 @@ export class VerovioToolkit {
         return JSON.parse(this.proxy.getElementsAtTime(this.ptr, millisec));
     }
 
+    getElementsInTimeRange(startMillisec, endMillisec) {
+        return JSON.parse(this.proxy.getElementsInTimeRange(this.ptr, startMillisec, endMillisec));
+    }
+
     getExpansionIdsForElement(xmlId) {
         return JSON.parse(this.proxy.getExpansionIdsForElement(this.ptr, xmlId));
     }
@@ -100,6 +104,10 @@ export class VerovioToolkit {
         return JSON.parse(this.proxy.getTimesForElement(this.ptr, xmlId));
     }
 
+    getTimesForElements(options) {
+        return JSON.parse(this.proxy.getTimesForElements(this.ptr, JSON.stringify(options)));
+    }
+
     getVersion() {
         return this.proxy.getVersion(this.ptr);
     }
@@ -143,10 +151,25 @@ export class VerovioToolkit {
         return this.proxy.renderToSVG(this.ptr, pageNo, JSON.stringify(options));
     }
 
+    renderToBinary(pageNo = 1) {
+        var dataPtr = this.proxy.renderToBinaryBuffer(this.ptr, pageNo);
+        var dataSize = this.proxy.getBinaryBufferSize(this.ptr);
+        // copy the content of the buffer since it is reused by the next rendering
+        return this.VerovioModule.HEAPU8.slice(dataPtr, dataPtr + dataSize).buffer;
+    }
+
     renderToMIDI(options) {
         return this.proxy.renderToMIDI(this.ptr, JSON.stringify(options));
     }
 
+    renderToMIDIChunk(options) {
+        return this.proxy.renderToMIDIChunk(this.ptr, JSON.stringify(options));
+    }
+
+    renderToMIDIEvents() {
+        return JSON.parse(this.proxy.renderToMIDIEvents(this.ptr));
+    }
+
     renderToMidi(options) {
         console.warn("Method renderToMidi is deprecated; use renderToMIDI instead");
         return this.proxy.renderToMIDI(this.ptr, JSON.stringify(options));
@@ -156,10 +179,36 @@ export class VerovioToolkit {
         return this.proxy.renderToPAE(this.ptr);
     }
 
+    renderToPNG(pageNo = 1) {
+        var dataPtr = this.proxy.renderToPNGBuffer(this.ptr, pageNo);
+        var dataSize = this.proxy.getBinaryBufferSize(this.ptr);
+        // copy the content of the buffer since it is reused by the next rendering
+        return this.VerovioModule.HEAPU8.slice(dataPtr, dataPtr + dataSize).buffer;
+    }
+
     renderToSVG(pageNo = 1, xmlDeclaration = false) {
         return this.proxy.renderToSVG(this.ptr, pageNo, xmlDeclaration);
     }
 
+    renderToSVGDocument(options = {}) {
+        return this.proxy.renderToSVGDocument(this.ptr, JSON.stringify(options));
+    }
+
+    renderToSVGPages(options = {}) {
+        return JSON.parse(this.proxy.renderToSVGPages(this.ptr, JSON.stringify(options)));
+    }
+
+    renderToSVGRegion(pageNo = 1, options = {}) {
+        return this.proxy.renderToSVGRegion(this.ptr, pageNo, JSON.stringify(options));
+    }
+
+    renderToSVGZ(pageNo = 1) {
+        var dataPtr = this.proxy.renderToSVGZBuffer(this.ptr, pageNo);
+        var dataSize = this.proxy.getBinaryBufferSize(this.ptr);
+        // copy the content of the buffer since it is reused by the next rendering
+        return this.VerovioModule.HEAPU8.slice(dataPtr, dataPtr + dataSize).buffer;
+    }
+
     renderToTimemap(options = {}) {
         return JSON.parse(this.proxy.renderToTimemap(this.ptr, JSON.stringify(options)));
     }
@@ -0,0 +1,115 @@
+#! /usr/bin/env python3
+
+# Generate a C++ file embedding the content of the resource directory (fonts, glyphs, text font metrics)
+# It is used by the EMBED_RESOURCES build option and is not meant to be committed
+#
+# Usage: generate-embedded-resources.py <data directory> <output file>
+
+import os
+import sys
+
+# Extensions of the files to embed - this is what is installed with the library
+EXTENSIONS = (".xml", ".svg")
+
+# Maximum length of a string literal line
+CHUNK_LENGTH = 4000
+
+######################
+#  Helper Functions  #
+######################
+
+# Escape a byte string as the content of a C++ string literal
+
+
+def escape_chunk(chunk) -> str:
+    escaped = []
+    for byte in chunk:
+        char = chr(byte)
+        if char == "\\":
+            escaped.append("\\\\")
+        elif char == "\"":
+            escaped.append("\\\"")
+        elif char == "\n":
+            escaped.append("\\n")
+        elif char == "?":
+            # avoid trigraphs
+            escaped.append("\\?")
+        elif 32 <= byte < 127:
+            escaped.append(char)
+        else:
+            # always use three octal digits so the next char is never part of the escape sequence
+            escaped.append("\\%03o" % byte)
+    return "".join(escaped)
+
+# Return the files to embed as a sorted list of names relative to the data directory
+
+
+def get_resource_files(data_dir) -> list:
+    files = []
+    for root, dirs, filenames in os.walk(data_dir):
+        for filename in filenames:
+            if filename.endswith(EXTENSIONS):
+                path = os.path.relpath(os.path.join(root, filename), data_dir)
+                files.append(path.replace(os.sep, "/"))
+    return sorted(files)
+
+#####################
+#  Generate C++     #
+#####################
+
+
+def generate(data_dir, output):
+    files = get_resource_files(data_dir)
+
+    lines = []
+    lines.append("/////////////////////////////////////////////////////////////////////////////")
+    lines.append("// Authors:     generated by fonts/generate-embedded-resources.py")
+    lines.append("// Copyright (c) Authors and others. All rights reserved.")
+    lines.append("//")
+    lines.append("// Do not edit - this file is generated at build time with EMBED_RESOURCES")
+    lines.append("/////////////////////////////////////////////////////////////////////////////")
+    lines.append("")
+    lines.append("#include \"resources.h\"")
+    lines.append("")
+    lines.append("namespace vrv {")
+    lines.append("")
+
+    for idx, name in enumerate(files):
+        with open(os.path.join(data_dir, name), "rb") as file:
+            content = file.read()
+        lines.append("// %s" % name)
+        lines.append("static const char s_file%d[] =" % idx)
+        if not content:
+            lines.append("    \"\"")
+        for start in range(0, len(content), CHUNK_LENGTH):
+            lines.append("    \"%s\"" % escape_chunk(content[start:start + CHUNK_LENGTH]))
+        lines[-1] += ";"
+        lines.append("")
+
+    lines.append("const Resources::EmbeddedFileMap &Resources::GetEmbeddedFiles()")
+    lines.append("{")
+    lines.append("    static const EmbeddedFileMap embeddedFiles = {")
+    for idx, name in enumerate(files):
+        lines.append("        { \"%s\", { s_file%d, sizeof(s_file%d) - 1 } }," % (name, idx, idx))
+    lines.append("    };")
+    lines.append("    return embeddedFiles;")
+    lines.append("}")
+    lines.append("")
+    lines.append("} // namespace vrv")
+    lines.append("")
+
+    content = "\n".join(lines)
+    # Do not touch the file if nothing changed to avoid recompiling it
+    if os.path.exists(output):
+        with open(output, "r") as file:
+            if file.read() == content:
+                return
+    with open(output, "w") as file:
+        file.write(content)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        print("Usage: generate-embedded-resources.py <data directory> <output file>")
+        sys.exit(1)
+    generate(sys.argv[1], sys.argv[2])
@@ -58,6 +58,7 @@ class MidiEvent : public MidiMessage {
 		double     seconds;  // calculated time in sec. (after doTimeAnalysis())
 		int        seq;      // sorting sequence number of event
         int        layer;
+        int        element;  // handle of the element generating the event, or -1
 
 	private:
 		MidiEvent* m_eventlink;  // used to match note-ons and note-offs
@@ -0,0 +1,272 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        binarydevicecontext.h
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRV_BINARY_DC_H__
+#define __VRV_BINARY_DC_H__
+
+#include <map>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+#include "devicecontext.h"
+
+namespace vrv {
+
+class Glyph;
+class Object;
+class View;
+
+/**
+ * The commands of the binary output.
+ * The values are part of the format and must not be changed.
+ */
+enum BinaryCommand {
+    BINARY_PEN = 1,
+    BINARY_BRUSH,
+    BINARY_FONT,
+    BINARY_ORIGIN,
+    BINARY_START_GRAPHIC,
+    BINARY_RESUME_GRAPHIC,
+    BINARY_END_GRAPHIC,
+    BINARY_ROTATE_GRAPHIC,
+    BINARY_LINE,
+    BINARY_POLYLINE,
+    BINARY_POLYGON,
+    BINARY_RECTANGLE,
+    BINARY_ROUNDED_RECTANGLE,
+    BINARY_CIRCLE,
+    BINARY_ELLIPSE,
+    BINARY_ELLIPTIC_ARC,
+    BINARY_QUAD_BEZIER_PATH,
+    BINARY_CUBIC_BEZIER_PATH,
+    BINARY_CUBIC_BEZIER_PATH_FILLED,
+    BINARY_GLYPH,
+    BINARY_START_TEXT,
+    BINARY_MOVE_TEXT,
+    BINARY_TEXT,
+    BINARY_END_TEXT,
+    BINARY_SVG_SHAPE
+};
+
+//----------------------------------------------------------------------------
+// BinaryDeviceContext
+//----------------------------------------------------------------------------
+
+/**
+ * This class implements a drawing context generating a compact binary stream of drawing commands.
+ * It is meant to be drawn by a client (e.g., into an HTML canvas) without having to parse SVG.
+ * All the values are little-endian 32-bit integers, so the output can be read as an Int32Array:
+ *  - A header of 9 values: the magic number "VRVB", the version of the format, the width and height in pixels, the
+ *    width and height of the content in drawing units, the number of command values, of glyphs, and of strings.
+ *  - The commands, each of them as the command (BinaryCommand), the number of arguments and the arguments.
+ *    Strings are given as indexes in the string table (-1 for none) and real numbers are multiplied by 1000.
+ *  - The glyphs used by BINARY_GLYPH, each of them as the code point and the index of the SVG path in the string
+ *    table. The glyph paths are defined in a 1000 x 1000 box and have to be flipped vertically.
+ *  - The string table, each string as its length in bytes and its UTF-8 bytes padded to a multiple of four.
+ * The pen, the brush and the font are given only when they change. Colours are given as 0xRRGGBB and AxNONE (-1)
+ * stands for the current colour.
+ * The arguments of the commands are:
+ *  - BINARY_PEN: colour, width, dash length, gap length, line cap, line join, opacity
+ *  - BINARY_BRUSH: colour, opacity
+ *  - BINARY_FONT: point size, style, weight, face name
+ *  - BINARY_ORIGIN: x, y
+ *  - BINARY_START_GRAPHIC: id, class, primary, colour (as given in the MEI)
+ *  - BINARY_RESUME_GRAPHIC: id
+ *  - BINARY_ROTATE_GRAPHIC: x, y, angle (applies to the current graphic)
+ *  - BINARY_LINE: x1, y1, x2, y2
+ *  - BINARY_POLYLINE and BINARY_POLYGON: number of points, x and y of each point
+ *  - BINARY_RECTANGLE: x, y, width, height; BINARY_ROUNDED_RECTANGLE: x, y, width, height, radius
+ *  - BINARY_CIRCLE: x, y, radius; BINARY_ELLIPSE: x, y, width, height
+ *  - BINARY_ELLIPTIC_ARC: x, y, width, height, start angle, end angle
+ *  - BINARY_QUAD_BEZIER_PATH, BINARY_CUBIC_BEZIER_PATH and BINARY_CUBIC_BEZIER_PATH_FILLED: x and y of each point
+ *  - BINARY_GLYPH: code point, x, y, point size, width to height ratio
+ *  - BINARY_START_TEXT and BINARY_MOVE_TEXT: x, y, alignment (x is VRV_UNSET when only moving vertically)
+ *  - BINARY_TEXT: text, x, y (VRV_UNSET for none)
+ *  - BINARY_SVG_SHAPE: x, y, width, height, SVG content
+ */
+class BinaryDeviceContext : public DeviceContext {
+public:
+    /**
+     * @name Constructors, destructors, and other standard methods
+     */
+    ///@{
+    BinaryDeviceContext();
+    virtual ~BinaryDeviceContext();
+    ///@}
+
+    /**
+     * @name Setters
+     */
+    ///@{
+    void SetBackground(int colour, int style = AxSOLID) override{};
+    void SetBackgroundImage(void *image, double opacity = 1.0) override{};
+    void SetBackgroundMode(int mode) override{};
+    void SetTextForeground(int colour) override;
+    void SetTextBackground(int colour) override{};
+    void SetLogicalOrigin(int x, int y) override;
+    ///@}
+
+    /**
+     * @name Getters
+     */
+    ///@{
+    Point GetLogicalOrigin() override;
+    ///@}
+
+    /**
+     * Get the binary output.
+     * The glyphs and the strings are appended to the commands.
+     */
+    void GetBinary(std::vector<unsigned char> &output);
+
+    /**
+     * @name Drawing methods
+     */
+    ///@{
+    void DrawQuadBezierPath(Point bezier[3]) override;
+    void DrawCubicBezierPath(Point bezier[4]) override;
+    void DrawCubicBezierPathFilled(Point bezier1[4], Point bezier2[4]) override;
+    void DrawCircle(int x, int y, int radius) override;
+    void DrawEllipse(int x, int y, int width, int height) override;
+    void DrawEllipticArc(int x, int y, int width, int height, double start, double end) override;
+    void DrawLine(int x1, int y1, int x2, int y2) override;
+    void DrawPolyline(int n, Point points[], int xOffset, int yOffset) override;
+    void DrawPolygon(int n, Point points[], int xOffset, int yOffset) override;
+    void DrawRectangle(int x, int y, int width, int height) override;
+    void DrawRotatedText(const std::string &text, int x, int y, double angle) override{};
+    void DrawRoundedRectangle(int x, int y, int width, int height, int radius) override;
+    void DrawText(const std::string &text, const std::wstring &wtext = L"", int x = VRV_UNSET, int y = VRV_UNSET,
+        int width = VRV_UNSET, int height = VRV_UNSET) override;
+    void DrawMusicText(const std::wstring &text, int x, int y, bool setSmuflGlyph = false) override;
+    void DrawSpline(int n, Point points[]) override{};
+    void DrawSvgShape(int x, int y, int width, int height, pugi::xml_node svg) override;
+    void DrawBackgroundImage(int x = 0, int y = 0) override{};
+    ///@}
+
+    /**
+     * @name Method for starting and ending a text
+     */
+    ///@{
+    void StartText(int x, int y, data_HORIZONTALALIGNMENT alignment = HORIZONTALALIGNMENT_left) override;
+    void EndText() override;
+
+    /**
+     * @name Move a text to the specified position, for example when starting a new line.
+     */
+    ///@{
+    void MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignment) override;
+    void MoveTextVerticallyTo(int y) override;
+    ///@}
+
+    /**
+     * @name Method for starting and ending a graphic
+     */
+    ///@{
+    void StartGraphic(
+        Object *object, std::string gClass, std::string gId, bool primary = true, bool prepend = false) override;
+    void EndGraphic(Object *object, View *view) override;
+    ///@}
+
+    /**
+     * @name Method for starting and ending a graphic custom graphic that do not correspond to an Object
+     */
+    ///@{
+    void StartCustomGraphic(std::string name, std::string gClass = "", std::string gId = "") override;
+    void EndCustomGraphic() override;
+    ///@}
+
+    /**
+     * @name Methods for re-starting and ending a graphic for objects drawn in separate steps
+     */
+    ///@{
+    void ResumeGraphic(Object *object, std::string gId) override;
+    void EndResumedGraphic(Object *object, View *view) override;
+    ///@}
+
+    /**
+     * @name Method for rotating a graphic (clockwise).
+     */
+    ///@{
+    void RotateGraphic(Point const &orig, double angle) override;
+    ///@}
+
+    /**
+     * @name Method for starting and ending page
+     */
+    ///@{
+    void StartPage() override;
+    void EndPage() override{};
+    ///@}
+
+    /**
+     * Setting the facsimile flag (false by default)
+     */
+    void SetFacsimile(bool facsimile) { m_facsimileOutput = facsimile; }
+
+private:
+    /**
+     * Add a command with its arguments
+     */
+    void AddCommand(BinaryCommand command, std::initializer_list<int> values);
+
+    /**
+     * Add a command with the points as arguments, preceded by their number if variable
+     */
+    void AddPointsCommand(BinaryCommand command, int n, const Point points[], bool addCount, int xOffset = 0,
+        int yOffset = 0);
+
+    /**
+     * Add the pen, brush and font commands when they changed since the last primitive
+     */
+    void UpdateState();
+
+    /**
+     * Return the index of the string in the string table, adding it if necessary (-1 for an empty string)
+     */
+    int GetStringIndex(const std::string &str);
+
+    /**
+     * Append a 32-bit value to the output
+     */
+    static void AppendValue(std::vector<unsigned char> &output, int value);
+
+public:
+    //
+private:
+    /** The command values */
+    std::vector<int> m_commands;
+
+    /** The string table and the index of each string */
+    std::vector<std::string> m_strings;
+    std::map<std::string, int> m_stringIndexes;
+
+    /** The glyphs used so far, ordered by code point */
+    std::map<wchar_t, const Glyph *> m_glyphs;
+
+    /**
+     * @name The last pen, brush and font added
+     */
+    ///@{
+    Pen m_currentPen;
+    Brush m_currentBrush;
+    FontInfo m_currentFont;
+    bool m_hasPen;
+    bool m_hasBrush;
+    bool m_hasFont;
+    ///@}
+
+    int m_originX, m_originY;
+
+    /** Output the size of the facsimile */
+    bool m_facsimileOutput;
+};
+
+} // namespace vrv
+
+#endif // __VRV_BINARY_DC_H__
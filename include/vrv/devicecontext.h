@@ -55,6 +55,9 @@ static inline double RadToDeg(double deg)
  */
 
 class DeviceContext {
+    // The display list pushes the recorded pen, brush and font directly onto the stacks when replaying
+    friend class DisplayListDeviceContext;
+
 public:
     /**
      * @name Constructors, destructors, and other standard methods
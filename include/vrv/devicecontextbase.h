@@ -100,6 +100,14 @@ public:
     float GetOpacity() const { return m_penOpacity; }
     void SetOpacity(float opacity) { m_penOpacity = opacity; }
 
+    bool operator==(const Pen &pen) const
+    {
+        return (m_penColour == pen.m_penColour) && (m_penWidth == pen.m_penWidth)
+            && (m_dashLength == pen.m_dashLength) && (m_gapLength == pen.m_gapLength) && (m_lineCap == pen.m_lineCap)
+            && (m_lineJoin == pen.m_lineJoin) && (m_penOpacity == pen.m_penOpacity);
+    }
+    bool operator!=(const Pen &pen) const { return !(*this == pen); }
+
 private:
     int m_penColour, m_penWidth, m_dashLength, m_gapLength, m_lineCap, m_lineJoin;
     float m_penOpacity;
@@ -115,6 +123,12 @@ public:
     float GetOpacity() const { return m_brushOpacity; }
     void SetOpacity(float opacity) { m_brushOpacity = opacity; }
 
+    bool operator==(const Brush &brush) const
+    {
+        return (m_brushColour == brush.m_brushColour) && (m_brushOpacity == brush.m_brushOpacity);
+    }
+    bool operator!=(const Brush &brush) const { return !(*this == brush); }
+
 private:
     int m_brushColour;
     float m_brushOpacity;
@@ -165,6 +179,15 @@ public:
     void SetEncoding(int encoding) { m_encoding = encoding; }
     void SetWidthToHeightRatio(float ratio) { m_widthToHeightRatio = ratio; }
 
+    bool operator==(const FontInfo &font) const
+    {
+        return (m_pointSize == font.m_pointSize) && (m_family == font.m_family) && (m_style == font.m_style)
+            && (m_weight == font.m_weight) && (m_underlined == font.m_underlined)
+            && (m_supSubScript == font.m_supSubScript) && (m_faceName == font.m_faceName)
+            && (m_encoding == font.m_encoding) && (m_widthToHeightRatio == font.m_widthToHeightRatio);
+    }
+    bool operator!=(const FontInfo &font) const { return !(*this == font); }
+
 private:
     int m_pointSize;
     int m_family;
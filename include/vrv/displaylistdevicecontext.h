@@ -0,0 +1,326 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        displaylistdevicecontext.h
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRV_DISPLAYLIST_DC_H__
+#define __VRV_DISPLAYLIST_DC_H__
+
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+#include "devicecontext.h"
+
+namespace vrv {
+
+class Object;
+class View;
+
+//----------------------------------------------------------------------------
+// DisplayListDeviceContext
+//----------------------------------------------------------------------------
+
+/**
+ * This class records the drawing primitives of a page instead of drawing them.
+ * The recorded primitives can then be replayed to another device context as many times as needed without
+ * going through the View again, for example for rendering a page again with different output options.
+ * Every primitive is stored with the pen, the brush and the font at the time it was drawn. These are pushed onto
+ * the stacks of the target device context when replaying.
+ * The display list keeps pointers to the objects and to the view that were drawn. It is not valid anymore once
+ * the content or the layout of the document changes.
+ * It is meant to be replayed to SvgDeviceContext or BinaryDeviceContext. BBoxDeviceContext cannot be a target
+ * because the deactivation of graphics is not recorded.
+ */
+class DisplayListDeviceContext : public DeviceContext {
+public:
+    /**
+     * @name Constructors, destructors, and other standard methods
+     * The global styling flag has to be the one of the target device context because the View draws differently
+     * depending on it.
+     */
+    ///@{
+    DisplayListDeviceContext(bool useGlobalStyling);
+    virtual ~DisplayListDeviceContext();
+    ///@}
+
+    /**
+     * @name Setters
+     */
+    ///@{
+    void SetBackground(int colour, int style = AxSOLID) override;
+    void SetBackgroundImage(void *image, double opacity = 1.0) override;
+    void SetBackgroundMode(int mode) override;
+    void SetTextForeground(int colour) override;
+    void SetTextBackground(int colour) override;
+    void SetLogicalOrigin(int x, int y) override;
+    ///@}
+
+    /**
+     * @name Getters
+     */
+    ///@{
+    Point GetLogicalOrigin() override;
+    ///@}
+
+    /**
+     * @name Drawing methods
+     */
+    ///@{
+    void DrawQuadBezierPath(Point bezier[3]) override;
+    void DrawCubicBezierPath(Point bezier[4]) override;
+    void DrawCubicBezierPathFilled(Point bezier1[4], Point bezier2[4]) override;
+    void DrawCircle(int x, int y, int radius) override;
+    void DrawEllipse(int x, int y, int width, int height) override;
+    void DrawEllipticArc(int x, int y, int width, int height, double start, double end) override;
+    void DrawLine(int x1, int y1, int x2, int y2) override;
+    void DrawPolyline(int n, Point points[], int xOffset, int yOffset) override;
+    void DrawPolygon(int n, Point points[], int xOffset, int yOffset) override;
+    void DrawRectangle(int x, int y, int width, int height) override;
+    void DrawRotatedText(const std::string &text, int x, int y, double angle) override;
+    void DrawRoundedRectangle(int x, int y, int width, int height, int radius) override;
+    void DrawText(const std::string &text, const std::wstring &wtext = L"", int x = VRV_UNSET, int y = VRV_UNSET,
+        int width = VRV_UNSET, int height = VRV_UNSET) override;
+    void DrawMusicText(const std::wstring &text, int x, int y, bool setSmuflGlyph = false) override;
+    void DrawSpline(int n, Point points[]) override;
+    void DrawSvgShape(int x, int y, int width, int height, pugi::xml_node svg) override;
+    void DrawBackgroundImage(int x = 0, int y = 0) override;
+    ///@}
+
+    /**
+     * Special method for forcing bounding boxes to be updated
+     */
+    void DrawPlaceholder(int x, int y) override;
+
+    /**
+     * @name Method for starting and ending a text
+     */
+    ///@{
+    void StartText(int x, int y, data_HORIZONTALALIGNMENT alignment = HORIZONTALALIGNMENT_left) override;
+    void EndText() override;
+
+    /**
+     * @name Move a text to the specified position, for example when starting a new line.
+     */
+    ///@{
+    void MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignment) override;
+    void MoveTextVerticallyTo(int y) override;
+    ///@}
+
+    /**
+     * @name Method for starting and ending a graphic
+     */
+    ///@{
+    void StartGraphic(
+        Object *object, std::string gClass, std::string gId, bool primary = true, bool prepend = false) override;
+    void EndGraphic(Object *object, View *view) override;
+    ///@}
+
+    /**
+     * @name Method for starting and ending a graphic custom graphic that do not correspond to an Object
+     */
+    ///@{
+    void StartCustomGraphic(std::string name, std::string gClass = "", std::string gId = "") override;
+    void EndCustomGraphic() override;
+    ///@}
+
+    /**
+     * @name Methods for re-starting and ending a graphic for objects drawn in separate steps
+     */
+    ///@{
+    void ResumeGraphic(Object *object, std::string gId) override;
+    void EndResumedGraphic(Object *object, View *view) override;
+    ///@}
+
+    /**
+     * @name Method for starting and ending a text graphic
+     */
+    ///@{
+    void StartTextGraphic(Object *object, std::string gClass, std::string gId) override;
+    void EndTextGraphic(Object *object, View *view) override;
+    ///@}
+
+    /**
+     * @name Method for rotating a graphic (clockwise).
+     */
+    ///@{
+    void RotateGraphic(Point const &orig, double angle) override;
+    ///@}
+
+    /**
+     * @name Method for starting and ending page
+     */
+    ///@{
+    void StartPage() override;
+    void EndPage() override;
+    ///@}
+
+    /**
+     * @name Method for adding description element
+     */
+    ///@{
+    void AddDescription(const std::string &text) override;
+    ///@}
+
+    /**
+     * Return the global styling flag given in the constructor
+     */
+    bool UseGlobalStyling() override { return m_useGlobalStyling; }
+
+    /**
+     * Replay all the recorded primitives to the target device context.
+     * The target has to use the same global styling as the display list.
+     * Its size and scale are not changed and have to be set beforehand.
+     */
+    void Replay(DeviceContext *target) const;
+
+private:
+    /**
+     * The recorded primitives
+     */
+    enum Command {
+        DL_SET_BACKGROUND = 0,
+        DL_SET_BACKGROUND_IMAGE,
+        DL_SET_BACKGROUND_MODE,
+        DL_SET_TEXT_FOREGROUND,
+        DL_SET_TEXT_BACKGROUND,
+        DL_SET_LOGICAL_ORIGIN,
+        DL_DRAW_QUAD_BEZIER_PATH,
+        DL_DRAW_CUBIC_BEZIER_PATH,
+        DL_DRAW_CUBIC_BEZIER_PATH_FILLED,
+        DL_DRAW_CIRCLE,
+        DL_DRAW_ELLIPSE,
+        DL_DRAW_ELLIPTIC_ARC,
+        DL_DRAW_LINE,
+        DL_DRAW_POLYLINE,
+        DL_DRAW_POLYGON,
+        DL_DRAW_RECTANGLE,
+        DL_DRAW_ROTATED_TEXT,
+        DL_DRAW_ROUNDED_RECTANGLE,
+        DL_DRAW_TEXT,
+        DL_DRAW_MUSIC_TEXT,
+        DL_DRAW_SPLINE,
+        DL_DRAW_SVG_SHAPE,
+        DL_DRAW_BACKGROUND_IMAGE,
+        DL_DRAW_PLACEHOLDER,
+        DL_START_TEXT,
+        DL_END_TEXT,
+        DL_MOVE_TEXT_TO,
+        DL_MOVE_TEXT_VERTICALLY_TO,
+        DL_START_GRAPHIC,
+        DL_END_GRAPHIC,
+        DL_START_CUSTOM_GRAPHIC,
+        DL_END_CUSTOM_GRAPHIC,
+        DL_RESUME_GRAPHIC,
+        DL_END_RESUMED_GRAPHIC,
+        DL_START_TEXT_GRAPHIC,
+        DL_END_TEXT_GRAPHIC,
+        DL_ROTATE_GRAPHIC,
+        DL_START_PAGE,
+        DL_END_PAGE,
+        DL_ADD_DESCRIPTION
+    };
+
+    /**
+     * A recorded primitive with the index of the pen, brush and font to use (-1 for none).
+     * The arguments are stored in the value buffers in the order of the calls.
+     */
+    struct Item {
+        Command m_command;
+        int m_pen;
+        int m_brush;
+        int m_font;
+    };
+
+    /**
+     * The position in the value buffers when replaying, with a buffer for the points
+     */
+    struct ReplayPosition {
+        std::vector<Point> m_points;
+        int m_int = 0;
+        int m_double = 0;
+        int m_string = 0;
+        int m_wstring = 0;
+        int m_object = 0;
+        int m_view = 0;
+        int m_image = 0;
+        int m_svgNode = 0;
+    };
+
+    /**
+     * Add a primitive with the current pen, brush and font.
+     * These are added to the tables only when different from the previous ones.
+     */
+    void AddCommand(Command command);
+
+    /**
+     * @name Add arguments to the value buffers
+     */
+    ///@{
+    void AddPoints(int n, const Point points[]);
+    ///@}
+
+    /**
+     * @name Read arguments from the value buffers when replaying
+     */
+    ///@{
+    int ReadInt(ReplayPosition &position) const { return m_ints.at(position.m_int++); }
+    double ReadDouble(ReplayPosition &position) const { return m_doubles.at(position.m_double++); }
+    const std::string &ReadString(ReplayPosition &position) const { return m_strings.at(position.m_string++); }
+    const std::wstring &ReadWString(ReplayPosition &position) const { return m_wstrings.at(position.m_wstring++); }
+    Point *ReadPoints(ReplayPosition &position, int n) const;
+    Object *ReadObject(ReplayPosition &position) const { return m_objects.at(position.m_object++); }
+    View *ReadView(ReplayPosition &position) const { return m_views.at(position.m_view++); }
+    void *ReadImage(ReplayPosition &position) const { return m_images.at(position.m_image++); }
+    pugi::xml_node ReadSvgNode(ReplayPosition &position) const { return m_svgNodes.at(position.m_svgNode++); }
+    ///@}
+
+    /**
+     * Replay a single primitive
+     */
+    void ReplayCommand(Command command, DeviceContext *target, ReplayPosition &position) const;
+
+public:
+    //
+private:
+    /** The global styling flag of the target device context */
+    bool m_useGlobalStyling;
+
+    /** The logical origin as set by the View */
+    int m_originX, m_originY;
+
+    /** The recorded primitives */
+    std::vector<Item> m_commands;
+
+    /**
+     * @name The value buffers
+     */
+    ///@{
+    std::vector<int> m_ints;
+    std::vector<double> m_doubles;
+    std::vector<std::string> m_strings;
+    std::vector<std::wstring> m_wstrings;
+    std::vector<Object *> m_objects;
+    std::vector<View *> m_views;
+    std::vector<void *> m_images;
+    std::vector<pugi::xml_node> m_svgNodes;
+    ///@}
+
+    /**
+     * @name The pens, brushes and fonts used by the primitives
+     * They are copied because the font pointers on the stack are not owned by the device context.
+     * The fonts are mutable because DeviceContext::SetFont takes a non-const pointer.
+     */
+    ///@{
+    std::vector<Pen> m_pens;
+    std::vector<Brush> m_brushes;
+    mutable std::vector<FontInfo> m_fonts;
+    ///@}
+};
+
+} // namespace vrv
+
+#endif // __VRV_DISPLAYLIST_DC_H__
@@ -21,17 +21,124 @@ class MidiFile;
 
 namespace vrv {
 
+class CastOffEncodingParams;
 class CastOffPagesParams;
 class DocSelection;
 class FontInfo;
 class Glyph;
+class Measure;
+class Note;
 class Pages;
 class Page;
 class Score;
 class MidiExt;
+class MidiStream;
+
+struct MIDIChunk;
+struct MIDIStaffExport;
 
 enum DocType { Raw = 0, Rendering, Transcription, Facs };
 
+//----------------------------------------------------------------------------
+// CastOffLayout
+//----------------------------------------------------------------------------
+
+/**
+ * This class stores the cast off of a document (system and page breaks) for a set of layout options.
+ * Breaks are stored as the first object of the system or the page they start.
+ * Object pointers are valid as long as the content of the document is not changed.
+ */
+class CastOffLayout {
+public:
+    std::set<const Object *> m_systemBreaks;
+    std::set<const Object *> m_pageBreaks;
+    /** The cast off total and justifiable widths for each system */
+    std::vector<std::pair<int, int>> m_systemWidths;
+};
+
+//----------------------------------------------------------------------------
+// TimemapIndex
+//----------------------------------------------------------------------------
+
+/**
+ * This class stores an index of the timemap for looking up the elements played at a given time.
+ * The measures are sorted by real time onset across repeats, with the maximum offset so far for a binary search.
+ * The notes and rests of each measure are sorted by onset, which limits the search to the ones with an onset
+ * within the longest duration before the time looked for. Their times are scaled by the real time factor of the
+ * measure entry when a repeat is played with another tempo than the first one.
+ * The times of the notes, rests and chords are also stored in score order for each measure, with an index by ID for
+ * looking them up without going through the measure. They are relative to the measure, so only the measures updated
+ * need to be recalculated, and the absolute times of a pass are given by Doc::GetElementTimes. The times of a chord go
+ * from the onset of its first note to the offset of its last one.
+ * Object pointers are valid as long as the content of the document is not changed.
+ */
+class TimemapIndex {
+public:
+    struct MeasureEntry {
+        double m_onset;
+        double m_offset;
+        double m_maxOffset;
+        Measure *m_measure;
+        int m_repeat;
+        int m_notesOrRestsIdx;
+        double m_realTimeFactor;
+    };
+    struct NoteOrRestEntry {
+        double m_onset;
+        double m_offset;
+        int m_order;
+        Object *m_object;
+    };
+    struct MeasureNotesOrRests {
+        std::vector<NoteOrRestEntry> m_entries;
+        double m_maxDuration;
+    };
+    struct ElementEntry {
+        Object *m_object;
+        Measure *m_measure;
+        double m_onset;
+        double m_offset;
+        std::string m_id;
+    };
+    struct ElementTimes {
+        double m_onset;
+        double m_offset;
+    };
+
+    std::vector<MeasureEntry> m_measures;
+    std::vector<MeasureNotesOrRests> m_notesOrRests;
+
+    /**
+     * @name The notes, rests and chords of each measure and their index by ID (measure and element indexes)
+     */
+    ///@{
+    std::vector<std::vector<ElementEntry>> m_elements;
+    std::unordered_map<std::string, std::pair<int, int>> m_elementIndexes;
+    ///@}
+};
+
+//----------------------------------------------------------------------------
+// TimemapState
+//----------------------------------------------------------------------------
+
+/**
+ * This class stores the measures of the timemap in score order with the real time and the tempo (without
+ * adjustment) at their start. This makes it possible to recalculate the timemap from a measure onward, with the
+ * offsets of the following measures updated as a prefix sum of their durations.
+ * The edited measures are the ones for which the content needs to be recalculated.
+ */
+class TimemapState {
+public:
+    struct MeasureState {
+        Measure *m_measure;
+        double m_realTimeSeconds;
+        double m_tempo;
+    };
+
+    std::vector<MeasureState> m_measures;
+    std::set<const Measure *> m_editedMeasures;
+};
+
 //----------------------------------------------------------------------------
 // Doc
 //----------------------------------------------------------------------------
@@ -231,11 +338,75 @@ public:
      */
     bool HasTimemap() const;
 
+    /**
+     * Reset the timemap and its index.
+     * This needs to be called when the content of the document is changed.
+     */
+    void ResetTimemap();
+
+    /**
+     * Mark the content of a measure as changed in the timemap.
+     * The next calculation of the timemap recalculates only the edited measures and the following ones for which the
+     * tempo changed. ResetTimemap needs to be called instead when measures are added or removed.
+     */
+    void InvalidateTimemap(const Measure *measure);
+
+    /**
+     * Return the timemap index, which is empty until the timemap is calculated
+     */
+    const TimemapIndex &GetTimemapIndex() const { return m_timemapIndex; }
+
+    /**
+     * @name Methods for looking up the elements played at a given time (in milliseconds) with the timemap index.
+     * The timemap needs to be calculated before.
+     * FindMeasureAtTime returns the index entry of the measure (with its repeat) played, or NULL.
+     * FindMeasuresInTimeRange fills the index entries of the measures played in the range, in time order.
+     * FindNotesOrRestsAtTime and FindNotesOrRestsInTimeRange fill the notes and rests of a measure entry played at
+     * the time or in the range, in document order. The times of the note or rest entries are relative to the measure.
+     */
+    ///@{
+    const TimemapIndex::MeasureEntry *FindMeasureAtTime(int millisec) const;
+    void FindMeasuresInTimeRange(
+        int startMillisec, int endMillisec, std::vector<const TimemapIndex::MeasureEntry *> &measures) const;
+    void FindNotesOrRestsAtTime(
+        const TimemapIndex::MeasureEntry *measureEntry, int millisec, ListOfObjects &notesOrRests) const;
+    void FindNotesOrRestsInTimeRange(const TimemapIndex::MeasureEntry *measureEntry, int startMillisec,
+        int endMillisec, std::vector<const TimemapIndex::NoteOrRestEntry *> &notesOrRests) const;
+    ///@}
+
+    /**
+     * Return the index entry of the note, rest or chord with the ID, or NULL.
+     * The timemap needs to be calculated before.
+     */
+    const TimemapIndex::ElementEntry *FindElementTimes(const std::string &id) const;
+
+    /**
+     * Return the absolute real times of an element of the timemap index for a pass (1-based) of its measure.
+     * The number of passes is the repeat count of the measure.
+     */
+    TimemapIndex::ElementTimes GetElementTimes(const TimemapIndex::ElementEntry *element, int repeat) const;
+
     /**
      * Export the document to a MIDI file.
      * Run trough all the layers and fill the midi file content.
+     * When a chunk is given, only its measures are exported (see ExportMIDIChunk).
+     * When a stream is given, it is filled with the events of the MIDI file and the elements generating them.
      */
-    void ExportMIDI(smf::MidiFile *midiFile, MidiExt *midiExt = nullptr);
+    void ExportMIDI(smf::MidiFile *midiFile, MidiExt *midiExt = nullptr, const MIDIChunk *chunk = NULL,
+        MidiStream *midiStream = NULL);
+
+    /**
+     * Export a chunk of the document to a MIDI file, from a pass of the first measure to a pass of the last one
+     * (included). The passes are 1-based, and 0 selects the first pass of the first measure and the first pass of the
+     * last measure not before it.
+     * The events are given in ticks from the start of the first measure and follow the timemap, without repeats, so
+     * the chunks of consecutive measure passes give the same events as the whole timemap.
+     * The tempo, the transposition and the tuning in effect at the start of the chunk are set, and the notes tied
+     * from before the chunk are started at their continuation, unless the chunk continues a previous one.
+     * Return false if the measures are not played in the timemap or not in order.
+     */
+    bool ExportMIDIChunk(smf::MidiFile *midiFile, Measure *firstMeasure, int firstRepeat, Measure *lastMeasure,
+        int lastRepeat, bool continued);
 
     /**
      * Extract a timemap from the document to a JSON string.
@@ -320,6 +491,20 @@ public:
      */
     void CastOffEncodingDoc();
 
+    /**
+     * @name Methods for the cast off cache.
+     * The cast off is cached for the values of the layout options (see Options::GetLayoutKey).
+     * The cache keeps the most recently used cast offs and needs to be reset when the content changes.
+     * CastOffFromCacheDoc returns false when nothing was cached for the current options.
+     * CastOffCachedBreak is called from the Object::CastOffEncoding functor for each object moved.
+     */
+    ///@{
+    bool CastOffFromCacheDoc();
+    void CacheCastOffDoc();
+    void ResetCastOffCache() { m_castOffCache.clear(); }
+    void CastOffCachedBreak(const Object *object, CastOffEncodingParams *params);
+    ///@}
+
     /**
      * Convert the doc from score-based to page-based MEI.
      * Containers will be converted to systemMilestone / systemMilestoneEnd.
@@ -431,6 +616,13 @@ public:
      */
     bool IsCastOff() const { return m_isCastOff; }
 
+    /**
+     * Return the layout generation, incremented whenever the pages, the systems or the drawing scoreDefs are rebuilt.
+     * Anything pointing to the layout objects, such as the display lists of the Toolkit, is only valid for the
+     * generation in which it was built.
+     */
+    int GetLayoutGeneration() const { return m_layoutGeneration; }
+
     /**
      * @name Methods for managing a selection.
      */
@@ -467,6 +659,40 @@ private:
      */
     int CalcMusicFontSize();
 
+    /**
+     * Recalculate the timemap for the edited measures and the ones with a tempo changed.
+     * Return false if an edited measure is not in the timemap anymore and a full calculation is needed.
+     */
+    bool UpdateTimemap();
+
+    /**
+     * Build the timemap index from the real time values set by Doc::CalculateTimemap.
+     * The notes and rests are looked for only in the measures updated.
+     */
+    void CalculateTimemapIndex(const std::vector<bool> &updatedMeasures);
+
+    /**
+     * Fill the times of the notes, rests and chords of the updated measures in the timemap index.
+     * Called by Doc::CalculateTimemapIndex.
+     */
+    void CalculateTimemapElements(const std::vector<bool> &updatedMeasures);
+
+    /**
+     * Process the measures of the expanded timeline in its order, each one with the scoreDefs preceding it in its
+     * parent, so the changes they make are seen when jumping to it. The pass of each measure is set to repeat before
+     * processing it.
+     */
+    void ProcessTimeline(
+        Functor *functor, FunctorParams *functorParams, Functor *endFunctor, Filters *filters, int &repeat);
+
+    /**
+     * Export the layers of a staff to a MIDI file, which can be done concurrently for all the staves.
+     * Called by Doc::ExportMIDI.
+     */
+    void ExportStaffMIDI(smf::MidiFile *midiFile, const MIDIStaffExport &staffExport,
+        const std::map<Note *, double> &deferredNotes, double tempo, MidiExt *midiExt, MidiStream *midiStream,
+        const MIDIChunk *chunk);
+
 public:
     Page *m_selectionPreceeding;
     Page *m_selectionFollowing;
@@ -550,6 +776,11 @@ private:
      */
     bool m_isCastOff;
 
+    /**
+     * The cached cast offs with the key of their layout options, the most recently used first
+     */
+    std::list<std::pair<std::string, CastOffLayout>> m_castOffCache;
+
     /*
      * The following values are set in the Doc::SetDrawingPage.
      * They are all current values to be used when drawing a page in a View and
@@ -594,6 +825,11 @@ private:
      */
     bool m_dataPreparationDone;
 
+    /**
+     * The layout generation, never reset since it is compared with the one of the content built earlier
+     */
+    int m_layoutGeneration;
+
     /**
      * A flag to indicate that the timemap has been calculated.  The
      * timemap needs to be prepared before MIDI files or timemap JSON files
@@ -601,6 +837,16 @@ private:
      */
     double m_timemapTempo;
 
+    /**
+     * The index of the timemap built by Doc::CalculateTimemap
+     */
+    TimemapIndex m_timemapIndex;
+
+    /**
+     * The state of the measures for recalculating the timemap after an edit or a tempo change
+     */
+    TimemapState m_timemapState;
+
     /**
      * A flag to indicate whereas the document contains analytical markup to be converted.
      * This is currently limited to @fermata and @tie. Other attribute markup (@accid and @artic)
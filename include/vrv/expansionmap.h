@@ -16,6 +16,8 @@
 
 namespace vrv {
 
+class Measure;
+
 class ExpansionMap {
 
 public:
@@ -43,9 +45,25 @@ public:
      */
     void Expand(const xsdAnyURI_List &expansionList, xsdAnyURI_List &existingList, Object *prevSection);
 
+    /**
+     * Expand expansion recursively into a timeline of the notated measures, without cloning them.
+     * Each measure is added with the pass number at which it is played.
+     */
+    void ExpandTimeline(const xsdAnyURI_List &expansionList, Object *expansion);
+
     std::vector<std::string> GetExpansionIDsForElement(const std::string &xmlId);
 
+    /**
+     * @name Getters for the expanded timeline
+     */
+    ///@{
+    bool HasTimeline() const { return !m_timeline.empty(); }
+    const std::vector<std::pair<Measure *, int>> &GetTimeline() const { return m_timeline; }
+    ///@}
+
 private:
+    void ExpandTimeline(const xsdAnyURI_List &expansionList, Object *expansion, std::map<Measure *, int> &passes);
+
     bool UpdateIDs(Object *object);
 
     void GetIDList(Object *object, std::vector<std::string> &idList);
@@ -60,6 +78,8 @@ public:
     std::map<std::string, std::vector<std::string>> m_map;
 
 private:
+    /** The measures in playback order with their pass number, when expanding the timeline only */
+    std::vector<std::pair<Measure *, int>> m_timeline;
 };
 
 } // namespace vrv
@@ -13,10 +13,6 @@
 #include "functorparams.h"
 #include "options.h"
 
-//----------------------------------------------------------------------------
-
-#include "jsonxx.h"
-
 namespace vrv {
 
 class FeatureExtractor {
@@ -55,13 +51,13 @@ public:
      */
     std::list<Note *> m_previousNotes;
 
-    jsonxx::Array m_pitchesChromatic;
-    jsonxx::Array m_pitchesDiatonic;
-    jsonxx::Array m_pitchesIds;
+    std::vector<std::string> m_pitchesChromatic;
+    std::vector<std::string> m_pitchesDiatonic;
+    std::vector<std::vector<std::string>> m_pitchesIds;
 
-    jsonxx::Array m_intervalsChromatic;
-    jsonxx::Array m_intervalsDiatonic;
-    jsonxx::Array m_intervalsIds;
+    std::vector<std::string> m_intervalsChromatic;
+    std::vector<std::string> m_intervalsDiatonic;
+    std::vector<std::vector<std::string>> m_intervalsIds;
 
 private:
 };
@@ -35,6 +35,7 @@ class FeatureExtractor;
 class Functor;
 class Hairpin;
 class Harm;
+class InstrDef;
 class KeySig;
 class LabelAbbr;
 class Layer;
@@ -51,6 +52,7 @@ class Pedal;
 class ScoreDef;
 class ScoreDefElement;
 class Slur;
+class SpannedElementIndex;
 class Staff;
 class StaffAlignment;
 class StaffDef;
@@ -1161,6 +1163,7 @@ public:
  * member 2: a pointer to the current system
  * member 3: a pointer to the system we are taking the content from
  * member 4: a flag if we want to use the pageBreaks from the document
+ * member 5: a pointer to the cached cast off to use instead of the encoded breaks (if any)
  **/
 
 class CastOffEncodingParams : public FunctorParams {
@@ -1172,12 +1175,14 @@ public:
         m_currentSystem = NULL;
         m_contentSystem = NULL;
         m_usePages = usePages;
+        m_castOffLayout = NULL;
     }
     Doc *m_doc;
     Page *m_currentPage;
     System *m_contentSystem;
     System *m_currentSystem;
     bool m_usePages;
+    const CastOffLayout *m_castOffLayout;
 };
 
 //----------------------------------------------------------------------------
@@ -1684,6 +1689,20 @@ public:
     std::vector<ClassId> m_classIds;
 };
 
+//----------------------------------------------------------------------------
+// InitSpannedElementIndexParams
+//----------------------------------------------------------------------------
+
+/**
+ * member 0: a pointer to the index to fill
+ **/
+
+class InitSpannedElementIndexParams : public FunctorParams {
+public:
+    InitSpannedElementIndexParams(SpannedElementIndex *index) { m_index = index; }
+    SpannedElementIndex *m_index;
+};
+
 //----------------------------------------------------------------------------
 // FindLayerIDWithinStaffDefParams
 //----------------------------------------------------------------------------
@@ -1757,6 +1776,36 @@ struct MIDIChord {
 
 using MIDIChordSequence = std::list<MIDIChord>;
 
+/**
+ * Helper struct for exporting a chunk of measures to MIDI.
+ * The start and end times are the score times of the start of the first measure and of the end of the last one,
+ * and the tempo is the one of the first measure.
+ * The tied-in notes are the secondary tied notes of the chunk with the first note of the tie before it, with the
+ * score time at which they stop from the start of their measure.
+ */
+struct MIDIChunk {
+    double m_startTime = 0.0;
+    double m_endTime = 0.0;
+    double m_tempo = MIDI_TEMPO;
+    std::map<Note *, double> m_tiedInNotes;
+};
+
+/**
+ * Helper struct for exporting the layers of a staff to MIDI.
+ * The staves are exported separately, each in a MIDI file of its own, and the events are merged in staff order.
+ * The layer index is the one of the first layer of the staff.
+ */
+struct MIDIStaffExport {
+    int m_staffN = 0;
+    std::vector<int> m_layerNs;
+    int m_layerIndex = 0;
+    StaffDef *m_staffDef = NULL;
+    InstrDef *m_instrDef = NULL;
+    int m_midiTrack = 1;
+    int m_midiChannel = 0;
+    int m_transSemi = 0;
+};
+
 /**
  * member 0: MidiFile*: the MidiFile we are writing to
  * member 1: int: the midi track number
@@ -1773,6 +1822,8 @@ using MIDIChordSequence = std::list<MIDIChord>;
  * member 12: flag indicating whether cue notes should be included
  * member 13: the functor
  * member 14: Tablature held notes indexed by (course - 1)
+ * member 15: the pass of the measure in an expanded timeline (0 for the last offset)
+ * member 16: the MidiStream for the element handles of the note events (NULL if no stream is generated)
  **/
 
 class GenerateMIDIParams : public FunctorParams {
@@ -1800,6 +1851,9 @@ public:
         m_repeatAdditionalDuration = 0;
         m_layerIndex = 0;
         m_midiExt = nullptr;
+        m_chunk = NULL;
+        m_repeat = 0;
+        m_midiStream = NULL;
     }
     smf::MidiFile *m_midiFile;
     int m_midiTrack;
@@ -1827,6 +1881,9 @@ public:
     double m_repeatAdditionalDuration;
     int m_layerIndex;
     MidiExt *m_midiExt;
+    const MIDIChunk *m_chunk;
+    int m_repeat;
+    MidiStream *m_midiStream;
 };
 
 //----------------------------------------------------------------------------
@@ -1840,6 +1897,8 @@ public:
  * member 3: flag indicating whether cue notes should be included
  * member 4: a pointer to the Timemap
  * member 5: the functor for redirection
+ * member 6: the pass of the measure in an expanded timeline (0 for the last offset)
+ * member 7: the factor for the real times of the notes with the tempo of the pass
  **/
 
 class GenerateTimemapParams : public FunctorParams {
@@ -1853,6 +1912,8 @@ public:
         m_cueExclusion = false;
         m_timemap = timemap;
         m_functor = functor;
+        m_repeat = 0;
+        m_realTimeFactor = 1.0;
     }
     double m_scoreTimeOffset;
     double m_realTimeOffsetMilliseconds;
@@ -1861,6 +1922,8 @@ public:
     bool m_cueExclusion;
     Timemap *m_timemap;
     Functor *m_functor;
+    int m_repeat;
+    double m_realTimeFactor;
 };
 
 //----------------------------------------------------------------------------
@@ -1922,6 +1985,8 @@ public:
  * member 2: the current tempo
  * member 3: the tempo adjustment
  * member 4: factor for multibar rests
+ * member 5: the timemap state to which the measures are added
+ * member 6: the pass of the measure in an expanded timeline (0 without one)
  **/
 
 class InitMaxMeasureDurationParams : public FunctorParams {
@@ -1933,12 +1998,16 @@ public:
         m_currentTempo = MIDI_TEMPO;
         m_tempoAdjustment = 1.0;
         m_multiRestFactor = 1;
+        m_timemapState = NULL;
+        m_repeat = 0;
     }
     double m_currentScoreTime;
     double m_currentRealTimeSeconds;
     double m_currentTempo;
     double m_tempoAdjustment;
     int m_multiRestFactor;
+    TimemapState *m_timemapState;
+    int m_repeat;
 };
 
 //----------------------------------------------------------------------------
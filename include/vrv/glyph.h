@@ -67,7 +67,7 @@ public:
     ///@}
 
     /**
-     * @name Setter and getter for the path
+     * @name Setter and getter for the path (relative to the resource directory)
      */
     ///@{
     std::string GetPath() const { return m_path; }
@@ -114,7 +114,7 @@ private:
     int m_unitsPerEm;
     /** The Unicode code in hexa as string */
     std::string m_codeStr;
-    /** Path to the glyph XML file */
+    /** Path to the glyph XML file relative to the resource directory */
     std::string m_path;
     /** A map of the available anchors */
     std::map<SMuFLGlyphAnchor, Point> m_anchors;
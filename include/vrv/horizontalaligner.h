@@ -431,6 +431,7 @@ protected:
     /**
      * Search if an alignment of the type is already there at the time.
      * If not, return in idx the position where it needs to be inserted (-1 if it is the end)
+     * The alignments being ordered by time and type, this is a binary search.
      */
     ///@{
     Alignment *SearchAlignmentAtTime(double time, AlignmentType type, int &idx);
@@ -565,7 +566,11 @@ public:
     int JustifyX(FunctorParams *functorParams) override;
 
 private:
-    //
+    /**
+     * Return the index position of the right barline alignment (-1 if not found)
+     */
+    int GetRightBarLineAlignmentIdx() const;
+
 public:
     //
 private:
@@ -0,0 +1,92 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        jsonwriter.h
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRV_JSON_WRITER_H__
+#define __VRV_JSON_WRITER_H__
+
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+namespace vrv {
+
+//----------------------------------------------------------------------------
+// JsonWriter
+//----------------------------------------------------------------------------
+
+/**
+ * This class writes JSON directly to a string, without building a tree of values first.
+ * The output is formatted as the one of jsonxx (tab indentation and numbers with the precision of long double), which
+ * writes the keys of an object in alphabetical order. Keys are written in the order given, so they need to be given
+ * in alphabetical order for the output to be the same.
+ * Keys are required within an object and must be empty within an array.
+ */
+class JsonWriter {
+public:
+    /**
+     * @name Constructors, destructors, and other standard methods
+     * The output is appended to the string given.
+     */
+    ///@{
+    JsonWriter(std::string &output);
+    virtual ~JsonWriter();
+    ///@}
+
+    /**
+     * @name Methods for starting and ending objects and arrays
+     */
+    ///@{
+    void StartObject(const std::string &key = "");
+    void EndObject();
+    void StartArray(const std::string &key = "");
+    void EndArray();
+    ///@}
+
+    /**
+     * @name Methods for adding values, in an object with a key or in an array without
+     */
+    ///@{
+    void AddString(const std::string &key, const std::string &value);
+    void AddString(const std::string &value) { this->AddString("", value); }
+    void AddNumber(const std::string &key, double value);
+    void AddNumber(double value) { this->AddNumber("", value); }
+    void AddBool(const std::string &key, bool value);
+    void AddBool(bool value) { this->AddBool("", value); }
+    void AddStringArray(const std::string &key, const std::vector<std::string> &values);
+    ///@}
+
+private:
+    /**
+     * Start a value, with the separator from the previous one, the indentation and the key
+     */
+    void StartValue(const std::string &key);
+
+    /**
+     * End an object or an array
+     */
+    void EndContainer(char closing);
+
+    /**
+     * Append a string with its quotes and the characters escaped
+     */
+    void AppendEscaped(const std::string &value);
+
+public:
+    //
+private:
+    /** The output string */
+    std::string &m_output;
+    /** The types of the containers opened (true for objects) */
+    std::vector<bool> m_containers;
+    /** A flag indicating that a value has been written in the current container */
+    bool m_hasValue;
+};
+
+} // namespace vrv
+
+#endif // __VRV_JSON_WRITER_H__
@@ -22,6 +22,7 @@ namespace vrv {
 class Alignment;
 class Beam;
 class BeamElementCoord;
+class FindSpannedLayerElementsParams;
 class FTrem;
 class Layer;
 class Mensur;
@@ -228,6 +229,12 @@ public:
      */
     data_STAFFREL_basic GetCrossStaffRel() const;
 
+    /**
+     * Check if the element is spanned by the interface of the params and matches its staff, layer and class filters.
+     * Used by the FindSpannedLayerElements functor and by the SpannedElementIndex of the system.
+     */
+    bool IsSpannedElement(const FindSpannedLayerElementsParams *params) const;
+
     /**
      * Get the StaffAlignment for which overflows need to be calculated against.
      * Set to NULL when the overflow needs to be ignored (e.g., for something between the staves in
@@ -405,6 +412,11 @@ public:
      */
     int FindSpannedLayerElements(FunctorParams *functorParams) const override;
 
+    /**
+     * See Object::InitSpannedElementIndex
+     */
+    int InitSpannedElementIndex(FunctorParams *functorParams) const override;
+
     /**
      * See Object::LayerCountInTimeSpan
      */
@@ -269,15 +269,45 @@ public:
      */
     double GetRealTimeOffsetMilliseconds(int repeat) const;
 
+    /**
+     * @name Return the real time duration in millisecond and the number of repeats of the measure.
+     * Both are available once the timemap has been calculated. The duration is the one of the first repeat by
+     * default.
+     */
+    ///@{
+    double GetRealTimeDurationMilliseconds(int repeat = 0) const;
+    int GetRealTimeRepeatCount() const { return (int)m_realTimeOffsetMilliseconds.size(); }
+    ///@}
+
     /**
      * Return vector with tie endpoints for ties that start and end in current measure
      */
     std::vector<std::pair<LayerElement *, LayerElement *>> GetInternalTieEndpoints();
 
     /**
-     * Read only access to m_scoreTimeOffset
+     * @name Read only access to m_scoreTimeOffset, for the last or a given repeat (1-based).
+     * A repeat of 0 returns the last offset, and 0.0 is returned for a measure not played in the timemap.
+     */
+    ///@{
+    double GetLastTimeOffset() const { return (m_scoreTimeOffset.empty()) ? 0.0 : m_scoreTimeOffset.back(); }
+    double GetScoreTimeOffset(int repeat) const;
+    ///@}
+
+    /**
+     * Clear the offsets and the tempos of the repeats, which leaves the measure not played in the timemap.
+     * This is the case of the measures not in an expanded timeline.
      */
-    double GetLastTimeOffset() const { return m_scoreTimeOffset.back(); }
+    void ResetTimeOffsets();
+
+    /**
+     * @name Read only access to m_duration and m_currentTempo, or to the tempo of a given repeat (1-based).
+     * The real times of the notes are relative to the measure and calculated with m_currentTempo.
+     */
+    ///@{
+    double GetScoreTimeDuration() const { return m_duration; }
+    double GetCurrentTempo() const { return m_currentTempo; }
+    double GetCurrentTempo(int repeat) const;
+    ///@}
 
     //----------//
     // Functors //
@@ -288,6 +318,11 @@ public:
      */
     int FindSpannedLayerElements(FunctorParams *functorParams) const override;
 
+    /**
+     * See Object::InitSpannedElementIndex
+     */
+    int InitSpannedElementIndex(FunctorParams *functorParams) const override;
+
     /**
      * See Object::ConvertMarkupAnalytical
      */
@@ -593,6 +628,8 @@ private:
     std::vector<double> m_realTimeOffsetMilliseconds;
     double m_currentTempo;
     double m_duration;
+    /** The tempo of each repeat, which can differ from the one of the first repeat with an expanded timeline */
+    std::vector<double> m_repeatTempos;
 
     std::map<int, BarlineRenditionPair> m_invisibleStaffBarlines;
 };
@@ -8,92 +8,318 @@
 #ifndef __VRV_MIDIEXT_H__
 #define __VRV_MIDIEXT_H__
 
-#include <assert.h>
 #include <map>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
-#include <array>
 
 //----------------------------------------------------------------------------
 
+namespace smf {
+class MidiFile;
+}
+
 namespace vrv {
 
-    class Object;
+class Chord;
+class Measure;
+class Note;
+class Object;
+
+//----------------------------------------------------------------------------
+// MidiExtNote
+//----------------------------------------------------------------------------
 
-    class Note;
+/**
+ * Helper struct to store a note turned on with its staff and related elements.
+ * The related elements are given as a range in MidiExt::GetRelated and start with the note itself.
+ */
+struct MidiExtNote {
+    int pitch;
+    int staffNo;
+    int relatedStart;
+    int relatedCount;
+};
 
-    class Measure;
+//----------------------------------------------------------------------------
+// MidiExtEntry
+//----------------------------------------------------------------------------
+
+/**
+ * Helper struct to store the notes turned on at a given tick.
+ * The notes are given as indexes in MidiExt::GetNotes, sorted by pitch with one note per pitch.
+ * Entries copied for repeats refer to the same notes.
+ */
+struct MidiExtEntry {
+    int tick;
+    int measureNo;
+    int pageNo;
+    std::vector<int> notesOn;
+};
+
+//----------------------------------------------------------------------------
+// MidiExtMeasure
+//----------------------------------------------------------------------------
+
+struct MidiExtMeasure {
+    int tick;
+    int measureNo;
+    int duration;
+    int systemNo;
+};
+
+//----------------------------------------------------------------------------
+// MidiExtAdjustedLayer
+//----------------------------------------------------------------------------
+
+/**
+ * Helper struct to store the staff assigned to a layer in measures with a single staff and two layers.
+ */
+struct MidiExtAdjustedLayer {
+    int measureNo;
+    int staffNo;
+    int layerNo;
+    int adjustedStaffNo;
+};
 
 //----------------------------------------------------------------------------
-// TimemapEntry
+// MidiExt
 //----------------------------------------------------------------------------
 
 /**
- * Helper struct to store timemap entries
+ * This class holds a timeline of the notes and measures of the MIDI output with the IDs of the elements drawn.
+ * It is filled by the GenerateMIDI functor and stored in flat vectors sorted by tick.
+ * The IDs are interned and given as indexes in the ID table.
  */
-    struct MidiExtEntry {
-        std::map<int, std::pair<int, std::vector<std::string>>> notesOn;    // pitch:staff:ids
-        std::map<int, std::pair<int, std::vector<std::string>>> notesOff;
+class MidiExt {
+public:
+    /**
+     * @name Constructors, destructors, and other standard methods
+     */
+    ///@{
+    explicit MidiExt();
+    virtual ~MidiExt();
+    ///@}
+
+    /** Resets the timeline */
+    void Reset();
+
+    /**
+     * @name Methods for filling the timeline.
+     * AddMeasure is called at the beginning of each measure before its notes are added.
+     * Added notes are pending until MergeNotes is called, which is done before copying entries and at the end
+     * of Doc::ExportMIDI.
+     */
+    ///@{
+    void AddNote(int tick, Note *note);
+    void AddMeasure(int tick, int duration, Measure *measure);
+    void CopyMeasures(int fromTick, int endTick, int addTick);
+    void CopyTimeEntry(int fromTick, int endTick, int addTick);
+    void MergeNotes();
+    ///@}
+
+    /**
+     * Return the entry at the tick, or NULL
+     */
+    const MidiExtEntry *GetTimeEntry(int tick);
+
+    /**
+     * @name Getters for the timeline
+     */
+    ///@{
+    const std::vector<MidiExtEntry> &GetEntries() const { return m_entries; }
+    const std::vector<MidiExtNote> &GetNotes() const { return m_notes; }
+    const std::vector<int> &GetRelated() const { return m_related; }
+    const std::vector<MidiExtMeasure> &GetMeasures() const { return m_measures; }
+    const std::map<std::string, int> &GetSystems() const { return m_systemUuid; }
+    const std::vector<MidiExtAdjustedLayer> &GetAdjustedLayers() const { return m_adjustedLayers; }
+    ///@}
+
+    /**
+     * @name Getters for the interned IDs
+     */
+    ///@{
+    const std::string &GetID(int idx) const { return m_ids.at(idx); }
+    std::vector<std::string> GetRelatedIDs(const MidiExtNote &note) const;
+    ///@}
+
+private:
+    /**
+     * A note added and not merged yet into the entries
+     */
+    struct PendingNote {
+        int tick;
+        int noteIdx;
         int measureNo;
         int pageNo;
+        bool hasMeasure;
     };
 
-    struct MidiExtMeasure {
-        int measureNo;
-        int duration;
-        int systemNo;
-    };
+    /**
+     * Return the index of the ID of the object in the ID table, adding it if necessary
+     */
+    int InternID(const Object *object);
+
+    /**
+     * Return the staff of the layer when adjusted for the measure, or the staff given
+     */
+    int GetAdjustedStaffNo(int measureNo, int staffNo, int layerNo) const;
+
+    /** Return the measure at the tick, inserting a new one if necessary */
+    MidiExtMeasure &GetOrInsertMeasure(int tick);
+
+    /**
+     * Merge copies sorted by tick into entries or measures sorted by tick in a single pass.
+     * A copy replaces the item at the same tick.
+     */
+    template <class T> static void MergeCopies(std::vector<T> &items, std::vector<T> &copies);
+
+    /**
+     * Set the zero-based measure number from @n, or -1 and return false if it cannot be parsed
+     */
+    static bool GetMeasureNo(const Measure *measure, int &measureNo);
+
+public:
+    //
+private:
+    /** The entries sorted by tick */
+    std::vector<MidiExtEntry> m_entries;
+    /** The notes added since the last merge */
+    std::vector<PendingNote> m_pendingNotes;
+    /** The notes referred to by the entries */
+    std::vector<MidiExtNote> m_notes;
+    /** The related elements of the notes as indexes in the ID table */
+    std::vector<int> m_related;
+    /** The measures sorted by tick */
+    std::vector<MidiExtMeasure> m_measures;
+    /** The systems with their index */
+    std::map<std::string, int> m_systemUuid;
+    /** The adjusted layers sorted by measure, staff and layer */
+    std::vector<MidiExtAdjustedLayer> m_adjustedLayers;
+
+    /**
+     * @name The ID table and the index of each object in it
+     */
+    ///@{
+    std::vector<std::string> m_ids;
+    std::unordered_map<const Object *, int> m_idIndexes;
+    ///@}
+
+    /**
+     * @name The values of the current measure and of the last chord, shared by their notes
+     */
+    ///@{
+    const Measure *m_currentMeasure;
+    int m_currentMeasureNo;
+    int m_currentPageNo;
+    const Chord *m_lastChord;
+    std::vector<int> m_lastChordRelated;
+    ///@}
+};
 
 //----------------------------------------------------------------------------
-// Timemap
+// MidiStreamEvent
 //----------------------------------------------------------------------------
 
+enum MidiStreamEventType { MIDI_STREAM_tempo = 0, MIDI_STREAM_program, MIDI_STREAM_pedal, MIDI_STREAM_note };
+
 /**
- * This class holds a timemap for exporting onset / offset values.
+ * Helper struct to store an event of the MIDI stream with its time in ticks and in seconds.
+ * For notes, the pitch is the key and the duration is the one until the note off. For program changes, the pitch is
+ * the program number and for pedals the velocity is the controller value. The tempo is set for tempo events only.
+ * The element is the index of the ID of the element played in MidiStream::GetID, or -1.
  */
-    class MidiExt {
-    public:
-        /**
-         * @name Constructors, destructors, and other standard methods
-         */
-        ///@{
-        explicit MidiExt();
+struct MidiStreamEvent {
+    MidiStreamEventType type;
+    int tick;
+    double seconds;
+    int durationTicks;
+    double durationSeconds;
+    int track;
+    int channel;
+    int pitch;
+    int velocity;
+    double tempo;
+    int element;
+};
 
-        virtual ~MidiExt();
-        ///@}
-
-        /** Resets the timemap */
-        void Reset();
+//----------------------------------------------------------------------------
+// MidiStream
+//----------------------------------------------------------------------------
 
-        void AddNote(int tick, Note *note);
+/**
+ * This class holds the events generated for the MIDI output in a flat vector sorted by tick, without encoding a
+ * MIDI file. The note on and note off events are merged into note events with a duration.
+ * The elements are interned while the MIDI output is generated and the events refer to them with a handle.
+ */
+class MidiStream {
+public:
+    /**
+     * @name Constructors, destructors, and other standard methods
+     */
+    ///@{
+    explicit MidiStream();
+    virtual ~MidiStream();
+    ///@}
 
-        MidiExtEntry *GetTimeEntry(int tick);
+    /** Resets the stream */
+    void Reset();
 
-        void AddMeasure(int tick, int duration, Measure *measure);
+    /**
+     * Return the handle of the element, adding its ID to the ID table if necessary
+     */
+    int GetElementHandle(const Object *object);
 
-        void CopyMeasures(int fromTick, int endTick, int addTick);
+    /**
+     * Add the elements of another stream, with the handle in this stream of each of its elements
+     */
+    void AddElements(const MidiStream &other, std::vector<int> &handles);
 
-        void CopyTimeEntry(int fromTick, int endTick, int addTick);
+    /**
+     * Fill the events from the tracks of the MIDI file generated, which do not need to be sorted.
+     * Tempo events repeated at the same tick in several tracks are added only once.
+     */
+    void FillEvents(smf::MidiFile *midiFile);
 
-        const std::map<int, MidiExtMeasure> &GetMeasures() const;
+    /**
+     * @name Getters for the events and the interned IDs
+     */
+    ///@{
+    const std::vector<MidiStreamEvent> &GetEvents() const { return m_events; }
+    int GetTPQ() const { return m_tpq; }
+    const std::string &GetID(int element) const { return m_ids.at(element); }
+    ///@}
 
-        const std::map<int, MidiExtEntry> &GetEntries() const;
+    /**
+     * Write the events as a JSON object with one array per field and the ID table
+     */
+    void ToJson(std::string &output) const;
 
-        const std::map<std::string, int> &GetSystems() const;
+private:
+    /**
+     * Set the duration of the note ons of the track from the note offs.
+     * The notes are given as tick, note off flag and index in the events or in the track for note offs.
+     */
+    void MatchNotes(smf::MidiFile *midiFile, int track, std::vector<std::tuple<int, bool, int>> &notes);
 
-        const std::map<int, std::map<int, std::map<int, int>>> &GetAdjustedLayers() const;
+public:
+    //
+private:
+    /** The events sorted by tick */
+    std::vector<MidiStreamEvent> m_events;
+    /** The ticks per quarter note of the events */
+    int m_tpq;
 
-    private:
-        //
-    public:
-        //
-    private:
-        /** The map with time values as keys */
-        std::map<int, MidiExtEntry> m_entries;
-        std::map<int, MidiExtMeasure> m_measureTicks;
-        std::map<std::string, int> m_systemUuid;
-        std::map<int, std::map<int, std::map<int, int>>> m_adjustedLayers; // measure:staff:layer:staff
-    }; // class Timemap
+    /**
+     * @name The ID table, the object of each ID and the handle of each object
+     */
+    ///@{
+    std::vector<std::string> m_ids;
+    std::vector<const Object *> m_objects;
+    std::unordered_map<const Object *, int> m_idIndexes;
+    ///@}
+};
 
 } // namespace vrv
 
@@ -738,6 +738,11 @@ public:
      */
     virtual int FindSpannedLayerElements(FunctorParams *) const { return FUNCTOR_CONTINUE; }
 
+    /**
+     * Fill the index of the layer elements sorted by x position used for retrieving spanned layer elements
+     */
+    virtual int InitSpannedElementIndex(FunctorParams *) const { return FUNCTOR_CONTINUE; }
+
     /**
      * Look for element by ID in StaffDef elements (Clef, KeySig, etc.) of all layers within
      */
@@ -74,7 +74,7 @@ enum option_SYSTEMDIVIDER { SYSTEMDIVIDER_none = 0, SYSTEMDIVIDER_auto, SYSTEMDI
 // Option
 //----------------------------------------------------------------------------
 
-enum class OptionsCategory { None, Base, General, Layout, Margins, Midi, Selectors, Full };
+enum class OptionsCategory { None, Base, General, Layout, Margins, Midi, Selectors, Output, Full };
 
 /**
  * This class is a base class of each styling parameter
@@ -562,6 +562,19 @@ public:
     // post processing of parameters
     void Sync();
 
+    /**
+     * Return a key with the values of the options that can change the layout.
+     * These are the scale and the options of the general, layout, margins and selectors groups, without the options
+     * that only change the output (see Options::IsOutputOnly).
+     */
+    std::string GetLayoutKey() const;
+
+    /**
+     * Return true if the option only changes the output and not what is drawn by the View.
+     * These are the options of the output group and the SVG output options of the general group.
+     */
+    bool IsOutputOnly(const std::string &key) const;
+
 private:
     void Register(Option *option, const std::string &key, OptionGrp *grp);
 
@@ -600,6 +613,7 @@ public:
     OptionBool m_condenseTempoPages;
     OptionBool m_evenNoteSpacing;
     OptionString m_expand;
+    OptionBool m_expandTimeline;
     OptionIntMap m_footer;
     OptionIntMap m_header;
     OptionBool m_humType;
@@ -631,6 +645,7 @@ public:
     OptionBool m_staccatoCenter;
     OptionBool m_svgBoundingBoxes;
     OptionString m_svgCss;
+    OptionBool m_svgGlyphSprite;
     OptionBool m_svgViewBox;
     OptionBool m_svgHtml5;
     OptionBool m_svgFormatRaw;
@@ -656,6 +671,7 @@ public:
     OptionBool m_beamMixedPreserve;
     OptionDbl m_beamMixedStemMin;
     OptionDbl m_bracketThickness;
+    OptionBool m_breaksEstimate;
     OptionBool m_breaksNoWidow;
     OptionDbl m_dashedBarLineDashLength;
     OptionDbl m_dashedBarLineGapLength;
@@ -799,6 +815,14 @@ public:
 
     OptionBool m_midiNoCue;
     OptionDbl m_midiTempoAdjustment;
+    OptionInt m_midiThreads;
+
+    /**
+     * Output
+     */
+    OptionGrp m_output;
+
+    OptionString m_pngBackground;
 
     /**
      * Deprecated options
@@ -118,8 +118,10 @@ public:
 
     /**
      * Lay out the content of the page (system/staves) vertically.
+     * With estimate, the page is drawn only once and beams, tuplets and slurs are not adjusted, so systems with slurs
+     * are usually estimated smaller. This is sufficient for computing the page breaks but not for rendering the page.
      */
-    void LayOutVertically();
+    void LayOutVertically(bool estimate = false);
 
     /**
      * Justifiy the content of the page (system/staves) vertically
@@ -206,6 +208,13 @@ private:
      */
     bool IsJustificationRequired(const Doc *doc);
 
+    /**
+     * Move the systems overflowing the page once laid out vertically to the beginning of the next page, which is
+     * created if necessary. This happens when the page breaks were computed with estimated system heights.
+     * Return true if some systems were moved, in which case the layout generation of the doc is incremented.
+     */
+    bool MoveOverflowingSystems(Doc *doc);
+
     //
 public:
     /** Page width (MEI scoredef@page.width). Saved if != -1 */
@@ -0,0 +1,337 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        rasterdevicecontext.h
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRV_RASTER_DC_H__
+#define __VRV_RASTER_DC_H__
+
+#include <map>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+#include "devicecontext.h"
+
+namespace vrv {
+
+class Glyph;
+class Object;
+class View;
+
+//----------------------------------------------------------------------------
+// RasterDeviceContext
+//----------------------------------------------------------------------------
+
+/**
+ * This class implements a drawing context rendering directly into an RGBA pixel buffer.
+ * Shapes are flattened to polygons and filled with an anti-aliased scanline rasterizer (non-zero winding).
+ * The music glyphs are drawn from the SVG paths of the font files. Only the bounding boxes of the text fonts are
+ * available, so text is drawn with the music glyphs for the SMuFL characters and as shaded boxes otherwise.
+ * The size of the buffer is the size of the page in pixels, as for the SVG output.
+ * The buffer is transparent unless a background colour is set.
+ */
+class RasterDeviceContext : public DeviceContext {
+public:
+    /**
+     * @name Constructors, destructors, and other standard methods
+     */
+    ///@{
+    RasterDeviceContext();
+    virtual ~RasterDeviceContext();
+    ///@}
+
+    /**
+     * @name Setters
+     */
+    ///@{
+    void SetBackground(int colour, int style = AxSOLID) override;
+    void SetBackgroundImage(void *image, double opacity = 1.0) override{};
+    void SetBackgroundMode(int mode) override{};
+    void SetTextForeground(int colour) override;
+    void SetTextBackground(int colour) override{};
+    void SetLogicalOrigin(int x, int y) override;
+    ///@}
+
+    /**
+     * @name Getters
+     */
+    ///@{
+    Point GetLogicalOrigin() override;
+    ///@}
+
+    /**
+     * @name Getters for the pixel buffer
+     * The RGBA values are not premultiplied and are given row by row from the top.
+     */
+    ///@{
+    int GetPixelWidth() const { return m_pixelWidth; }
+    int GetPixelHeight() const { return m_pixelHeight; }
+    void GetRGBA(std::vector<unsigned char> &output) const;
+    ///@}
+
+    /**
+     * @name Drawing methods
+     */
+    ///@{
+    void DrawQuadBezierPath(Point bezier[3]) override;
+    void DrawCubicBezierPath(Point bezier[4]) override;
+    void DrawCubicBezierPathFilled(Point bezier1[4], Point bezier2[4]) override;
+    void DrawCircle(int x, int y, int radius) override;
+    void DrawEllipse(int x, int y, int width, int height) override;
+    void DrawEllipticArc(int x, int y, int width, int height, double start, double end) override;
+    void DrawLine(int x1, int y1, int x2, int y2) override;
+    void DrawPolyline(int n, Point points[], int xOffset, int yOffset) override;
+    void DrawPolygon(int n, Point points[], int xOffset, int yOffset) override;
+    void DrawRectangle(int x, int y, int width, int height) override;
+    void DrawRotatedText(const std::string &text, int x, int y, double angle) override{};
+    void DrawRoundedRectangle(int x, int y, int width, int height, int radius) override;
+    void DrawText(const std::string &text, const std::wstring &wtext = L"", int x = VRV_UNSET, int y = VRV_UNSET,
+        int width = VRV_UNSET, int height = VRV_UNSET) override;
+    void DrawMusicText(const std::wstring &text, int x, int y, bool setSmuflGlyph = false) override;
+    void DrawSpline(int n, Point points[]) override{};
+    void DrawSvgShape(int x, int y, int width, int height, pugi::xml_node svg) override;
+    void DrawBackgroundImage(int x = 0, int y = 0) override{};
+    ///@}
+
+    /**
+     * @name Method for starting and ending a text
+     */
+    ///@{
+    void StartText(int x, int y, data_HORIZONTALALIGNMENT alignment = HORIZONTALALIGNMENT_left) override;
+    void EndText() override;
+
+    /**
+     * @name Move a text to the specified position, for example when starting a new line.
+     */
+    ///@{
+    void MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignment) override;
+    void MoveTextVerticallyTo(int y) override;
+    ///@}
+
+    /**
+     * @name Method for starting and ending a graphic
+     */
+    ///@{
+    void StartGraphic(
+        Object *object, std::string gClass, std::string gId, bool primary = true, bool prepend = false) override;
+    void EndGraphic(Object *object, View *view) override;
+    ///@}
+
+    /**
+     * @name Method for starting and ending a graphic custom graphic that do not correspond to an Object
+     */
+    ///@{
+    void StartCustomGraphic(std::string name, std::string gClass = "", std::string gId = "") override;
+    void EndCustomGraphic() override;
+    ///@}
+
+    /**
+     * @name Methods for re-starting and ending a graphic for objects drawn in separate steps
+     */
+    ///@{
+    void ResumeGraphic(Object *object, std::string gId) override;
+    void EndResumedGraphic(Object *object, View *view) override;
+    ///@}
+
+    /**
+     * @name Method for rotating a graphic (clockwise).
+     */
+    ///@{
+    void RotateGraphic(Point const &orig, double angle) override;
+    ///@}
+
+    /**
+     * @name Method for starting and ending page
+     */
+    ///@{
+    void StartPage() override;
+    void EndPage() override;
+    ///@}
+
+    /**
+     * Setting the facsimile flag (false by default)
+     */
+    void SetFacsimile(bool facsimile) { m_facsimileOutput = facsimile; }
+
+    /**
+     * Parse a colour given as "#RGB", "#RRGGBB", "rgb(r, g, b)" or as a basic colour name.
+     * Return AxNONE if the colour cannot be parsed.
+     */
+    static int ParseColour(const std::string &colour);
+
+private:
+    /**
+     * A point in pixels or in drawing units
+     */
+    struct Vertex {
+        double x;
+        double y;
+    };
+
+    /**
+     * An affine transformation
+     */
+    struct Matrix {
+        double a = 1.0, b = 0.0, c = 0.0, d = 1.0, e = 0.0, f = 0.0;
+
+        Vertex Apply(double x, double y) const { return { a * x + c * y + e, b * x + d * y + f }; }
+        Matrix Multiply(const Matrix &other) const;
+        double GetScale() const;
+    };
+
+    /**
+     * The state of a graphic: the transformation to pixels, the colour and the visibility
+     */
+    struct Graphic {
+        Matrix m_matrix;
+        int m_colour;
+        bool m_hidden;
+    };
+
+    /**
+     * A segment of a parsed SVG path, with the control points of a cubic bezier curve unless it is a line
+     */
+    struct PathSegment {
+        bool m_isLine;
+        Vertex m_control1;
+        Vertex m_control2;
+        Vertex m_end;
+    };
+
+    /**
+     * A closed subpath of a parsed SVG path
+     */
+    struct PathContour {
+        Vertex m_start;
+        std::vector<PathSegment> m_segments;
+    };
+
+    /**
+     * A text run waiting for the end of the text chunk, needed for its alignment
+     */
+    struct TextRun {
+        std::wstring m_text;
+        FontInfo m_font;
+        Graphic m_graphic;
+    };
+
+    using Polygon = std::vector<Vertex>;
+
+    /**
+     * @name Methods for the current graphic
+     */
+    ///@{
+    void PushGraphic(Object *object);
+    const Graphic &GetGraphic() const { return m_graphics.back(); }
+    ///@}
+
+    /**
+     * @name Methods for resolving the colour and the opacity of the pen and the brush
+     * AxNONE is the colour of the current graphic, as currentColor in SVG.
+     */
+    ///@{
+    int GetPenColour() const;
+    double GetPenOpacity() const;
+    double GetPenWidth() const;
+    int GetBrushColour() const;
+    double GetBrushOpacity() const;
+    ///@}
+
+    /**
+     * @name Methods for flattening shapes to polygons in pixels
+     */
+    ///@{
+    static void AddCubicBezier(
+        Polygon &polygon, const Vertex &p0, const Vertex &p1, const Vertex &p2, const Vertex &p3);
+    void AddEllipse(Polygon &polygon, double cx, double cy, double rx, double ry, double start, double end) const;
+    void AddContours(std::vector<Polygon> &polygons, const std::vector<PathContour> &contours, const Matrix &matrix);
+    ///@}
+
+    /**
+     * @name Methods for filling and stroking polygons in pixels
+     */
+    ///@{
+    void Fill(const std::vector<Polygon> &polygons, int colour, double opacity);
+    void Stroke(const Polygon &polygon, bool closed, double width, int lineCap, int lineJoin, int colour,
+        double opacity, double dashLength = 0.0, double gapLength = 0.0);
+    void StrokeWithPen(const Polygon &polygon, bool closed, int defaultLineCap = AxCAP_BUTT,
+        int defaultLineJoin = AxJOIN_MITER, bool withDashes = true);
+    ///@}
+
+    /**
+     * @name Methods for the accumulation buffer of the rasterizer
+     */
+    ///@{
+    void AddEdge(Vertex p0, Vertex p1, int width, int height);
+    void AddClippedEdge(const Vertex &p0, const Vertex &p1, int width, int height);
+    ///@}
+
+    /**
+     * Return the contours of a glyph, parsing its SVG path if necessary
+     */
+    const std::vector<PathContour> &GetGlyphContours(const Glyph *glyph, double &unitsPerEm);
+
+    /**
+     * Parse an SVG path to contours
+     */
+    static void ParsePath(const std::string &path, std::vector<PathContour> &contours);
+
+    /**
+     * Draw a glyph at the given position and size
+     */
+    void DrawGlyph(const Glyph *glyph, double x, double y, double size, double ratio, const Graphic &graphic);
+
+    /**
+     * Draw the pending text runs
+     */
+    void FlushText();
+
+    /**
+     * Fill the paths of the SVG node and of its descendants
+     */
+    void DrawSvgNode(pugi::xml_node node, const Matrix &matrix);
+
+public:
+    //
+private:
+    /** The pixel buffer as premultiplied RGBA */
+    std::vector<unsigned char> m_pixels;
+    int m_pixelWidth;
+    int m_pixelHeight;
+
+    /** The background colour (AxNONE for transparent) */
+    int m_backgroundColour;
+
+    /** The accumulation buffer of the rasterizer and its row length */
+    std::vector<float> m_accumulation;
+    int m_accumulationStride;
+
+    /** The stack of graphics */
+    std::vector<Graphic> m_graphics;
+
+    /** The parsed contours of the glyphs with their units per em */
+    std::map<const Glyph *, std::pair<std::vector<PathContour>, double>> m_glyphContours;
+
+    /**
+     * @name The current text chunk
+     */
+    ///@{
+    std::vector<TextRun> m_textRuns;
+    double m_textX;
+    double m_textY;
+    data_HORIZONTALALIGNMENT m_textAlignment;
+    ///@}
+
+    int m_originX, m_originY;
+
+    /** Use the size of the facsimile */
+    bool m_facsimileOutput;
+};
+
+} // namespace vrv
+
+#endif // __VRV_RASTER_DC_H__
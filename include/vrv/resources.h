@@ -8,8 +8,18 @@
 #ifndef __VRV_RESOURCES_H__
 #define __VRV_RESOURCES_H__
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
 #include "glyph.h"
 
+namespace pugi {
+class xml_document;
+}
+
 namespace vrv {
 
 //----------------------------------------------------------------------------
@@ -19,6 +29,7 @@ namespace vrv {
 /**
  * This class provides resource values.
  * It manages fonts and glyph tables.
+ * The content of the font files is loaded once per process and shared by all the instances.
  */
 
 class Resources {
@@ -26,7 +37,10 @@ public:
     using StyleAttributes = std::pair<data_FONTWEIGHT, data_FONTSTYLE>;
     using GlyphTable = std::unordered_map<wchar_t, Glyph>;
     using GlyphNameTable = std::unordered_map<std::string, wchar_t>;
-    using GlyphTextMap = std::map<StyleAttributes, GlyphTable>;
+    using GlyphPointerTable = std::unordered_map<wchar_t, const Glyph *>;
+    using GlyphTextMap = std::map<StyleAttributes, GlyphPointerTable>;
+    using XMLDocumentMap = std::map<std::string, std::unique_ptr<pugi::xml_document>>;
+    using EmbeddedFileMap = std::map<std::string, std::pair<const char *, size_t>>;
 
     /**
      * @name Constructors, destructors, and other standard methods
@@ -34,6 +48,9 @@ public:
     ///@{
     Resources();
     virtual ~Resources() = default;
+    // The glyph index points to the shared font files and cannot be copied
+    Resources(const Resources &) = delete;
+    Resources &operator=(const Resources &) = delete;
     ///@}
 
     /**
@@ -81,21 +98,86 @@ public:
     const Glyph *GetTextGlyph(wchar_t code) const;
     ///@}
 
+    /**
+     * SVG definitions
+     * The XML files are parsed only once and kept in a cache shared by all the instances in the process.
+     */
+    ///@{
+    /** Returns the parsed XML file of a glyph (NULL if it cannot be loaded) */
+    const pugi::xml_document *GetGlyphDefinition(const Glyph *glyph) const;
+    /** Returns the parsed woff VerovioText font (NULL if it cannot be loaded) */
+    const pugi::xml_document *GetWoffDefinition() const;
+    ///@}
+
+    /**
+     * Load an XML file with its name relative to the resource directory.
+     * When built with EMBED_RESOURCES, the files compiled in the library are used and the file system is accessed only
+     * for the files that are not embedded.
+     */
+    bool LoadResourceFile(pugi::xml_document &doc, const std::string &name) const;
+
 private:
+    /**
+     * The content of a font file.
+     * It is immutable once loaded.
+     */
+    struct FontFile {
+        GlyphTable m_glyphTable;
+        GlyphNameTable m_glyphNameTable;
+    };
+    using SharedFontFile = std::shared_ptr<const FontFile>;
+    using FontFileMap = std::map<std::string, SharedFontFile>;
+
     bool LoadFont(const std::string &fontName);
 
+    /** Add or replace a glyph in the glyph index */
+    void AddGlyph(wchar_t smuflCode, const Glyph *glyph);
+
+    /**
+     * Return the content of a font file from the process-wide cache, loading it if necessary.
+     * Return NULL if the file cannot be loaded.
+     */
+    static SharedFontFile GetFontFile(const std::string &path, const std::string &name, bool isTextFont);
+
+    /**
+     * Parse the content of a font file.
+     * For the text font, only the bounding boxes are loaded and path and codeStr will remain [unset]
+     */
+    ///@{
+    static SharedFontFile ParseFontFile(const std::string &path, const std::string &name);
+    static SharedFontFile ParseTextFontFile(const std::string &path, const std::string &name);
+    ///@}
+
+    /** Return the XML document for the path from the cache, loading it if necessary */
+    static const pugi::xml_document *GetCachedXMLDocument(const std::string &path, const std::string &name);
+
+    /** Load an XML file from the resource directory or from the embedded files */
+    static bool LoadFile(pugi::xml_document &doc, const std::string &path, const std::string &name);
+
+    /**
+     * The files of the resource directory compiled in the library with EMBED_RESOURCES.
+     * Keys are the names relative to the resource directory.
+     * Defined in the file generated by fonts/generate-embedded-resources.py
+     */
+    static const EmbeddedFileMap &GetEmbeddedFiles();
+
 private:
     /** The path to the resources directory (e.g., for the svg/ subdirectory with fonts as XML */
     std::string m_path;
-    /** The loaded SMuFL font */
-    GlyphTable m_fontGlyphTable;
+    /** The font files loaded so far, in the order in which they apply (the last one has precedence) */
+    std::vector<SharedFontFile> m_fontFiles;
+    /** The text font files loaded so far */
+    std::vector<SharedFontFile> m_textFontFiles;
+    /**
+     * A dense index of the glyphs of the loaded SMuFL fonts in the private use area.
+     * Values point to the glyphs of the shared font files.
+     */
+    std::vector<const Glyph *> m_fontGlyphIndex;
+    /** The glyphs of the loaded SMuFL fonts outside the private use area */
+    GlyphPointerTable m_fontGlyphTable;
     /** A text font used for bounding box calculations */
     GlyphTextMap m_textFont;
     mutable StyleAttributes m_currentStyle;
-    /**
-     * A map of glyph name / code
-     */
-    GlyphNameTable m_glyphNameTable;
 
     //----------------//
     // Static members //
@@ -104,8 +186,20 @@ private:
     /** The default path to the resources directory (e.g., for the svg/ subdirectory with fonts as XML */
     static thread_local std::string s_defaultPath;
 
+    /** The content of the font files loaded in the process with their filename as key */
+    static FontFileMap s_fontFiles;
+    static std::mutex s_fontFilesMutex;
+
+    /** The cache of parsed XML documents (glyphs and woff) loaded in the process with their path as key */
+    static XMLDocumentMap s_xmlDocuments;
+    static std::mutex s_xmlDocumentsMutex;
+
     /** The default font style */
     static const StyleAttributes k_defaultStyle;
+
+    /** The range of code points covered by the glyph index (the Unicode private use area) */
+    static const wchar_t k_glyphIndexStart = 0xE000;
+    static const wchar_t k_glyphIndexEnd = 0xF900;
 };
 
 } // namespace vrv
@@ -71,6 +71,12 @@ public:
      */
     std::string GetStringSVG(bool xml_declaration = false);
 
+    /**
+     * Get the definitions of the glyphs used so far as a separate SVG document.
+     * This is the sprite referenced by the pages drawn with a glyph href (see SetGlyphHref).
+     */
+    std::string GetStringGlyphSprite(bool xml_declaration = false);
+
     /**
      * @name Drawing methods
      */
@@ -165,6 +171,12 @@ public:
     void AddDescription(const std::string &text) override;
     ///@}
 
+    /**
+     * Return the id of the graphic of an object, with the page number as postfix for the running elements of a
+     * multi-page SVG since they are drawn on every page
+     */
+    std::string GetGraphicId(const Object *object, const std::string &gId) const;
+
     /**
      * Add id, data-id and class attributes
      */
@@ -223,6 +235,28 @@ public:
      */
     void SetCss(std::string css) { m_css = css; }
 
+    /**
+     * @name Setters for sharing the glyph definitions between several pages
+     * With a glyph href, the glyphs are referenced in the sprite file instead of being defined in the SVG. All the
+     * pages sharing a sprite have to use the same postfix id, which is otherwise generated for each device context.
+     */
+    ///@{
+    void SetGlyphHref(const std::string &glyphHref) { m_glyphHref = glyphHref; }
+    void SetGlyphPostfixId(const std::string &glyphPostfixId) { m_glyphPostfixId = glyphPostfixId; }
+    ///@}
+
+    /**
+     * Add the glyphs used by another device context, for building a sprite shared by several pages
+     */
+    void AddGlyphs(const SvgDeviceContext &svg);
+
+    /**
+     * Setting m_multiPage flag (false by default).
+     * When set, all the pages drawn are stacked vertically in the SVG and the glyphs are defined only once.
+     * The ids of the running elements get the page number as postfix for them to remain unique.
+     */
+    void SetMultiPage(bool multiPage) { m_multiPage = multiPage; }
+
     /**
      *  Copies additional attributes of defined elements to the SVG, each string in the form "elementName@attribute"
      * (e.g., "note@pname")
@@ -265,10 +299,25 @@ private:
      */
     void Commit(bool xml_declaration);
 
-    void WriteLine(std::string);
+    /**
+     * Append the <defs> for m_smuflGlyphs to the node
+     */
+    void AppendGlyphDefinitions(pugi::xml_node node);
+
+    /**
+     * Save the SVG document to m_outdata
+     */
+    void SaveDocument(bool xml_declaration);
 
     std::string GetColour(int colour);
 
+    /**
+     * Append an integer to a string.
+     * Used instead of StringFormat for building the attribute values in the frequently called drawing methods.
+     */
+    static void AppendInt(std::string &str, int value);
+    static void AppendPoint(std::string &str, const Point &point);
+
     pugi::xml_node AppendChild(std::string name);
 
     /**
@@ -290,18 +339,21 @@ private:
      */
     bool m_vrvTextFont;
 
-    // we use a std::stringstream because we want to prepend the <defs> which will know only when we reach the end of
+    // we use a buffer because we want to prepend the <defs> which will know only when we reach the end of
     // the page
     // some viewer seem to support to have the <defs> at the end, but some do not (pdf2svg, for example)
     // for this reason, the full svg is finally written a string from the destructor or when Flush() is called
-    std::ostringstream m_outdata;
+    std::string m_outdata;
+
+    // buffer for building the attribute values in the drawing methods
+    std::string m_valueBuffer;
 
     bool m_committed; // did we flushed the file?
     int m_originX, m_originY;
 
-    // holds the list of glyphs from the smufl font used so far
+    // holds the list of glyphs from the smufl font used so far, ordered by code point
     // they will be added at the end of the file as <defs>
-    std::set<const Glyph *> m_smuflGlyphs;
+    std::map<wchar_t, const Glyph *> m_smuflGlyphs;
 
     // pugixml data
     pugi::xml_document m_svgDoc;
@@ -309,6 +361,8 @@ private:
     pugi::xml_node m_pageNode;
     pugi::xml_node m_currentNode;
     std::list<pugi::xml_node> m_svgNodeStack;
+    // the graphic nodes by id for resuming them without searching the document
+    std::map<std::string, pugi::xml_node> m_graphicNodes;
 
     // output as mm (for pdf generation with a 72 dpi)
     bool m_mmOutput;
@@ -331,6 +385,14 @@ private:
     int m_indent;
     // prefix to be added to font glyphs
     std::string m_glyphPostfixId;
+    // the sprite file where the glyphs are defined (none by default)
+    std::string m_glyphHref;
+    // stack all the pages in the SVG
+    bool m_multiPage;
+    // the number of pages drawn and the size of the pages stacked so far (in pixels)
+    int m_pageCount;
+    double m_multiPageWidth;
+    double m_multiPageHeight;
 };
 
 } // namespace vrv
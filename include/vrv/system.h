@@ -19,11 +19,79 @@ namespace vrv {
 class SystemMilestoneEnd;
 class DeviceContext;
 class Ending;
+class FindSpannedLayerElementsParams;
+class LayerElement;
 class Measure;
 class ScoreDef;
 class Slur;
 class Staff;
 
+//----------------------------------------------------------------------------
+// SpannedElementIndex
+//----------------------------------------------------------------------------
+
+/**
+ * This class holds the layer elements of a system sorted by their left content position for each staff.
+ * It is filled once all the layer elements of the system have been drawn and allows range queries on x.
+ */
+class SpannedElementIndex {
+public:
+    /**
+     * @name Constructors, destructors, and other standard methods
+     */
+    ///@{
+    SpannedElementIndex() { this->Reset(); }
+    virtual ~SpannedElementIndex() {}
+    void Reset();
+    ///@}
+
+    /**
+     * @name Initialization of the index for a list of class ids
+     */
+    ///@{
+    bool IsInitialized() const { return m_isInitialized; }
+    void Init(const System *system, const std::vector<ClassId> &classIds);
+    const std::vector<ClassId> &GetClassIds() const { return m_classIds; }
+    ///@}
+
+    /**
+     * @name Add a measure or an element for a staff number and an optional cross staff number
+     * (called by Object::InitSpannedElementIndex)
+     */
+    ///@{
+    void AddMeasure(const Measure *measure);
+    void AddElement(const LayerElement *element, int staffN, int crossStaffN = VRV_UNSET);
+    ///@}
+
+    /**
+     * Fill the params with the elements spanned between its minimum and maximum position, in document order.
+     * Equivalent to running Object::FindSpannedLayerElements on the system.
+     */
+    void FindSpannedLayerElements(FindSpannedLayerElementsParams *params) const;
+
+private:
+    struct IndexEntry {
+        int m_left;
+        int m_right;
+        int m_measureIdx;
+        int m_order;
+        const LayerElement *m_element;
+    };
+
+    /** The entries sorted by left position for each staff */
+    std::map<int, std::vector<IndexEntry>> m_entries;
+    /** The maximum width of the entries for each staff */
+    std::map<int, int> m_maxWidths;
+    /** The index position of the measures in the system */
+    std::map<const Measure *, int> m_measureIdx;
+    /** The class ids stored in the index */
+    std::vector<ClassId> m_classIds;
+    /** The current measure index and the document order counter used while filling */
+    int m_currentMeasureIdx;
+    int m_currentOrder;
+    bool m_isInitialized;
+};
+
 //----------------------------------------------------------------------------
 // System
 //----------------------------------------------------------------------------
@@ -128,6 +196,14 @@ public:
     void IsDrawingOptimized(bool drawingIsOptimized) { m_drawingIsOptimized = drawingIsOptimized; }
     ///@}
 
+    /**
+     * Retrieve the layer elements spanned by two positions as with Object::FindSpannedLayerElements.
+     * The lookup uses the spanned element index which is initialized on the first call.
+     * It must be reset (see ResetSpannedElementIndex) each time the system layer elements are redrawn.
+     */
+    void FindSpannedLayerElements(FindSpannedLayerElementsParams *params) const;
+    void ResetSpannedElementIndex() { m_spannedElementIndex.Reset(); }
+
     /**
      * Add an object to the drawing list but only if necessary.
      * Check types but also links (dynam, dir) and extensions (trill).
@@ -397,6 +473,11 @@ private:
      * This does not mean that a staff is hidden, but only that it can be optimized.
      */
     bool m_drawingIsOptimized;
+
+    /**
+     * The index of layer elements sorted by x used for collecting the elements spanned by slurs
+     */
+    mutable SpannedElementIndex m_spannedElementIndex;
 };
 
 } // namespace vrv
@@ -8,7 +8,10 @@
 #ifndef __VRV_TOOLKIT_H__
 #define __VRV_TOOLKIT_H__
 
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 //----------------------------------------------------------------------------
 
@@ -20,8 +23,10 @@
 
 namespace vrv {
 
+class DisplayListDeviceContext;
 class EditorToolkit;
 class RuntimeClock;
+class SvgDeviceContext;
 
 enum FileFormat {
     UNKNOWN = 0,
@@ -39,7 +44,10 @@ enum FileFormat {
     MUSEDATAHUM,
     ESAC,
     MIDI,
-    TIMEMAP
+    TIMEMAP,
+    BINARY,
+    PNG,
+    SVGZ
 };
 
 void SetDefaultResourcePath(const std::string &path);
@@ -209,6 +217,8 @@ public:
      * Return the number of pages in the loaded document
      *
      * The number of pages depends one the page size and if encoded layout was taken into account or not.
+     * With the breaksEstimate option, it can increase when a page is rendered, since the systems overflowing it
+     * are moved to the next page.
      *
      * @return The number of pages
      */
@@ -327,6 +337,8 @@ public:
     /**
      * Edit the MEI data
      *
+     * The editor is not available when Verovio is built with Humdrum support.
+     *
      * @param editorAction The editor actions as a stringified JSON object
      * @return True if the edit action was successfully applied
      **/
@@ -368,6 +380,143 @@ public:
      */
     bool RenderToSVGFile(const std::string &filename, int pageNo = 1);
 
+    /**
+     * Render a page to gzip compressed SVG (svgz).
+     *
+     * The SVG is compressed with miniz and is not available when building with NO_MXL_SUPPORT.
+     *
+     * @param pageNo The page to render (1-based)
+     * @return The compressed SVG page as a base64 encoded string
+     */
+    std::string RenderToSVGZ(int pageNo = 1);
+
+    /**
+     * Render a page to gzip compressed SVG (svgz) and save it to the file.
+     *
+     * This methods is not available in the JavaScript version of the toolkit.
+     *
+     * @param @filename The output filename
+     * @param pageNo The page to render (1-based)
+     * @return True if the file was successfully written
+     */
+    bool RenderToSVGZFile(const std::string &filename, int pageNo = 1);
+
+    /**
+     * Render a page to gzip compressed SVG (svgz) into the buffer.
+     *
+     * @ingroup nodoc
+     */
+    void RenderToSVGZ(std::vector<unsigned char> &output, int pageNo);
+
+    /**
+     * Render a range of pages to a single SVG document.
+     *
+     * The pages are stacked vertically, each of them in its own nested SVG element, and the glyphs are defined
+     * only once for all of them.
+     * The JSON options are "from" and "to" (1-based and inclusive, all the pages by default).
+     * Elements spanning several pages are drawn on each of them with the same id.
+     *
+     * @param jsonOptions A stringified JSON object with the page range
+     * @return The SVG document as a string
+     */
+    std::string RenderToSVGDocument(const std::string &jsonOptions = "");
+
+    /**
+     * Render a range of pages to SVG with the glyphs defined in a shared sprite.
+     *
+     * The pages reference the glyphs in the sprite instead of each of them defining them, which reduces the size
+     * of the output for long scores. The sprite has to be made available at the URL referenced by the pages.
+     * The JSON options are "from" and "to" (1-based and inclusive, all the pages by default) and "spriteHref" (the
+     * URL of the sprite as referenced from the pages, "glyphs.svg" by default).
+     *
+     * @param jsonOptions A stringified JSON object with the page range and the sprite URL
+     * @return A stringified JSON object with the "sprite" and the "pages" as an array of SVG strings
+     */
+    std::string RenderToSVGPages(const std::string &jsonOptions = "");
+
+    /**
+     * Render a range of pages to SVG with the glyphs defined in a shared sprite.
+     *
+     * @ingroup nodoc
+     */
+    void RenderToSVGPages(int fromPage, int toPage, const std::string &spriteHref, std::vector<std::string> &pages,
+        std::string &sprite, bool xmlDeclaration = false);
+
+    /**
+     * Render a region of a page to SVG.
+     *
+     * Only the systems and measures overlapping the region are drawn. The region is given either with "x", "y",
+     * "width" and "height" in MEI units within the page content (i.e., without the page margins), or with a
+     * "startMeasure" and an optional "endMeasure" xml:id on the page.
+     * The size of the SVG is the one of the full page.
+     *
+     * @param pageNo The page to render (1-based)
+     * @param jsonOptions A stringified JSON object with the region
+     * @return The SVG page region as a string
+     */
+    std::string RenderToSVGRegion(int pageNo, const std::string &jsonOptions);
+
+    /**
+     * Render a page to a compact binary stream of drawing commands.
+     *
+     * The stream is meant to be drawn by the client (e.g., into a canvas) without parsing SVG.
+     * It is made of little-endian 32-bit integers and its format is documented in BinaryDeviceContext.
+     *
+     * @param pageNo The page to render (1-based)
+     * @return The binary stream as a base64 encoded string
+     */
+    std::string RenderToBinary(int pageNo = 1);
+
+    /**
+     * Render a page to a binary stream of drawing commands and save it to the file.
+     *
+     * This methods is not available in the JavaScript version of the toolkit.
+     *
+     * @param @filename The output filename
+     * @param pageNo The page to render (1-based)
+     * @return True if the file was successfully written
+     */
+    bool RenderToBinaryFile(const std::string &filename, int pageNo = 1);
+
+    /**
+     * Render a page to a binary stream of drawing commands into the buffer.
+     *
+     * @ingroup nodoc
+     */
+    void RenderToBinary(std::vector<unsigned char> &output, int pageNo);
+
+    /**
+     * Render a page to a PNG image.
+     *
+     * The image is rasterized by Verovio and has the size of the SVG page.
+     * Music symbols are drawn with their outlines, but text characters other than SMuFL ones are drawn as shaded
+     * boxes because only the metrics of the text fonts are available.
+     * The background is transparent unless the "pngBackground" option is set.
+     * The image is encoded with miniz and is not available when building with NO_MXL_SUPPORT.
+     *
+     * @param pageNo The page to render (1-based)
+     * @return The PNG image as a base64 encoded string
+     */
+    std::string RenderToPNG(int pageNo = 1);
+
+    /**
+     * Render a page to a PNG image and save it to the file.
+     *
+     * This methods is not available in the JavaScript version of the toolkit.
+     *
+     * @param @filename The output filename
+     * @param pageNo The page to render (1-based)
+     * @return True if the file was successfully written
+     */
+    bool RenderToPNGFile(const std::string &filename, int pageNo = 1);
+
+    /**
+     * Render a page to a PNG image into the buffer.
+     *
+     * @ingroup nodoc
+     */
+    void RenderToPNG(std::vector<unsigned char> &output, int pageNo);
+
     /**
      * Render the document to MIDI
      *
@@ -377,6 +526,40 @@ public:
 
     void RenderToMIDI(smf::MidiFile* midiFile, MidiExt* midiExt);
 
+    /**
+     * Render the document to a stream of MIDI events
+     *
+     * The events are sorted by tick, with the tempo changes, the program changes and the pedals before the notes.
+     * Each note event has its duration and the handle of the element playing it in the ID table.
+     * The event types are 0 for tempo changes, 1 for program changes, 2 for pedals and 3 for notes.
+     *
+     * @return A stringified JSON object with one array per field of the events and the ID table
+     */
+    std::string RenderToMIDIEvents();
+
+    /**
+     * Render the document to a stream of MIDI events without encoding a MIDI file.
+     *
+     * @ingroup nodoc
+     */
+    void RenderToMIDIEvents(MidiStream *midiStream);
+
+    /**
+     * Render a chunk of the document to MIDI
+     *
+     * The chunk is given by its first and last measures (firstMeasure and lastMeasure IDs, with their 1-based pass
+     * firstRepeat and lastRepeat with an expanded timeline) or by a time range in milliseconds (startTime and
+     * endTime), which includes all the measure passes played in it.
+     * The events start at the beginning of the first measure and follow the timemap, without repeats, so chunks of
+     * consecutive measure passes rendered one after the other give the timemap performance.
+     * Notes tied from before the chunk are started with it, unless continued is set for chunks rendered one after
+     * the other. This can be used for starting the playback before the whole document is rendered.
+     *
+     * @param jsonOptions A stringified JSON object with the chunk and the continued flag
+     * @return A MIDI file as a base64 encoded string
+     */
+    std::string RenderToMIDIChunk(const std::string &jsonOptions);
+
     /**
      * Render a document to MIDI and save it to the file.
      *
@@ -530,10 +713,23 @@ public:
      */
     std::string GetElementsAtTime(int millisec);
 
+    /**
+     * Returns array of the elements being played in a time range
+     *
+     * The elements are grouped by measure, in the order they are played, with their onset and offset times.
+     * This can be used for preparing the highlighting of the elements for a whole time window.
+     *
+     * @param startMillisec The start of the range in milliseconds
+     * @param endMillisec The end of the range in milliseconds
+     * @return A stringified JSON array of objects with the measure, the page, the notes, chords and rests
+     */
+    std::string GetElementsInTimeRange(int startMillisec, int endMillisec);
+
     /**
      * Return the page on which the element is the ID (xml:id) is rendered
      *
      * This takes into account the current layout options.
+     * With the breaksEstimate option, the page can change when a page preceding it is rendered.
      *
      * @param xmlId the ID (xml:id) of the element being looked for
      * @return the page number (1-based) where the element is (0 if not found)
@@ -591,12 +787,28 @@ public:
      *
      * Return scoreTimeOnset, scoreTimeOffset, scoreTimeTiedDuration,
      * realTimeOnsetMilliseconds, realTimeOffsetMilliseconds, realTimeTiedDurationMilliseconds.
+     * The real times are given for each time the note is played with the repeats.
      *
      * @param xmlId the ID (xml:id) of the element being looked for
      * @return A stringified JSON object with the values
      */
     std::string GetTimesForElement(const std::string &xmlId);
 
+    /**
+     * Return the onset, offset and MIDI pitch of a set of elements
+     *
+     * The elements are given by their IDs (ids) or by their type (note, chord or rest; note by default), and can be
+     * limited to a measure range (firstMeasure and lastMeasure IDs). The values are the ones precomputed with the
+     * timemap, which is much faster than calling GetTimesForElement for each element.
+     * The pitch is -1 for chords and rests. Only the first time an element is played is given, unless repeats is
+     * true, in which case the element is given once for each time it is played with the repeat number.
+     *
+     * @param jsonOptions A stringified JSON object with the elements to look for
+     * @return A stringified JSON object with arrays of ids, offsets, onsets and pitches (and repeats), in the order of
+     * the ids given or in score order
+     */
+    std::string GetTimesForElements(const std::string &jsonOptions);
+
     ///@}
 
     /**
@@ -679,6 +891,23 @@ public:
      */
     const char *GetCString();
 
+    /**
+     * Move the data to the binary internal buffer
+     *
+     * @ingroup nodoc
+     */
+    void SetCBuffer(std::vector<unsigned char> &data);
+
+    /**
+     * Return the content and the size in bytes of the binary internal buffer
+     *
+     * @ingroup nodoc
+     */
+    ///@{
+    const unsigned char *GetCBuffer() const { return m_cBuffer.data(); }
+    int GetCBufferSize() const { return (int)m_cBuffer.size(); }
+    ///@}
+
     /**
      * Write the Humdrum buffer to the outputstream
      *
@@ -761,6 +990,30 @@ private:
     bool LoadZipData(const std::vector<unsigned char> &bytes);
     void GetClassIds(const std::vector<std::string> &classStrings, std::vector<ClassId> &classIds);
 
+    /**
+     * Compress the data with gzip, using the deflate of the embedded miniz.
+     * Return false if the compression failed.
+     */
+    static bool GzipCompress(const std::string &data, std::vector<unsigned char> &output);
+
+    /**
+     * Set the SVG output options to the device context
+     */
+    void SetSvgOptions(SvgDeviceContext *svg);
+
+    /**
+     * Read the "from" and "to" pages of a range from the JSON options (all the pages by default).
+     * Return false if the range is empty.
+     */
+    bool GetPageRange(const std::string &jsonOptions, int &fromPage, int &toPage);
+
+    /**
+     * Reset the display lists of the pages already rendered.
+     * This has to be called whenever the content or an option used by the View changes. A change of the layout
+     * objects is detected with the layout generation of the Doc.
+     */
+    void ResetDisplayListCache();
+
 public:
     //
 private:
@@ -779,8 +1032,23 @@ private:
      */
     char *m_cString;
 
+    /**
+     * The C buffer for binary output.
+     */
+    std::vector<unsigned char> m_cBuffer;
+
     EditorToolkit *m_editorToolkit;
 
+    /**
+     * The display lists of the pages already rendered to SVG or binary, by page index and global styling.
+     * They are replayed when the same page is rendered again.
+     */
+    std::map<std::pair<int, bool>, std::unique_ptr<DisplayListDeviceContext>> m_displayLists;
+    /** The layout generation of the Doc in which the display lists were drawn */
+    int m_displayListGeneration;
+    /** The music font with which the display lists were drawn */
+    std::string m_displayListFont;
+
 #ifndef NO_RUNTIME
     /** Measuring runtime */
     RuntimeClock *m_runtimeClock;
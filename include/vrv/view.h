@@ -53,6 +53,7 @@ class Mordent;
 class Nc;
 class Neume;
 class Num;
+class Object;
 class Octave;
 class Options;
 class Page;
@@ -193,6 +194,17 @@ public:
     void SetSlurHandling(SlurHandling slurHandling) { m_slurHandling = slurHandling; }
     ///@}
 
+    /**
+     * @name Set and reset the region of the page to be drawn.
+     * The coordinates are the ones of the page content in the output (y going downwards).
+     * Systems and measures that do not intersect with the region are not drawn.
+     */
+    ///@{
+    void SetDrawingRegion(int x1, int y1, int x2, int y2);
+    void ResetDrawingRegion();
+    bool HasDrawingRegion() const { return (m_regionX1 != VRV_UNSET); }
+    ///@}
+
 protected:
     /**
      * @name Methods for drawing System, ScoreDef, StaffDef, Staff, and Layer.
@@ -574,6 +586,20 @@ protected:
     void DrawVerticalDots(DeviceContext *dc, int x, const SegmentedLine &line, int barlineWidth, int interval);
     ///@}
 
+    /**
+     * Check if an object intersects with the drawing region using its content bounding box.
+     * Always true when no region is set or when the object has no bounding box.
+     * Defined in view_page.cpp
+     */
+    bool IsInDrawingRegion(Object *object);
+
+    /**
+     * Add the time spanning elements of a measure that is not drawn to the drawing list of the system.
+     * This makes sure that the ones ending in the drawing region are drawn.
+     * Defined in view_page.cpp
+     */
+    void AddMeasureToDrawingList(Measure *measure, System *system);
+
     /**
      * Calculate the ScoreDef width by taking into account its widest key signature.
      * This is used in justifiation for anticipating the width of initial scoreDefs that are not drawn in the un-casted
@@ -664,6 +690,16 @@ protected:
      */
     SlurHandling m_slurHandling;
 
+    /**
+     * @name The region of the page to be drawn (VRV_UNSET for the full page)
+     */
+    ///@{
+    int m_regionX1;
+    int m_regionY1;
+    int m_regionX2;
+    int m_regionY2;
+    ///@}
+
     /**
      * The current drawing score def.
      * The is set when starting to draw a page in DrawCurrentPage and then
@@ -66,6 +66,14 @@ namespace vrv {
 
 #define UNACC_GRACENOTE_DUR 27 // in milliseconds
 
+#define MIDI_NOTES_PER_THREAD 1000 // minimum number of notes and rests for exporting the staves concurrently
+
+//----------------------------------------------------------------------------
+// Layout defines
+//----------------------------------------------------------------------------
+
+#define CAST_OFF_CACHE_SIZE 4 // number of cast offs kept in the cache
+
 //----------------------------------------------------------------------------
 // Object defines
 //----------------------------------------------------------------------------
@@ -255,6 +263,9 @@ enum ClassId : uint16_t {
     //
     BBOX_DEVICE_CONTEXT,
     SVG_DEVICE_CONTEXT,
+    DISPLAYLIST_DEVICE_CONTEXT,
+    BINARY_DEVICE_CONTEXT,
+    RASTER_DEVICE_CONTEXT,
     CUSTOM_DEVICE_CONTEXT,
     //
     UNSPECIFIED
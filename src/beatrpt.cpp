@@ -93,7 +93,9 @@ int BeatRpt::GenerateMIDI(FunctorParams *functorParams)
         event = params->m_midiFile->getEvent(params->m_midiTrack, i);
         if (event.tick >= (starttime - beatLength) * tpq && event.tick < starttime * tpq && event.layer == params->m_layerIndex) {
             if (((event[0] & 0xf0) == 0x80) || ((event[0] & 0xf0) == 0x90)) {
-                params->m_midiFile->addEvent(params->m_midiTrack, event.tick + beatLength * tpq, event);
+                smf::MidiEvent *copy
+                    = params->m_midiFile->addEvent(params->m_midiTrack, event.tick + beatLength * tpq, event);
+                copy->element = event.element;
             }
         }
     }
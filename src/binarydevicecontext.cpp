@@ -0,0 +1,400 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        binarydevicecontext.cpp
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "binarydevicecontext.h"
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+
+//----------------------------------------------------------------------------
+
+#include "atts_shared.h"
+#include "glyph.h"
+#include "object.h"
+#include "resources.h"
+#include "vrv.h"
+
+//----------------------------------------------------------------------------
+
+namespace vrv {
+
+/** The magic number at the beginning of the output ("VRVB" when read as bytes) */
+#define BINARY_MAGIC 0x42565256
+/** The version of the format */
+#define BINARY_VERSION 1
+
+//----------------------------------------------------------------------------
+// BinaryDeviceContext
+//----------------------------------------------------------------------------
+
+BinaryDeviceContext::BinaryDeviceContext() : DeviceContext(BINARY_DEVICE_CONTEXT)
+{
+    m_hasPen = false;
+    m_hasBrush = false;
+    m_hasFont = false;
+
+    m_originX = 0;
+    m_originY = 0;
+
+    m_facsimileOutput = false;
+}
+
+BinaryDeviceContext::~BinaryDeviceContext() {}
+
+void BinaryDeviceContext::SetTextForeground(int colour)
+{
+    m_brushStack.top().SetColour(colour); // we use the brush colour for text
+}
+
+void BinaryDeviceContext::SetLogicalOrigin(int x, int y)
+{
+    m_originX = -x;
+    m_originY = -y;
+}
+
+Point BinaryDeviceContext::GetLogicalOrigin()
+{
+    return Point(m_originX, m_originY);
+}
+
+void BinaryDeviceContext::AddCommand(BinaryCommand command, std::initializer_list<int> values)
+{
+    m_commands.push_back(command);
+    m_commands.push_back((int)values.size());
+    m_commands.insert(m_commands.end(), values);
+}
+
+void BinaryDeviceContext::AddPointsCommand(
+    BinaryCommand command, int n, const Point points[], bool addCount, int xOffset, int yOffset)
+{
+    m_commands.push_back(command);
+    m_commands.push_back(2 * n + (addCount ? 1 : 0));
+    if (addCount) m_commands.push_back(n);
+    for (int i = 0; i < n; ++i) {
+        m_commands.push_back(points[i].x + xOffset);
+        m_commands.push_back(points[i].y + yOffset);
+    }
+}
+
+void BinaryDeviceContext::UpdateState()
+{
+    if (!m_penStack.empty() && (!m_hasPen || (m_penStack.top() != m_currentPen))) {
+        m_currentPen = m_penStack.top();
+        m_hasPen = true;
+        AddCommand(BINARY_PEN,
+            { m_currentPen.GetColour(), m_currentPen.GetWidth(), m_currentPen.GetDashLength(),
+                m_currentPen.GetGapLength(), m_currentPen.GetLineCap(), m_currentPen.GetLineJoin(),
+                (int)(m_currentPen.GetOpacity() * 1000) });
+    }
+    if (!m_brushStack.empty() && (!m_hasBrush || (m_brushStack.top() != m_currentBrush))) {
+        m_currentBrush = m_brushStack.top();
+        m_hasBrush = true;
+        AddCommand(BINARY_BRUSH, { m_currentBrush.GetColour(), (int)(m_currentBrush.GetOpacity() * 1000) });
+    }
+    if (!m_fontStack.empty() && (!m_hasFont || (*m_fontStack.top() != m_currentFont))) {
+        m_currentFont = *m_fontStack.top();
+        m_hasFont = true;
+        AddCommand(BINARY_FONT,
+            { m_currentFont.GetPointSize(), m_currentFont.GetStyle(), m_currentFont.GetWeight(),
+                this->GetStringIndex(m_currentFont.GetFaceName()) });
+    }
+}
+
+int BinaryDeviceContext::GetStringIndex(const std::string &str)
+{
+    if (str.empty()) return -1;
+
+    auto iter = m_stringIndexes.find(str);
+    if (iter != m_stringIndexes.end()) return iter->second;
+
+    const int idx = (int)m_strings.size();
+    m_strings.push_back(str);
+    m_stringIndexes.emplace(str, idx);
+    return idx;
+}
+
+void BinaryDeviceContext::AppendValue(std::vector<unsigned char> &output, int value)
+{
+    const unsigned int uValue = (unsigned int)value;
+    output.push_back(uValue & 0xFF);
+    output.push_back((uValue >> 8) & 0xFF);
+    output.push_back((uValue >> 16) & 0xFF);
+    output.push_back((uValue >> 24) & 0xFF);
+}
+
+void BinaryDeviceContext::GetBinary(std::vector<unsigned char> &output)
+{
+    // the glyph paths are added to the string table first because its size is part of the header
+    std::vector<std::pair<int, int>> glyphs;
+    glyphs.reserve(m_glyphs.size());
+    const Resources *resources = this->GetResources(true);
+    for (auto &[code, glyph] : m_glyphs) {
+        const pugi::xml_document *sourceDoc = (resources) ? resources->GetGlyphDefinition(glyph) : NULL;
+        std::string path;
+        if (sourceDoc) {
+            path = sourceDoc->first_child().child("path").attribute("d").value();
+        }
+        glyphs.push_back({ (int)code, this->GetStringIndex(path) });
+    }
+
+    int width = this->GetWidth();
+    int height = this->GetHeight();
+    int contentWidth = width;
+    int contentHeight = height;
+    if (!m_facsimileOutput) {
+        width = (int)(width * this->GetUserScaleX());
+        height = (int)(height * this->GetUserScaleY());
+        contentWidth *= DEFINITION_FACTOR;
+        contentHeight = this->GetContentHeight() * DEFINITION_FACTOR;
+    }
+
+    output.clear();
+    output.reserve(4 * (9 + m_commands.size() + 2 * glyphs.size() + m_strings.size()));
+
+    AppendValue(output, BINARY_MAGIC);
+    AppendValue(output, BINARY_VERSION);
+    AppendValue(output, width);
+    AppendValue(output, height);
+    AppendValue(output, contentWidth);
+    AppendValue(output, contentHeight);
+    AppendValue(output, (int)m_commands.size());
+    AppendValue(output, (int)glyphs.size());
+    AppendValue(output, (int)m_strings.size());
+
+    for (int value : m_commands) {
+        AppendValue(output, value);
+    }
+
+    for (auto &[code, pathIdx] : glyphs) {
+        AppendValue(output, code);
+        AppendValue(output, pathIdx);
+    }
+
+    for (const std::string &str : m_strings) {
+        AppendValue(output, (int)str.size());
+        output.insert(output.end(), str.begin(), str.end());
+        // pad to keep the values aligned
+        output.resize(output.size() + (4 - str.size() % 4) % 4, 0);
+    }
+}
+
+void BinaryDeviceContext::StartGraphic(
+    Object *object, std::string gClass, std::string gId, bool primary, bool prepend)
+{
+    // prepending is used only by the SVG bounding boxes and is ignored here
+    std::string className = object->GetClassName();
+    std::transform(className.begin(), className.begin() + 1, className.begin(), ::tolower);
+    if (!gClass.empty()) className += " " + gClass;
+
+    if (object->HasAttClass(ATT_TYPED)) {
+        AttTyped *att = dynamic_cast<AttTyped *>(object);
+        assert(att);
+        if (att->HasType()) {
+            className += " " + att->GetType();
+        }
+    }
+
+    int colourIdx = -1;
+    if (object->HasAttClass(ATT_COLOR)) {
+        AttColor *att = dynamic_cast<AttColor *>(object);
+        assert(att);
+        if (att->HasColor()) colourIdx = this->GetStringIndex(att->GetColor());
+    }
+
+    AddCommand(BINARY_START_GRAPHIC,
+        { this->GetStringIndex(gId), this->GetStringIndex(className), primary ? 1 : 0, colourIdx });
+}
+
+void BinaryDeviceContext::StartCustomGraphic(std::string name, std::string gClass, std::string gId)
+{
+    if (!gClass.empty()) name += " " + gClass;
+
+    AddCommand(BINARY_START_GRAPHIC, { this->GetStringIndex(gId), this->GetStringIndex(name), 1, -1 });
+}
+
+void BinaryDeviceContext::ResumeGraphic(Object *object, std::string gId)
+{
+    AddCommand(BINARY_RESUME_GRAPHIC, { this->GetStringIndex(gId) });
+}
+
+void BinaryDeviceContext::EndGraphic(Object *object, View *view)
+{
+    AddCommand(BINARY_END_GRAPHIC, {});
+}
+
+void BinaryDeviceContext::EndCustomGraphic()
+{
+    AddCommand(BINARY_END_GRAPHIC, {});
+}
+
+void BinaryDeviceContext::EndResumedGraphic(Object *object, View *view)
+{
+    AddCommand(BINARY_END_GRAPHIC, {});
+}
+
+void BinaryDeviceContext::RotateGraphic(Point const &orig, double angle)
+{
+    AddCommand(BINARY_ROTATE_GRAPHIC, { orig.x, orig.y, (int)(angle * 1000) });
+}
+
+void BinaryDeviceContext::StartPage()
+{
+    AddCommand(BINARY_ORIGIN, { m_originX, m_originY });
+}
+
+void BinaryDeviceContext::DrawQuadBezierPath(Point bezier[3])
+{
+    this->UpdateState();
+    AddPointsCommand(BINARY_QUAD_BEZIER_PATH, 3, bezier, false);
+}
+
+void BinaryDeviceContext::DrawCubicBezierPath(Point bezier[4])
+{
+    this->UpdateState();
+    AddPointsCommand(BINARY_CUBIC_BEZIER_PATH, 4, bezier, false);
+}
+
+void BinaryDeviceContext::DrawCubicBezierPathFilled(Point bezier1[4], Point bezier2[4])
+{
+    this->UpdateState();
+    // both curves go into a single command
+    Point points[8] = { bezier1[0], bezier1[1], bezier1[2], bezier1[3], bezier2[0], bezier2[1], bezier2[2],
+        bezier2[3] };
+    AddPointsCommand(BINARY_CUBIC_BEZIER_PATH_FILLED, 8, points, false);
+}
+
+void BinaryDeviceContext::DrawCircle(int x, int y, int radius)
+{
+    this->UpdateState();
+    AddCommand(BINARY_CIRCLE, { x, y, radius });
+}
+
+void BinaryDeviceContext::DrawEllipse(int x, int y, int width, int height)
+{
+    this->UpdateState();
+    AddCommand(BINARY_ELLIPSE, { x, y, width, height });
+}
+
+void BinaryDeviceContext::DrawEllipticArc(int x, int y, int width, int height, double start, double end)
+{
+    this->UpdateState();
+    AddCommand(BINARY_ELLIPTIC_ARC, { x, y, width, height, (int)(start * 1000), (int)(end * 1000) });
+}
+
+void BinaryDeviceContext::DrawLine(int x1, int y1, int x2, int y2)
+{
+    this->UpdateState();
+    AddCommand(BINARY_LINE, { x1, y1, x2, y2 });
+}
+
+void BinaryDeviceContext::DrawPolyline(int n, Point points[], int xOffset, int yOffset)
+{
+    this->UpdateState();
+    AddPointsCommand(BINARY_POLYLINE, n, points, true, xOffset, yOffset);
+}
+
+void BinaryDeviceContext::DrawPolygon(int n, Point points[], int xOffset, int yOffset)
+{
+    this->UpdateState();
+    AddPointsCommand(BINARY_POLYGON, n, points, true, xOffset, yOffset);
+}
+
+void BinaryDeviceContext::DrawRectangle(int x, int y, int width, int height)
+{
+    this->UpdateState();
+    AddCommand(BINARY_RECTANGLE, { x, y, width, height });
+}
+
+void BinaryDeviceContext::DrawRoundedRectangle(int x, int y, int width, int height, int radius)
+{
+    this->UpdateState();
+    AddCommand(BINARY_ROUNDED_RECTANGLE, { x, y, width, height, radius });
+}
+
+void BinaryDeviceContext::StartText(int x, int y, data_HORIZONTALALIGNMENT alignment)
+{
+    this->UpdateState();
+    AddCommand(BINARY_START_TEXT, { x, y, alignment });
+}
+
+void BinaryDeviceContext::MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignment)
+{
+    AddCommand(BINARY_MOVE_TEXT, { x, y, alignment });
+}
+
+void BinaryDeviceContext::MoveTextVerticallyTo(int y)
+{
+    AddCommand(BINARY_MOVE_TEXT, { VRV_UNSET, y, HORIZONTALALIGNMENT_NONE });
+}
+
+void BinaryDeviceContext::EndText()
+{
+    AddCommand(BINARY_END_TEXT, {});
+}
+
+void BinaryDeviceContext::DrawText(
+    const std::string &text, const std::wstring &wtext, int x, int y, int width, int height)
+{
+    this->UpdateState();
+
+    // the rectangle for syllables has no visible output and is not passed
+    if ((x == 0) || (y == 0) || ((width != 0) && (width != VRV_UNSET) && (height != 0) && (height != VRV_UNSET))) {
+        x = VRV_UNSET;
+        y = VRV_UNSET;
+    }
+    AddCommand(BINARY_TEXT, { this->GetStringIndex(text), x, y });
+}
+
+void BinaryDeviceContext::DrawMusicText(const std::wstring &text, int x, int y, bool setSmuflGlyph)
+{
+    assert(m_fontStack.top());
+
+    const Resources *resources = this->GetResources();
+    assert(resources);
+
+    this->UpdateState();
+
+    int w, h, gx, gy;
+    const int pointSize = m_fontStack.top()->GetPointSize();
+    const int ratio = (int)(m_fontStack.top()->GetWidthToHeightRatio() * 1000);
+
+    // print chars one by one
+    for (unsigned int i = 0; i < text.length(); ++i) {
+        wchar_t c = text.at(i);
+        const Glyph *glyph = resources->GetGlyph(c);
+        if (!glyph) {
+            continue;
+        }
+
+        // Add the glyph to the table appended to the output
+        m_glyphs.emplace(c, glyph);
+
+        AddCommand(BINARY_GLYPH, { (int)c, x, y, pointSize, ratio });
+
+        // Get the bounds of the char
+        if (glyph->GetHorizAdvX() > 0)
+            x += glyph->GetHorizAdvX() * pointSize / glyph->GetUnitsPerEm();
+        else {
+            glyph->GetBoundingBox(gx, gy, w, h);
+            x += w * pointSize / glyph->GetUnitsPerEm();
+        }
+    }
+}
+
+void BinaryDeviceContext::DrawSvgShape(int x, int y, int width, int height, pugi::xml_node svg)
+{
+    std::ostringstream content;
+    for (pugi::xml_node child : svg.children()) {
+        child.print(content, "", pugi::format_raw);
+    }
+    AddCommand(BINARY_SVG_SHAPE, { x, y, width, height, this->GetStringIndex(content.str()) });
+}
+
+} // namespace vrv
@@ -0,0 +1,576 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        displaylistdevicecontext.cpp
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "displaylistdevicecontext.h"
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cassert>
+
+//----------------------------------------------------------------------------
+
+#include "vrv.h"
+
+namespace vrv {
+
+//----------------------------------------------------------------------------
+// DisplayListDeviceContext
+//----------------------------------------------------------------------------
+
+DisplayListDeviceContext::DisplayListDeviceContext(bool useGlobalStyling) : DeviceContext(DISPLAYLIST_DEVICE_CONTEXT)
+{
+    m_useGlobalStyling = useGlobalStyling;
+
+    m_originX = 0;
+    m_originY = 0;
+
+    // Same as in SvgDeviceContext
+    this->SetBrush(AxNONE, AxSOLID);
+    this->SetPen(AxNONE, 1, AxSOLID);
+}
+
+DisplayListDeviceContext::~DisplayListDeviceContext() {}
+
+void DisplayListDeviceContext::AddCommand(Command command)
+{
+    Item item;
+    item.m_command = command;
+    item.m_pen = -1;
+    item.m_brush = -1;
+    item.m_font = -1;
+
+    if (!m_penStack.empty()) {
+        if (m_pens.empty() || (m_pens.back() != m_penStack.top())) m_pens.push_back(m_penStack.top());
+        item.m_pen = (int)m_pens.size() - 1;
+    }
+    if (!m_brushStack.empty()) {
+        if (m_brushes.empty() || (m_brushes.back() != m_brushStack.top())) m_brushes.push_back(m_brushStack.top());
+        item.m_brush = (int)m_brushes.size() - 1;
+    }
+    if (!m_fontStack.empty()) {
+        assert(m_fontStack.top());
+        if (m_fonts.empty() || (m_fonts.back() != *m_fontStack.top())) m_fonts.push_back(*m_fontStack.top());
+        item.m_font = (int)m_fonts.size() - 1;
+    }
+
+    m_commands.push_back(item);
+}
+
+void DisplayListDeviceContext::AddPoints(int n, const Point points[])
+{
+    for (int i = 0; i < n; ++i) {
+        m_ints.push_back(points[i].x);
+        m_ints.push_back(points[i].y);
+    }
+}
+
+Point *DisplayListDeviceContext::ReadPoints(ReplayPosition &position, int n) const
+{
+    position.m_points.resize(n);
+    for (int i = 0; i < n; ++i) {
+        position.m_points[i].x = this->ReadInt(position);
+        position.m_points[i].y = this->ReadInt(position);
+    }
+    return position.m_points.data();
+}
+
+void DisplayListDeviceContext::SetBackground(int colour, int style)
+{
+    this->AddCommand(DL_SET_BACKGROUND);
+    m_ints.push_back(colour);
+    m_ints.push_back(style);
+}
+
+void DisplayListDeviceContext::SetBackgroundImage(void *image, double opacity)
+{
+    this->AddCommand(DL_SET_BACKGROUND_IMAGE);
+    m_images.push_back(image);
+    m_doubles.push_back(opacity);
+}
+
+void DisplayListDeviceContext::SetBackgroundMode(int mode)
+{
+    this->AddCommand(DL_SET_BACKGROUND_MODE);
+    m_ints.push_back(mode);
+}
+
+void DisplayListDeviceContext::SetTextForeground(int colour)
+{
+    this->AddCommand(DL_SET_TEXT_FOREGROUND);
+    m_ints.push_back(colour);
+    // Like SvgDeviceContext, use the brush colour for text so the following primitives get it
+    m_brushStack.top().SetColour(colour);
+}
+
+void DisplayListDeviceContext::SetTextBackground(int colour)
+{
+    this->AddCommand(DL_SET_TEXT_BACKGROUND);
+    m_ints.push_back(colour);
+}
+
+void DisplayListDeviceContext::SetLogicalOrigin(int x, int y)
+{
+    this->AddCommand(DL_SET_LOGICAL_ORIGIN);
+    m_ints.push_back(x);
+    m_ints.push_back(y);
+
+    m_originX = x;
+    m_originY = y;
+}
+
+Point DisplayListDeviceContext::GetLogicalOrigin()
+{
+    return Point(m_originX, m_originY);
+}
+
+void DisplayListDeviceContext::DrawQuadBezierPath(Point bezier[3])
+{
+    this->AddCommand(DL_DRAW_QUAD_BEZIER_PATH);
+    this->AddPoints(3, bezier);
+}
+
+void DisplayListDeviceContext::DrawCubicBezierPath(Point bezier[4])
+{
+    this->AddCommand(DL_DRAW_CUBIC_BEZIER_PATH);
+    this->AddPoints(4, bezier);
+}
+
+void DisplayListDeviceContext::DrawCubicBezierPathFilled(Point bezier1[4], Point bezier2[4])
+{
+    this->AddCommand(DL_DRAW_CUBIC_BEZIER_PATH_FILLED);
+    this->AddPoints(4, bezier1);
+    this->AddPoints(4, bezier2);
+}
+
+void DisplayListDeviceContext::DrawCircle(int x, int y, int radius)
+{
+    this->AddCommand(DL_DRAW_CIRCLE);
+    m_ints.insert(m_ints.end(), { x, y, radius });
+}
+
+void DisplayListDeviceContext::DrawEllipse(int x, int y, int width, int height)
+{
+    this->AddCommand(DL_DRAW_ELLIPSE);
+    m_ints.insert(m_ints.end(), { x, y, width, height });
+}
+
+void DisplayListDeviceContext::DrawEllipticArc(int x, int y, int width, int height, double start, double end)
+{
+    this->AddCommand(DL_DRAW_ELLIPTIC_ARC);
+    m_ints.insert(m_ints.end(), { x, y, width, height });
+    m_doubles.push_back(start);
+    m_doubles.push_back(end);
+}
+
+void DisplayListDeviceContext::DrawLine(int x1, int y1, int x2, int y2)
+{
+    this->AddCommand(DL_DRAW_LINE);
+    m_ints.insert(m_ints.end(), { x1, y1, x2, y2 });
+}
+
+void DisplayListDeviceContext::DrawPolyline(int n, Point points[], int xOffset, int yOffset)
+{
+    this->AddCommand(DL_DRAW_POLYLINE);
+    m_ints.insert(m_ints.end(), { n, xOffset, yOffset });
+    this->AddPoints(n, points);
+}
+
+void DisplayListDeviceContext::DrawPolygon(int n, Point points[], int xOffset, int yOffset)
+{
+    this->AddCommand(DL_DRAW_POLYGON);
+    m_ints.insert(m_ints.end(), { n, xOffset, yOffset });
+    this->AddPoints(n, points);
+}
+
+void DisplayListDeviceContext::DrawRectangle(int x, int y, int width, int height)
+{
+    this->AddCommand(DL_DRAW_RECTANGLE);
+    m_ints.insert(m_ints.end(), { x, y, width, height });
+}
+
+void DisplayListDeviceContext::DrawRotatedText(const std::string &text, int x, int y, double angle)
+{
+    this->AddCommand(DL_DRAW_ROTATED_TEXT);
+    m_strings.push_back(text);
+    m_ints.insert(m_ints.end(), { x, y });
+    m_doubles.push_back(angle);
+}
+
+void DisplayListDeviceContext::DrawRoundedRectangle(int x, int y, int width, int height, int radius)
+{
+    this->AddCommand(DL_DRAW_ROUNDED_RECTANGLE);
+    m_ints.insert(m_ints.end(), { x, y, width, height, radius });
+}
+
+void DisplayListDeviceContext::DrawText(
+    const std::string &text, const std::wstring &wtext, int x, int y, int width, int height)
+{
+    this->AddCommand(DL_DRAW_TEXT);
+    m_strings.push_back(text);
+    m_wstrings.push_back(wtext);
+    m_ints.insert(m_ints.end(), { x, y, width, height });
+}
+
+void DisplayListDeviceContext::DrawMusicText(const std::wstring &text, int x, int y, bool setSmuflGlyph)
+{
+    this->AddCommand(DL_DRAW_MUSIC_TEXT);
+    m_wstrings.push_back(text);
+    m_ints.insert(m_ints.end(), { x, y, setSmuflGlyph });
+}
+
+void DisplayListDeviceContext::DrawSpline(int n, Point points[])
+{
+    this->AddCommand(DL_DRAW_SPLINE);
+    m_ints.push_back(n);
+    this->AddPoints(n, points);
+}
+
+void DisplayListDeviceContext::DrawSvgShape(int x, int y, int width, int height, pugi::xml_node svg)
+{
+    this->AddCommand(DL_DRAW_SVG_SHAPE);
+    m_ints.insert(m_ints.end(), { x, y, width, height });
+    m_svgNodes.push_back(svg);
+}
+
+void DisplayListDeviceContext::DrawBackgroundImage(int x, int y)
+{
+    this->AddCommand(DL_DRAW_BACKGROUND_IMAGE);
+    m_ints.insert(m_ints.end(), { x, y });
+}
+
+void DisplayListDeviceContext::DrawPlaceholder(int x, int y)
+{
+    this->AddCommand(DL_DRAW_PLACEHOLDER);
+    m_ints.insert(m_ints.end(), { x, y });
+}
+
+void DisplayListDeviceContext::StartText(int x, int y, data_HORIZONTALALIGNMENT alignment)
+{
+    this->AddCommand(DL_START_TEXT);
+    m_ints.insert(m_ints.end(), { x, y, alignment });
+}
+
+void DisplayListDeviceContext::EndText()
+{
+    this->AddCommand(DL_END_TEXT);
+}
+
+void DisplayListDeviceContext::MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignment)
+{
+    this->AddCommand(DL_MOVE_TEXT_TO);
+    m_ints.insert(m_ints.end(), { x, y, alignment });
+}
+
+void DisplayListDeviceContext::MoveTextVerticallyTo(int y)
+{
+    this->AddCommand(DL_MOVE_TEXT_VERTICALLY_TO);
+    m_ints.push_back(y);
+}
+
+void DisplayListDeviceContext::StartGraphic(
+    Object *object, std::string gClass, std::string gId, bool primary, bool prepend)
+{
+    this->AddCommand(DL_START_GRAPHIC);
+    m_objects.push_back(object);
+    m_strings.push_back(gClass);
+    m_strings.push_back(gId);
+    m_ints.insert(m_ints.end(), { primary, prepend });
+}
+
+void DisplayListDeviceContext::EndGraphic(Object *object, View *view)
+{
+    this->AddCommand(DL_END_GRAPHIC);
+    m_objects.push_back(object);
+    m_views.push_back(view);
+}
+
+void DisplayListDeviceContext::StartCustomGraphic(std::string name, std::string gClass, std::string gId)
+{
+    this->AddCommand(DL_START_CUSTOM_GRAPHIC);
+    m_strings.push_back(name);
+    m_strings.push_back(gClass);
+    m_strings.push_back(gId);
+}
+
+void DisplayListDeviceContext::EndCustomGraphic()
+{
+    this->AddCommand(DL_END_CUSTOM_GRAPHIC);
+}
+
+void DisplayListDeviceContext::ResumeGraphic(Object *object, std::string gId)
+{
+    this->AddCommand(DL_RESUME_GRAPHIC);
+    m_objects.push_back(object);
+    m_strings.push_back(gId);
+}
+
+void DisplayListDeviceContext::EndResumedGraphic(Object *object, View *view)
+{
+    this->AddCommand(DL_END_RESUMED_GRAPHIC);
+    m_objects.push_back(object);
+    m_views.push_back(view);
+}
+
+void DisplayListDeviceContext::StartTextGraphic(Object *object, std::string gClass, std::string gId)
+{
+    this->AddCommand(DL_START_TEXT_GRAPHIC);
+    m_objects.push_back(object);
+    m_strings.push_back(gClass);
+    m_strings.push_back(gId);
+}
+
+void DisplayListDeviceContext::EndTextGraphic(Object *object, View *view)
+{
+    this->AddCommand(DL_END_TEXT_GRAPHIC);
+    m_objects.push_back(object);
+    m_views.push_back(view);
+}
+
+void DisplayListDeviceContext::RotateGraphic(Point const &orig, double angle)
+{
+    this->AddCommand(DL_ROTATE_GRAPHIC);
+    this->AddPoints(1, &orig);
+    m_doubles.push_back(angle);
+}
+
+void DisplayListDeviceContext::StartPage()
+{
+    this->AddCommand(DL_START_PAGE);
+}
+
+void DisplayListDeviceContext::EndPage()
+{
+    this->AddCommand(DL_END_PAGE);
+}
+
+void DisplayListDeviceContext::AddDescription(const std::string &text)
+{
+    this->AddCommand(DL_ADD_DESCRIPTION);
+    m_strings.push_back(text);
+}
+
+void DisplayListDeviceContext::Replay(DeviceContext *target) const
+{
+    assert(target);
+    assert(target->UseGlobalStyling() == m_useGlobalStyling);
+
+    // Set by the View before drawing the page
+    target->SetContentHeight(this->GetContentHeight());
+
+    ReplayPosition position;
+    for (const Item &item : m_commands) {
+        if (item.m_pen != -1) target->m_penStack.push(m_pens.at(item.m_pen));
+        if (item.m_brush != -1) target->m_brushStack.push(m_brushes.at(item.m_brush));
+        if (item.m_font != -1) target->m_fontStack.push(&m_fonts.at(item.m_font));
+
+        this->ReplayCommand(item.m_command, target, position);
+
+        if (item.m_font != -1) target->m_fontStack.pop();
+        if (item.m_brush != -1) target->m_brushStack.pop();
+        if (item.m_pen != -1) target->m_penStack.pop();
+    }
+
+    assert(position.m_int == (int)m_ints.size());
+    assert(position.m_string == (int)m_strings.size());
+}
+
+void DisplayListDeviceContext::ReplayCommand(Command command, DeviceContext *target, ReplayPosition &position) const
+{
+    // The arguments are read in separate statements because the evaluation order of function arguments is unspecified
+    switch (command) {
+        case DL_SET_BACKGROUND: {
+            const int colour = this->ReadInt(position);
+            const int style = this->ReadInt(position);
+            target->SetBackground(colour, style);
+            break;
+        }
+        case DL_SET_BACKGROUND_IMAGE: {
+            void *image = this->ReadImage(position);
+            target->SetBackgroundImage(image, this->ReadDouble(position));
+            break;
+        }
+        case DL_SET_BACKGROUND_MODE: target->SetBackgroundMode(this->ReadInt(position)); break;
+        case DL_SET_TEXT_FOREGROUND: target->SetTextForeground(this->ReadInt(position)); break;
+        case DL_SET_TEXT_BACKGROUND: target->SetTextBackground(this->ReadInt(position)); break;
+        case DL_SET_LOGICAL_ORIGIN: {
+            const int x = this->ReadInt(position);
+            const int y = this->ReadInt(position);
+            target->SetLogicalOrigin(x, y);
+            break;
+        }
+        case DL_DRAW_QUAD_BEZIER_PATH: target->DrawQuadBezierPath(this->ReadPoints(position, 3)); break;
+        case DL_DRAW_CUBIC_BEZIER_PATH: target->DrawCubicBezierPath(this->ReadPoints(position, 4)); break;
+        case DL_DRAW_CUBIC_BEZIER_PATH_FILLED: {
+            Point bezier1[4];
+            std::copy_n(this->ReadPoints(position, 4), 4, bezier1);
+            target->DrawCubicBezierPathFilled(bezier1, this->ReadPoints(position, 4));
+            break;
+        }
+        case DL_DRAW_CIRCLE: {
+            const int x = this->ReadInt(position);
+            const int y = this->ReadInt(position);
+            target->DrawCircle(x, y, this->ReadInt(position));
+            break;
+        }
+        case DL_DRAW_ELLIPSE:
+        case DL_DRAW_ELLIPTIC_ARC:
+        case DL_DRAW_RECTANGLE:
+        case DL_DRAW_ROUNDED_RECTANGLE:
+        case DL_DRAW_SVG_SHAPE: {
+            const int x = this->ReadInt(position);
+            const int y = this->ReadInt(position);
+            const int width = this->ReadInt(position);
+            const int height = this->ReadInt(position);
+            if (command == DL_DRAW_ELLIPSE) {
+                target->DrawEllipse(x, y, width, height);
+            }
+            else if (command == DL_DRAW_ELLIPTIC_ARC) {
+                const double start = this->ReadDouble(position);
+                target->DrawEllipticArc(x, y, width, height, start, this->ReadDouble(position));
+            }
+            else if (command == DL_DRAW_RECTANGLE) {
+                target->DrawRectangle(x, y, width, height);
+            }
+            else if (command == DL_DRAW_ROUNDED_RECTANGLE) {
+                target->DrawRoundedRectangle(x, y, width, height, this->ReadInt(position));
+            }
+            else {
+                target->DrawSvgShape(x, y, width, height, this->ReadSvgNode(position));
+            }
+            break;
+        }
+        case DL_DRAW_LINE: {
+            const int x1 = this->ReadInt(position);
+            const int y1 = this->ReadInt(position);
+            const int x2 = this->ReadInt(position);
+            target->DrawLine(x1, y1, x2, this->ReadInt(position));
+            break;
+        }
+        case DL_DRAW_POLYLINE:
+        case DL_DRAW_POLYGON: {
+            const int n = this->ReadInt(position);
+            const int xOffset = this->ReadInt(position);
+            const int yOffset = this->ReadInt(position);
+            Point *points = this->ReadPoints(position, n);
+            if (command == DL_DRAW_POLYLINE) {
+                target->DrawPolyline(n, points, xOffset, yOffset);
+            }
+            else {
+                target->DrawPolygon(n, points, xOffset, yOffset);
+            }
+            break;
+        }
+        case DL_DRAW_ROTATED_TEXT: {
+            const std::string &text = this->ReadString(position);
+            const int x = this->ReadInt(position);
+            const int y = this->ReadInt(position);
+            target->DrawRotatedText(text, x, y, this->ReadDouble(position));
+            break;
+        }
+        case DL_DRAW_TEXT: {
+            const std::string &text = this->ReadString(position);
+            const std::wstring &wtext = this->ReadWString(position);
+            const int x = this->ReadInt(position);
+            const int y = this->ReadInt(position);
+            const int width = this->ReadInt(position);
+            target->DrawText(text, wtext, x, y, width, this->ReadInt(position));
+            break;
+        }
+        case DL_DRAW_MUSIC_TEXT: {
+            const std::wstring &text = this->ReadWString(position);
+            const int x = this->ReadInt(position);
+            const int y = this->ReadInt(position);
+            target->DrawMusicText(text, x, y, this->ReadInt(position));
+            break;
+        }
+        case DL_DRAW_SPLINE: {
+            const int n = this->ReadInt(position);
+            target->DrawSpline(n, this->ReadPoints(position, n));
+            break;
+        }
+        case DL_DRAW_BACKGROUND_IMAGE:
+        case DL_DRAW_PLACEHOLDER: {
+            const int x = this->ReadInt(position);
+            const int y = this->ReadInt(position);
+            if (command == DL_DRAW_BACKGROUND_IMAGE) {
+                target->DrawBackgroundImage(x, y);
+            }
+            else {
+                target->DrawPlaceholder(x, y);
+            }
+            break;
+        }
+        case DL_START_TEXT:
+        case DL_MOVE_TEXT_TO: {
+            const int x = this->ReadInt(position);
+            const int y = this->ReadInt(position);
+            const data_HORIZONTALALIGNMENT alignment = (data_HORIZONTALALIGNMENT)this->ReadInt(position);
+            if (command == DL_START_TEXT) {
+                target->StartText(x, y, alignment);
+            }
+            else {
+                target->MoveTextTo(x, y, alignment);
+            }
+            break;
+        }
+        case DL_END_TEXT: target->EndText(); break;
+        case DL_MOVE_TEXT_VERTICALLY_TO: target->MoveTextVerticallyTo(this->ReadInt(position)); break;
+        case DL_START_GRAPHIC: {
+            Object *object = this->ReadObject(position);
+            const std::string &gClass = this->ReadString(position);
+            const std::string &gId = this->ReadString(position);
+            const bool primary = this->ReadInt(position);
+            target->StartGraphic(object, gClass, gId, primary, this->ReadInt(position));
+            break;
+        }
+        case DL_END_GRAPHIC: {
+            Object *object = this->ReadObject(position);
+            target->EndGraphic(object, this->ReadView(position));
+            break;
+        }
+        case DL_START_CUSTOM_GRAPHIC: {
+            const std::string &name = this->ReadString(position);
+            const std::string &gClass = this->ReadString(position);
+            target->StartCustomGraphic(name, gClass, this->ReadString(position));
+            break;
+        }
+        case DL_END_CUSTOM_GRAPHIC: target->EndCustomGraphic(); break;
+        case DL_RESUME_GRAPHIC: {
+            Object *object = this->ReadObject(position);
+            target->ResumeGraphic(object, this->ReadString(position));
+            break;
+        }
+        case DL_END_RESUMED_GRAPHIC: {
+            Object *object = this->ReadObject(position);
+            target->EndResumedGraphic(object, this->ReadView(position));
+            break;
+        }
+        case DL_START_TEXT_GRAPHIC: {
+            Object *object = this->ReadObject(position);
+            const std::string &gClass = this->ReadString(position);
+            target->StartTextGraphic(object, gClass, this->ReadString(position));
+            break;
+        }
+        case DL_END_TEXT_GRAPHIC: {
+            Object *object = this->ReadObject(position);
+            target->EndTextGraphic(object, this->ReadView(position));
+            break;
+        }
+        case DL_ROTATE_GRAPHIC: {
+            const Point orig = *this->ReadPoints(position, 1);
+            target->RotateGraphic(orig, this->ReadDouble(position));
+            break;
+        }
+        case DL_START_PAGE: target->StartPage(); break;
+        case DL_END_PAGE: target->EndPage(); break;
+        case DL_ADD_DESCRIPTION: target->AddDescription(this->ReadString(position)); break;
+        default: assert(false);
+    }
+}
+
+} // namespace vrv
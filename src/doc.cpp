@@ -9,9 +9,16 @@
 
 //----------------------------------------------------------------------------
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 #include <math.h>
 
+#ifndef NO_MULTITHREADING
+#include <atomic>
+#include <thread>
+#endif
+
 //----------------------------------------------------------------------------
 
 #include "barline.h"
@@ -56,6 +63,7 @@
 #include "syllable.h"
 #include "system.h"
 #include "text.h"
+#include "tie.h"
 #include "timemap.h"
 #include "timestamp.h"
 #include "transposition.h"
@@ -83,6 +91,8 @@ Doc::Doc() : Object(DOC, "doc-")
     m_selectionPreceeding = NULL;
     m_selectionFollowing = NULL;
 
+    m_layoutGeneration = 0;
+
     this->Reset();
 }
 
@@ -121,10 +131,12 @@ void Doc::Reset()
     m_currentScore = NULL;
     m_currentScoreDefDone = false;
     m_dataPreparationDone = false;
-    m_timemapTempo = 0.0;
+    ++m_layoutGeneration;
+    this->ResetTimemap();
     m_markup = MARKUP_DEFAULT;
     m_isMensuralMusicOnly = false;
     m_isCastOff = false;
+    m_castOffCache.clear();
 
     m_facsimile = NULL;
 
@@ -267,12 +279,37 @@ bool Doc::GenerateMeasureNumbers()
 
 bool Doc::HasTimemap() const
 {
-    return (m_timemapTempo == m_options->m_midiTempoAdjustment.GetValue());
+    return (m_timemapTempo == m_options->m_midiTempoAdjustment.GetValue())
+        && m_timemapState.m_editedMeasures.empty();
 }
 
-void Doc::CalculateTimemap()
+void Doc::ResetTimemap()
 {
     m_timemapTempo = 0.0;
+    m_timemapIndex.m_measures.clear();
+    m_timemapIndex.m_notesOrRests.clear();
+    m_timemapIndex.m_elements.clear();
+    m_timemapIndex.m_elementIndexes.clear();
+    m_timemapState.m_measures.clear();
+    m_timemapState.m_editedMeasures.clear();
+}
+
+void Doc::InvalidateTimemap(const Measure *measure)
+{
+    assert(measure);
+
+    // Nothing to do if the timemap needs to be fully calculated anyway
+    if (m_timemapState.m_measures.empty()) return;
+
+    m_timemapState.m_editedMeasures.insert(measure);
+}
+
+void Doc::CalculateTimemap()
+{
+    // Recalculate only what changed when the timemap was calculated before
+    if (!m_timemapState.m_measures.empty() && this->UpdateTimemap()) return;
+
+    this->ResetTimemap();
 
     // This happens if the document was never cast off (breaks none option in the toolkit)
     if (!m_drawingPage && this->GetPageCount() == 1) {
@@ -295,24 +332,296 @@ void Doc::CalculateTimemap()
     InitMaxMeasureDurationParams initMaxMeasureDurationParams;
     initMaxMeasureDurationParams.m_currentTempo = tempo;
     initMaxMeasureDurationParams.m_tempoAdjustment = m_options->m_midiTempoAdjustment.GetValue();
+    initMaxMeasureDurationParams.m_timemapState = &m_timemapState;
     Functor initMaxMeasureDuration(&Object::InitMaxMeasureDuration);
     Functor initMaxMeasureDurationEnd(&Object::InitMaxMeasureDurationEnd);
-    this->Process(&initMaxMeasureDuration, &initMaxMeasureDurationParams, &initMaxMeasureDurationEnd);
+    if (m_expansionMap.HasTimeline()) {
+        // The measures not in the timeline are left without any pass, as not played
+        ListOfObjects measures = this->FindAllDescendantsByType(MEASURE, false);
+        for (Object *object : measures) {
+            vrv_cast<Measure *>(object)->ResetTimeOffsets();
+        }
+        // With an expanded timeline, the measures are processed in its order, once for each of their pass
+        this->ProcessTimeline(&initMaxMeasureDuration, &initMaxMeasureDurationParams, &initMaxMeasureDurationEnd, NULL,
+            initMaxMeasureDurationParams.m_repeat);
+    }
+    else {
+        this->Process(&initMaxMeasureDuration, &initMaxMeasureDurationParams, &initMaxMeasureDurationEnd);
+    }
 
     // Then calculate the onset and offset times (w.r.t. the measure) for every note
-    InitOnsetOffsetParams initOnsetOffsetParams;
     Functor initOnsetOffset(&Object::InitOnsetOffset);
     Functor initOnsetOffsetEnd(&Object::InitOnsetOffsetEnd);
-    this->Process(&initOnsetOffset, &initOnsetOffsetParams, &initOnsetOffsetEnd);
+    if (m_expansionMap.HasTimeline()) {
+        // Only the measures played are processed
+        for (TimemapState::MeasureState &state : m_timemapState.m_measures) {
+            InitOnsetOffsetParams initOnsetOffsetParams;
+            state.m_measure->Process(&initOnsetOffset, &initOnsetOffsetParams, &initOnsetOffsetEnd);
+        }
+    }
+    else {
+        InitOnsetOffsetParams initOnsetOffsetParams;
+        this->Process(&initOnsetOffset, &initOnsetOffsetParams, &initOnsetOffsetEnd);
+    }
 
     // Adjust the duration of tied notes
     Functor initTimemapTies(&Object::InitTimemapTies);
     this->Process(&initTimemapTies, NULL, NULL, NULL, UNLIMITED_DEPTH, BACKWARD);
 
+    this->CalculateTimemapIndex(std::vector<bool>(m_timemapState.m_measures.size(), true));
+
     m_timemapTempo = m_options->m_midiTempoAdjustment.GetValue();
 }
 
-void Doc::ExportMIDI(smf::MidiFile *midiFile, MidiExt *midiExt)
+bool Doc::UpdateTimemap()
+{
+    // The measures are not in score order with an expanded timeline
+    if (m_expansionMap.HasTimeline()) return false;
+
+    std::vector<TimemapState::MeasureState> &states = m_timemapState.m_measures;
+    const int measureCount = (int)states.size();
+    const double tempoAdjustment = m_options->m_midiTempoAdjustment.GetValue();
+
+    // Look for the first measure to recalculate, which is the first one of the score if the tempo adjustment changed
+    int first = (m_timemapTempo == tempoAdjustment) ? measureCount : 0;
+    std::vector<bool> updatedMeasures(measureCount, false);
+    int editedCount = 0;
+    for (int i = 0; i < measureCount; ++i) {
+        if (m_timemapState.m_editedMeasures.count(states.at(i).m_measure) == 0) continue;
+        updatedMeasures.at(i) = true;
+        first = std::min(first, i);
+        ++editedCount;
+    }
+    if (editedCount != (int)m_timemapState.m_editedMeasures.size()) return false;
+
+    // Recalculate the duration and the tempo of the measures from the first one, starting with its state. This also
+    // updates the offsets of the following ones.
+    std::vector<Measure *> measures;
+    std::vector<double> previousTempos;
+    for (int i = first; i < measureCount; ++i) {
+        measures.push_back(states.at(i).m_measure);
+        previousTempos.push_back(states.at(i).m_measure->GetCurrentTempo());
+    }
+    InitMaxMeasureDurationParams initMaxMeasureDurationParams;
+    if (first < measureCount) {
+        initMaxMeasureDurationParams.m_currentScoreTime = states.at(first).m_measure->GetLastTimeOffset();
+        initMaxMeasureDurationParams.m_currentRealTimeSeconds = states.at(first).m_realTimeSeconds;
+        initMaxMeasureDurationParams.m_currentTempo = states.at(first).m_tempo;
+    }
+    initMaxMeasureDurationParams.m_tempoAdjustment = tempoAdjustment;
+    initMaxMeasureDurationParams.m_timemapState = &m_timemapState;
+    states.resize(first);
+    Functor initMaxMeasureDuration(&Object::InitMaxMeasureDuration);
+    Functor initMaxMeasureDurationEnd(&Object::InitMaxMeasureDurationEnd);
+    for (Measure *measure : measures) {
+        measure->Process(&initMaxMeasureDuration, &initMaxMeasureDurationParams, &initMaxMeasureDurationEnd);
+    }
+    assert((int)states.size() == measureCount);
+
+    // Then recalculate the onset and offset times of the edited measures and of the ones with a tempo changed
+    Functor initOnsetOffset(&Object::InitOnsetOffset);
+    Functor initOnsetOffsetEnd(&Object::InitOnsetOffsetEnd);
+    for (int i = first; i < measureCount; ++i) {
+        Measure *measure = states.at(i).m_measure;
+        if (measure->GetCurrentTempo() != previousTempos.at(i - first)) updatedMeasures.at(i) = true;
+        if (!updatedMeasures.at(i)) continue;
+        InitOnsetOffsetParams initOnsetOffsetParams;
+        measure->Process(&initOnsetOffset, &initOnsetOffsetParams, &initOnsetOffsetEnd);
+    }
+
+    // Adjust again the duration of tied notes if some content changed
+    if (editedCount > 0) {
+        Functor initTimemapTies(&Object::InitTimemapTies);
+        for (auto iter = states.rbegin(); iter != states.rend(); ++iter) {
+            iter->m_measure->Process(&initTimemapTies, NULL, NULL, NULL, UNLIMITED_DEPTH, BACKWARD);
+        }
+    }
+
+    this->CalculateTimemapIndex(updatedMeasures);
+
+    m_timemapState.m_editedMeasures.clear();
+    m_timemapTempo = tempoAdjustment;
+
+    return true;
+}
+
+void Doc::CalculateTimemapIndex(const std::vector<bool> &updatedMeasures)
+{
+    assert(updatedMeasures.size() == m_timemapState.m_measures.size());
+
+    m_timemapIndex.m_measures.clear();
+    m_timemapIndex.m_notesOrRests.resize(m_timemapState.m_measures.size());
+
+    ClassIdsComparison matchNotesOrRests({ NOTE, REST });
+    for (int i = 0; i < (int)m_timemapState.m_measures.size(); ++i) {
+        Measure *measure = m_timemapState.m_measures.at(i).m_measure;
+
+        // The notes and rests are stored once for all the repeats of the measure
+        if (updatedMeasures.at(i)) {
+            TimemapIndex::MeasureNotesOrRests &measureNotesOrRests = m_timemapIndex.m_notesOrRests.at(i);
+            measureNotesOrRests.m_entries.clear();
+            measureNotesOrRests.m_maxDuration = 0.0;
+            ListOfObjects notesOrRests;
+            measure->FindAllDescendantsByComparison(&notesOrRests, &matchNotesOrRests);
+            for (Object *noteOrRest : notesOrRests) {
+                const DurationInterface *interface = noteOrRest->GetDurationInterface();
+                assert(interface);
+                const double onset = interface->GetRealTimeOnsetMilliseconds();
+                const double offset = interface->GetRealTimeOffsetMilliseconds();
+                const int order = (int)measureNotesOrRests.m_entries.size();
+                measureNotesOrRests.m_entries.push_back({ onset, offset, order, noteOrRest });
+                measureNotesOrRests.m_maxDuration = std::max(measureNotesOrRests.m_maxDuration, offset - onset);
+            }
+            std::stable_sort(measureNotesOrRests.m_entries.begin(), measureNotesOrRests.m_entries.end(),
+                [](const TimemapIndex::NoteOrRestEntry &a, const TimemapIndex::NoteOrRestEntry &b) {
+                    return (a.m_onset < b.m_onset);
+                });
+        }
+        const int notesOrRestsIdx = i;
+
+        for (int repeat = 1; repeat <= measure->GetRealTimeRepeatCount(); ++repeat) {
+            const double onset = measure->GetRealTimeOffsetMilliseconds(repeat);
+            const double duration = measure->GetRealTimeDurationMilliseconds(repeat);
+            const double realTimeFactor = measure->GetCurrentTempo() / measure->GetCurrentTempo(repeat);
+            m_timemapIndex.m_measures.push_back(
+                { onset, onset + duration, 0.0, measure, repeat, notesOrRestsIdx, realTimeFactor });
+        }
+    }
+
+    // Sort the measures by onset and set the maximum offset so far
+    std::stable_sort(m_timemapIndex.m_measures.begin(), m_timemapIndex.m_measures.end(),
+        [](const TimemapIndex::MeasureEntry &a, const TimemapIndex::MeasureEntry &b) {
+            return (a.m_onset < b.m_onset);
+        });
+    double maxOffset = VRV_UNSET;
+    for (TimemapIndex::MeasureEntry &entry : m_timemapIndex.m_measures) {
+        maxOffset = std::max(maxOffset, entry.m_offset);
+        entry.m_maxOffset = maxOffset;
+    }
+
+    this->CalculateTimemapElements(updatedMeasures);
+}
+
+void Doc::CalculateTimemapElements(const std::vector<bool> &updatedMeasures)
+{
+    m_timemapIndex.m_elements.resize(m_timemapState.m_measures.size());
+
+    std::vector<const TimemapIndex::NoteOrRestEntry *> entries;
+    for (int i = 0; i < (int)m_timemapState.m_measures.size(); ++i) {
+        if (!updatedMeasures.at(i)) continue;
+        Measure *measure = m_timemapState.m_measures.at(i).m_measure;
+
+        // Remove the elements previously in the measure from the index
+        std::vector<TimemapIndex::ElementEntry> &elements = m_timemapIndex.m_elements.at(i);
+        for (const TimemapIndex::ElementEntry &element : elements) {
+            m_timemapIndex.m_elementIndexes.erase(element.m_id);
+        }
+        elements.clear();
+
+        // The entries are sorted by onset in the index and are put back in score order
+        const TimemapIndex::MeasureNotesOrRests &notesOrRests = m_timemapIndex.m_notesOrRests.at(i);
+        entries.resize(notesOrRests.m_entries.size());
+        for (const TimemapIndex::NoteOrRestEntry &entry : notesOrRests.m_entries) entries[entry.m_order] = &entry;
+
+        auto addElement = [this, measure, i, &elements](Object *object, double onset, double offset) {
+            m_timemapIndex.m_elementIndexes[object->GetID()] = { i, (int)elements.size() };
+            elements.push_back({ object, measure, onset, offset, object->GetID() });
+        };
+        Chord *lastChord = NULL;
+        int lastChordIdx = VRV_UNSET;
+        for (const TimemapIndex::NoteOrRestEntry *entry : entries) {
+            Chord *chord = (entry->m_object->Is(NOTE)) ? vrv_cast<Note *>(entry->m_object)->IsChordTone() : NULL;
+            if (chord && (chord != lastChord)) {
+                lastChord = chord;
+                lastChordIdx = (int)elements.size();
+                addElement(chord, entry->m_onset, entry->m_offset);
+            }
+            addElement(entry->m_object, entry->m_onset, entry->m_offset);
+            if (!chord) continue;
+            // A chord is played from the onset of its first note to the offset of its last one
+            TimemapIndex::ElementEntry &chordEntry = elements.at(lastChordIdx);
+            chordEntry.m_onset = std::min(chordEntry.m_onset, entry->m_onset);
+            chordEntry.m_offset = std::max(chordEntry.m_offset, entry->m_offset);
+        }
+    }
+}
+
+const TimemapIndex::MeasureEntry *Doc::FindMeasureAtTime(int millisec) const
+{
+    // The first measure with a maximum offset reaching the time is the first one ending after it
+    auto iter = std::lower_bound(m_timemapIndex.m_measures.begin(), m_timemapIndex.m_measures.end(), millisec,
+        [](const TimemapIndex::MeasureEntry &entry, int time) { return (entry.m_maxOffset < time); });
+    if ((iter == m_timemapIndex.m_measures.end()) || (iter->m_onset > millisec)) return NULL;
+    return &(*iter);
+}
+
+void Doc::FindMeasuresInTimeRange(
+    int startMillisec, int endMillisec, std::vector<const TimemapIndex::MeasureEntry *> &measures) const
+{
+    auto iter = std::lower_bound(m_timemapIndex.m_measures.begin(), m_timemapIndex.m_measures.end(), startMillisec,
+        [](const TimemapIndex::MeasureEntry &entry, int time) { return (entry.m_maxOffset < time); });
+    for (; (iter != m_timemapIndex.m_measures.end()) && (iter->m_onset <= endMillisec); ++iter) {
+        if (iter->m_offset >= startMillisec) measures.push_back(&(*iter));
+    }
+}
+
+const TimemapIndex::ElementEntry *Doc::FindElementTimes(const std::string &id) const
+{
+    auto iter = m_timemapIndex.m_elementIndexes.find(id);
+    if (iter == m_timemapIndex.m_elementIndexes.end()) return NULL;
+    return &m_timemapIndex.m_elements.at(iter->second.first).at(iter->second.second);
+}
+
+TimemapIndex::ElementTimes Doc::GetElementTimes(const TimemapIndex::ElementEntry *element, int repeat) const
+{
+    assert(element);
+
+    // The times are relative to the measure and scaled when the pass is played with another tempo than the first one
+    const Measure *measure = element->m_measure;
+    const double onset = measure->GetRealTimeOffsetMilliseconds(repeat);
+    const double realTimeFactor = measure->GetCurrentTempo() / measure->GetCurrentTempo(repeat);
+    return { onset + element->m_onset * realTimeFactor, onset + element->m_offset * realTimeFactor };
+}
+
+void Doc::FindNotesOrRestsAtTime(
+    const TimemapIndex::MeasureEntry *measureEntry, int millisec, ListOfObjects &notesOrRests) const
+{
+    assert(measureEntry);
+
+    std::vector<const TimemapIndex::NoteOrRestEntry *> entries;
+    this->FindNotesOrRestsInTimeRange(measureEntry, millisec, millisec, entries);
+    for (const TimemapIndex::NoteOrRestEntry *entry : entries) {
+        notesOrRests.push_back(entry->m_object);
+    }
+}
+
+void Doc::FindNotesOrRestsInTimeRange(const TimemapIndex::MeasureEntry *measureEntry, int startMillisec,
+    int endMillisec, std::vector<const TimemapIndex::NoteOrRestEntry *> &notesOrRests) const
+{
+    assert(measureEntry);
+
+    const TimemapIndex::MeasureNotesOrRests &measureNotesOrRests
+        = m_timemapIndex.m_notesOrRests.at(measureEntry->m_notesOrRestsIdx);
+    // The times of the notes and rests are relative to the measure offset in whole milliseconds
+    const int measureOffset = (int)measureEntry->m_onset;
+    const double startTime = (startMillisec - measureOffset) / measureEntry->m_realTimeFactor;
+    const double endTime = (endMillisec - measureOffset) / measureEntry->m_realTimeFactor;
+
+    // Only the notes and rests starting within the longest duration before the range can be played in it
+    const double minOnset = startTime - measureNotesOrRests.m_maxDuration - 1.0;
+    auto iter = std::lower_bound(measureNotesOrRests.m_entries.begin(), measureNotesOrRests.m_entries.end(),
+        minOnset, [](const TimemapIndex::NoteOrRestEntry &entry, double time) { return (entry.m_onset < time); });
+    const size_t first = notesOrRests.size();
+    for (; (iter != measureNotesOrRests.m_entries.end()) && (iter->m_onset <= endTime); ++iter) {
+        if (iter->m_offset >= startTime) notesOrRests.push_back(&(*iter));
+    }
+    std::sort(notesOrRests.begin() + first, notesOrRests.end(),
+        [](const TimemapIndex::NoteOrRestEntry *a, const TimemapIndex::NoteOrRestEntry *b) {
+            return (a->m_order < b->m_order);
+        });
+}
+
+void Doc::ExportMIDI(smf::MidiFile *midiFile, MidiExt *midiExt, const MIDIChunk *chunk, MidiStream *midiStream)
 {
 
     if (!Doc::HasTimemap()) {
@@ -329,6 +638,8 @@ void Doc::ExportMIDI(smf::MidiFile *midiFile, MidiExt *midiExt)
     if (this->GetCurrentScoreDef()->HasMidiBpm()) {
         tempo = this->GetCurrentScoreDef()->GetMidiBpm();
     }
+    // A chunk starts with the tempo of its first measure
+    if (chunk) tempo = chunk->m_tempo;
     midiFile->addTempo(0, 0, tempo);
 
     // Capture information for MIDI generation, i.e. from control elements
@@ -359,20 +670,27 @@ void Doc::ExportMIDI(smf::MidiFile *midiFile, MidiExt *midiExt)
     int midiChannel = 0;
     int midiTrack = 1;
     int layerIndex = 0;
-    Filters filters;
+    ScoreDef *currentScoreDef = this->GetCurrentScoreDef();
+    std::vector<MIDIStaffExport> staffExports;
     for (staves = initProcessingListsParams.m_layerTree.child.begin();
          staves != initProcessingListsParams.m_layerTree.child.end(); ++staves) {
 
-        ScoreDef *currentScoreDef = this->GetCurrentScoreDef();
-        int transSemi = 0;
+        MIDIStaffExport &staffExport = staffExports.emplace_back();
+        staffExport.m_staffN = staves->first;
+        staffExport.m_layerIndex = layerIndex;
+        for (layers = staves->second.child.begin(); layers != staves->second.child.end(); ++layers, ++layerIndex) {
+            staffExport.m_layerNs.push_back(layers->first);
+        }
+
         if (StaffDef *staffDef = currentScoreDef->GetStaffDef(staves->first)) {
+            staffExport.m_staffDef = staffDef;
             // get the transposition (semi-tone) value for the staff
-            if (staffDef->HasTransSemi()) transSemi = staffDef->GetTransSemi();
+            if (staffDef->HasTransSemi()) staffExport.m_transSemi = staffDef->GetTransSemi();
             midiTrack = staffDef->GetN();
             if (midiFile->getTrackCount() < (midiTrack + 1)) {
                 midiFile->addTracks(midiTrack + 1 - midiFile->getTrackCount());
             }
-            // set MIDI channel and instrument
+            // set MIDI channel and track
             InstrDef *instrdef = dynamic_cast<InstrDef *>(staffDef->FindDescendantByType(INSTRDEF, 1));
             if (!instrdef) {
                 StaffGrp *staffGrp = vrv_cast<StaffGrp *>(staffDef->GetFirstAncestor(STAFFGRP));
@@ -380,6 +698,7 @@ void Doc::ExportMIDI(smf::MidiFile *midiFile, MidiExt *midiExt)
                 instrdef = dynamic_cast<InstrDef *>(staffGrp->FindDescendantByType(INSTRDEF, 1));
             }
             if (instrdef) {
+                staffExport.m_instrDef = instrdef;
                 if (instrdef->HasMidiChannel()) midiChannel = instrdef->GetMidiChannel();
                 if (instrdef->HasMidiTrack()) {
                     midiTrack = instrdef->GetMidiTrack();
@@ -390,80 +709,303 @@ void Doc::ExportMIDI(smf::MidiFile *midiFile, MidiExt *midiExt)
                         LogWarning("A high MIDI track number was assigned to staff %d", staffDef->GetN());
                     }
                 }
-                if (instrdef->HasMidiInstrnum()) {
-                    midiFile->addPatchChange(midiTrack, 0, midiChannel, instrdef->GetMidiInstrnum());
+            }
+        }
+        staffExport.m_midiTrack = midiTrack;
+        staffExport.m_midiChannel = midiChannel;
+    }
+
+    // Each staff is exported in a MIDI file of its own with the tracks of the output
+    std::vector<smf::MidiFile> staffMidiFiles(staffExports.size());
+    std::vector<MidiStream> staffMidiStreams((midiStream) ? staffExports.size() : 0);
+    auto exportStaff = [&](int index) {
+        smf::MidiFile &staffMidiFile = staffMidiFiles.at(index);
+        staffMidiFile.setTPQ(midiFile->getTPQ());
+        staffMidiFile.absoluteTicks();
+        staffMidiFile.addTracks(midiFile->getTrackCount() - staffMidiFile.getTrackCount());
+        MidiStream *staffMidiStream = (midiStream) ? &staffMidiStreams.at(index) : NULL;
+        this->ExportStaffMIDI(&staffMidiFile, staffExports.at(index), initMIDIParams.m_deferredNotes, tempo, midiExt,
+            staffMidiStream, chunk);
+    };
+
+    // The staves are exported concurrently, unless the timeline is filled or the current score would change. Small
+    // documents are exported sequentially since starting the threads would take longer than the export itself.
+    int threadCount = 1;
+#ifndef NO_MULTITHREADING
+    if (!midiExt && (this->GetScores().size() == 1)) {
+        int noteOrRestCount = 0;
+        for (const TimemapIndex::MeasureNotesOrRests &notesOrRests : m_timemapIndex.m_notesOrRests) {
+            noteOrRestCount += (int)notesOrRests.m_entries.size();
+        }
+        const int midiThreads = m_options->m_midiThreads.GetValue();
+        threadCount = (midiThreads > 0) ? midiThreads : (int)std::thread::hardware_concurrency();
+        threadCount = std::min(threadCount, (int)staffExports.size());
+        threadCount = std::min(threadCount, noteOrRestCount / MIDI_NOTES_PER_THREAD);
+    }
+#endif
+    if (threadCount > 1) {
+#ifndef NO_MULTITHREADING
+        std::atomic<int> nextIndex = 0;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&exportStaff, &nextIndex, &staffExports]() {
+                for (int index = nextIndex++; index < (int)staffExports.size(); index = nextIndex++) {
+                    exportStaff(index);
                 }
+            });
+        }
+        for (std::thread &thread : threads) thread.join();
+#endif
+    }
+    else {
+        for (int index = 0; index < (int)staffExports.size(); ++index) exportStaff(index);
+    }
+
+    // Merge the events in staff order, which gives the same tracks as exporting the staves one after the other
+    for (int index = 0; index < (int)staffExports.size(); ++index) {
+        smf::MidiFile &staffMidiFile = staffMidiFiles.at(index);
+        std::vector<int> elements;
+        if (midiStream) midiStream->AddElements(staffMidiStreams.at(index), elements);
+        for (int track = 0; track < staffMidiFile.getTrackCount(); ++track) {
+            for (int i = 0; i < staffMidiFile.getEventCount(track); ++i) {
+                smf::MidiEvent *event = midiFile->addEvent(track, staffMidiFile.getEvent(track, i));
+                if (midiStream && (event->element >= 0)) event->element = elements.at(event->element);
             }
-            // set MIDI track name
-            Label *label = vrv_cast<Label *>(staffDef->FindDescendantByType(LABEL, 1));
-            if (!label) {
-                StaffGrp *staffGrp = vrv_cast<StaffGrp *>(staffDef->GetFirstAncestor(STAFFGRP));
-                assert(staffGrp);
-                label = vrv_cast<Label *>(staffGrp->FindDescendantByType(LABEL, 1));
+        }
+        staffMidiFile.clear();
+    }
+
+    if (midiExt) midiExt->MergeNotes();
+    if (midiStream) midiStream->FillEvents(midiFile);
+}
+
+void Doc::ExportStaffMIDI(smf::MidiFile *midiFile, const MIDIStaffExport &staffExport,
+    const std::map<Note *, double> &deferredNotes, double tempo, MidiExt *midiExt, MidiStream *midiStream,
+    const MIDIChunk *chunk)
+{
+    const int midiTrack = staffExport.m_midiTrack;
+    const int midiChannel = staffExport.m_midiChannel;
+    ScoreDef *currentScoreDef = this->GetCurrentScoreDef();
+
+    if (StaffDef *staffDef = staffExport.m_staffDef) {
+        // set MIDI instrument
+        InstrDef *instrdef = staffExport.m_instrDef;
+        if (instrdef && instrdef->HasMidiInstrnum()) {
+            midiFile->addPatchChange(midiTrack, 0, midiChannel, instrdef->GetMidiInstrnum());
+        }
+        // set MIDI track name
+        Label *label = vrv_cast<Label *>(staffDef->FindDescendantByType(LABEL, 1));
+        if (!label) {
+            StaffGrp *staffGrp = vrv_cast<StaffGrp *>(staffDef->GetFirstAncestor(STAFFGRP));
+            assert(staffGrp);
+            label = vrv_cast<Label *>(staffGrp->FindDescendantByType(LABEL, 1));
+        }
+        if (label) {
+            std::string trackName = UTF16to8(label->GetText(label)).c_str();
+            if (!trackName.empty()) midiFile->addTrackName(midiTrack, 0, trackName);
+        }
+        // set MIDI key signature
+        KeySig *keySig = vrv_cast<KeySig *>(staffDef->FindDescendantByType(KEYSIG));
+        if (!keySig && (currentScoreDef->HasKeySigInfo())) {
+            keySig = vrv_cast<KeySig *>(currentScoreDef->GetKeySig());
+        }
+        if (keySig && keySig->HasSig()) {
+            midiFile->addKeySignature(midiTrack, 0, keySig->GetFifthsInt(), (keySig->GetMode() == MODE_minor));
+        }
+        // set MIDI time signature
+        MeterSig *meterSig = vrv_cast<MeterSig *>(staffDef->FindDescendantByType(METERSIG));
+        if (!meterSig && (currentScoreDef->HasMeterSigInfo())) {
+            meterSig = vrv_cast<MeterSig *>(currentScoreDef->GetMeterSig());
+        }
+        if (meterSig && meterSig->HasCount()) {
+            midiFile->addTimeSignature(midiTrack, 0, meterSig->GetTotalCount(), meterSig->GetUnit());
+        }
+    }
+
+    // Set initial scoreDef values for tuning
+    Functor generateScoreDefMIDI(&Object::GenerateMIDI);
+    Functor generateScoreDefMIDIEnd(&Object::GenerateMIDIEnd);
+    GenerateMIDIParams generateScoreDefMIDIParams(this, midiFile, &generateScoreDefMIDI);
+    generateScoreDefMIDIParams.m_midiChannel = midiChannel;
+    generateScoreDefMIDIParams.m_midiTrack = midiTrack;
+    generateScoreDefMIDIParams.m_chunk = chunk;
+    currentScoreDef->Process(&generateScoreDefMIDI, &generateScoreDefMIDIParams, &generateScoreDefMIDIEnd);
+
+    int layerIndex = staffExport.m_layerIndex;
+    Filters filters;
+    for (int layerN : staffExport.m_layerNs) {
+        filters.Clear();
+        // Create ad comparison object for each type / @n
+        AttNIntegerComparison matchStaff(STAFF, staffExport.m_staffN);
+        AttNIntegerComparison matchLayer(LAYER, layerN);
+        filters.Add(&matchStaff);
+        filters.Add(&matchLayer);
+
+        midiFile->setLayer(layerIndex);
+
+        Functor generateMIDI(&Object::GenerateMIDI);
+        Functor generateMIDIEnd(&Object::GenerateMIDIEnd);
+        GenerateMIDIParams generateMIDIParams(this, midiFile, &generateMIDI);
+        generateMIDIParams.m_midiExt = midiExt;
+        generateMIDIParams.m_midiChannel = midiChannel;
+        generateMIDIParams.m_midiTrack = midiTrack;
+        generateMIDIParams.m_staffN = staffExport.m_staffN;
+        generateMIDIParams.m_transSemi = staffExport.m_transSemi;
+        generateMIDIParams.m_currentTempo = tempo;
+        generateMIDIParams.m_deferredNotes = deferredNotes;
+        generateMIDIParams.m_cueExclusion = this->GetOptions()->m_midiNoCue.GetValue();
+        generateMIDIParams.m_repeatStartTime = 0;
+        generateMIDIParams.m_repeatEndingStartTime = 0;
+        generateMIDIParams.m_layerIndex = layerIndex;
+        generateMIDIParams.m_segnoStartTime = 0;
+        generateMIDIParams.m_segnoEndingStartTime = 0;
+        generateMIDIParams.m_fineTime = 0;
+        generateMIDIParams.m_repeatAdditionalDuration = 0;
+        generateMIDIParams.m_chunk = chunk;
+        generateMIDIParams.m_midiStream = midiStream;
+
+        // LogDebug("Exporting track %d ----------------", midiTrack);
+        if (m_expansionMap.HasTimeline()) {
+            // The measures are played in the order of the expanded timeline without repeating the content
+            this->ProcessTimeline(
+                &generateMIDI, &generateMIDIParams, &generateMIDIEnd, &filters, generateMIDIParams.m_repeat);
+        }
+        else {
+            this->Process(&generateMIDI, &generateMIDIParams, &generateMIDIEnd, &filters);
+        }
+        ++layerIndex;
+    }
+}
+
+void Doc::ProcessTimeline(
+    Functor *functor, FunctorParams *functorParams, Functor *endFunctor, Filters *filters, int &repeat)
+{
+    // Look for the scoreDefs between each measure and the previous one, going once through the parents
+    std::map<const Measure *, std::vector<Object *>> scoreDefs;
+    std::set<const Object *> parents;
+    for (auto &[measure, measureRepeat] : m_expansionMap.GetTimeline()) {
+        Object *parent = measure->GetParent();
+        assert(parent);
+        if (!parents.insert(parent).second) continue;
+        std::vector<Object *> previous;
+        for (Object *child : parent->GetChildren()) {
+            if (child->Is(SCOREDEF)) {
+                previous.push_back(child);
             }
-            if (label) {
-                std::string trackName = UTF16to8(label->GetText(label)).c_str();
-                if (!trackName.empty()) midiFile->addTrackName(midiTrack, 0, trackName);
+            else if (child->Is(MEASURE)) {
+                if (!previous.empty()) scoreDefs[vrv_cast<Measure *>(child)].swap(previous);
+                previous.clear();
             }
-            // set MIDI key signature
-            KeySig *keySig = vrv_cast<KeySig *>(staffDef->FindDescendantByType(KEYSIG));
-            if (!keySig && (currentScoreDef->HasKeySigInfo())) {
-                keySig = vrv_cast<KeySig *>(currentScoreDef->GetKeySig());
+        }
+    }
+
+    for (auto &[measure, measureRepeat] : m_expansionMap.GetTimeline()) {
+        repeat = measureRepeat;
+        if (scoreDefs.count(measure)) {
+            for (Object *scoreDef : scoreDefs.at(measure)) {
+                scoreDef->Process(functor, functorParams, endFunctor, filters);
             }
-            if (keySig && keySig->HasSig()) {
-                midiFile->addKeySignature(midiTrack, 0, keySig->GetFifthsInt(), (keySig->GetMode() == MODE_minor));
+        }
+        measure->Process(functor, functorParams, endFunctor, filters);
+    }
+}
+
+bool Doc::ExportMIDIChunk(smf::MidiFile *midiFile, Measure *firstMeasure, int firstRepeat, Measure *lastMeasure,
+    int lastRepeat, bool continued)
+{
+    assert(firstMeasure);
+    assert(lastMeasure);
+
+    if (!Doc::HasTimemap()) {
+        // generate MIDI timemap before progressing
+        CalculateTimemap();
+    }
+    if (!Doc::HasTimemap()) {
+        LogWarning("Calculation of MIDI timemap failed, not exporting MidiFile.");
+        return false;
+    }
+
+    // The first pass of the measures by default, and for the last one the first pass not before the first measure
+    if (firstRepeat == 0) firstRepeat = 1;
+    if ((firstRepeat < 1) || (firstRepeat > firstMeasure->GetRealTimeRepeatCount())) {
+        LogWarning("The first measure of a MIDI chunk is not played in the timemap.");
+        return false;
+    }
+    MIDIChunk chunk;
+    chunk.m_startTime = firstMeasure->GetScoreTimeOffset(firstRepeat);
+    if (lastRepeat == 0) {
+        lastRepeat = 1;
+        while ((lastRepeat < lastMeasure->GetRealTimeRepeatCount())
+            && (lastMeasure->GetScoreTimeOffset(lastRepeat) < chunk.m_startTime)) {
+            ++lastRepeat;
+        }
+    }
+    if ((lastRepeat < 1) || (lastRepeat > lastMeasure->GetRealTimeRepeatCount())) {
+        LogWarning("The last measure of a MIDI chunk is not played in the timemap.");
+        return false;
+    }
+    chunk.m_endTime = lastMeasure->GetScoreTimeOffset(lastRepeat) + lastMeasure->GetScoreTimeDuration();
+    chunk.m_tempo = firstMeasure->GetCurrentTempo(firstRepeat);
+    if (chunk.m_endTime <= chunk.m_startTime) {
+        LogWarning("The last measure of a MIDI chunk cannot be before the first one.");
+        return false;
+    }
+
+    // Look for the secondary tied notes of the chunk with the tie starting before it
+    if (!continued) {
+        // The score time of the last pass of the measure of the note starting at or before the given time
+        auto getMeasureTime = [](const Note *note, double time) {
+            const Measure *measure = vrv_cast<const Measure *>(note->GetFirstAncestor(MEASURE));
+            assert(measure);
+            double measureTime = VRV_UNSET;
+            for (int repeat = 1; repeat <= measure->GetRealTimeRepeatCount(); ++repeat) {
+                const double offset = measure->GetScoreTimeOffset(repeat);
+                if (offset <= time) measureTime = std::max(measureTime, offset);
             }
-            // set MIDI time signature
-            MeterSig *meterSig = vrv_cast<MeterSig *>(staffDef->FindDescendantByType(METERSIG));
-            if (!meterSig && (currentScoreDef->HasMeterSigInfo())) {
-                meterSig = vrv_cast<MeterSig *>(currentScoreDef->GetMeterSig());
+            return measureTime;
+        };
+
+        std::map<Note *, Note *> tieStarts;
+        ListOfObjects ties = this->FindAllDescendantsByType(TIE, false);
+        for (Object *object : ties) {
+            Tie *tie = vrv_cast<Tie *>(object);
+            assert(tie);
+            Note *note1 = dynamic_cast<Note *>(tie->GetStart());
+            Note *note2 = dynamic_cast<Note *>(tie->GetEnd());
+            if (note1 && note2) tieStarts[note2] = note1;
+        }
+
+        for (auto &[note, tieStart] : tieStarts) {
+            if (note->GetScoreTimeTiedDuration() >= 0.0) continue;
+            // Only the first pass of the note in the chunk can have its tie starting before it
+            const Measure *measure = vrv_cast<const Measure *>(note->GetFirstAncestor(MEASURE));
+            assert(measure);
+            double measureTime = VRV_UNSET;
+            for (int repeat = 1; repeat <= measure->GetRealTimeRepeatCount(); ++repeat) {
+                const double offset = measure->GetScoreTimeOffset(repeat);
+                if ((offset < chunk.m_startTime) || (offset >= chunk.m_endTime)) continue;
+                if ((measureTime == VRV_UNSET) || (offset < measureTime)) measureTime = offset;
             }
-            if (meterSig && meterSig->HasCount()) {
-                midiFile->addTimeSignature(midiTrack, 0, meterSig->GetTotalCount(), meterSig->GetUnit());
+            if (measureTime == VRV_UNSET) continue;
+            double playedTime = getMeasureTime(tieStart, measureTime);
+            if ((playedTime == VRV_UNSET) || (playedTime >= chunk.m_startTime)) continue;
+            // Go back to the note played for the whole tie, which gives the time at which it stops
+            Note *played = tieStart;
+            while ((played->GetScoreTimeTiedDuration() < 0.0) && tieStarts.count(played)) {
+                const double time = getMeasureTime(tieStarts.at(played), playedTime);
+                if (time == VRV_UNSET) break;
+                played = tieStarts.at(played);
+                playedTime = time;
             }
+            const double stopTime
+                = playedTime + played->GetScoreTimeOffset() + played->GetScoreTimeTiedDuration() - measureTime;
+            if (stopTime > note->GetScoreTimeOnset()) chunk.m_tiedInNotes[note] = stopTime;
         }
+    }
 
-        // Set initial scoreDef values for tuning
-        Functor generateScoreDefMIDI(&Object::GenerateMIDI);
-        Functor generateScoreDefMIDIEnd(&Object::GenerateMIDIEnd);
-        GenerateMIDIParams generateScoreDefMIDIParams(this, midiFile, &generateScoreDefMIDI);
-        generateScoreDefMIDIParams.m_midiChannel = midiChannel;
-        generateScoreDefMIDIParams.m_midiTrack = midiTrack;
-        currentScoreDef->Process(&generateScoreDefMIDI, &generateScoreDefMIDIParams, &generateScoreDefMIDIEnd);
+    this->ExportMIDI(midiFile, NULL, &chunk);
 
-        for (layers = staves->second.child.begin(); layers != staves->second.child.end(); ++layers, ++layerIndex) {
-            filters.Clear();
-            // Create ad comparison object for each type / @n
-            AttNIntegerComparison matchStaff(STAFF, staves->first);
-            AttNIntegerComparison matchLayer(LAYER, layers->first);
-            filters.Add(&matchStaff);
-            filters.Add(&matchLayer);
-            
-            midiFile->setLayer(layerIndex);
-
-            Functor generateMIDI(&Object::GenerateMIDI);
-            Functor generateMIDIEnd(&Object::GenerateMIDIEnd);
-            GenerateMIDIParams generateMIDIParams(this, midiFile, &generateMIDI);
-            generateMIDIParams.m_midiExt = midiExt;
-            generateMIDIParams.m_midiChannel = midiChannel;
-            generateMIDIParams.m_midiTrack = midiTrack;
-            generateMIDIParams.m_staffN = staves->first;
-            generateMIDIParams.m_transSemi = transSemi;
-            generateMIDIParams.m_currentTempo = tempo;
-            generateMIDIParams.m_deferredNotes = initMIDIParams.m_deferredNotes;
-            generateMIDIParams.m_cueExclusion = this->GetOptions()->m_midiNoCue.GetValue();
-            generateMIDIParams.m_repeatStartTime = 0;
-            generateMIDIParams.m_repeatEndingStartTime = 0;
-            generateMIDIParams.m_layerIndex = layerIndex;
-            generateMIDIParams.m_segnoStartTime = 0;
-            generateMIDIParams.m_segnoEndingStartTime = 0;
-            generateMIDIParams.m_fineTime = 0;
-            generateMIDIParams.m_repeatAdditionalDuration = 0;
-
-            // LogDebug("Exporting track %d ----------------", midiTrack);
-            this->Process(&generateMIDI, &generateMIDIParams, &generateMIDIEnd, &filters);
-        }
-    }
+    return true;
 }
 
 bool Doc::ExportTimemap(std::string &output, bool includeRests, bool includeMeasures)
@@ -481,7 +1023,15 @@ bool Doc::ExportTimemap(std::string &output, bool includeRests, bool includeMeas
     Functor generateTimemap(&Object::GenerateTimemap);
     GenerateTimemapParams generateTimemapParams(this, &timemap, &generateTimemap);
     generateTimemapParams.m_cueExclusion = this->GetOptions()->m_midiNoCue.GetValue();
-    this->Process(&generateTimemap, &generateTimemapParams);
+    if (m_expansionMap.HasTimeline()) {
+        for (auto &[measure, repeat] : m_expansionMap.GetTimeline()) {
+            generateTimemapParams.m_repeat = repeat;
+            measure->Process(&generateTimemap, &generateTimemapParams);
+        }
+    }
+    else {
+        this->Process(&generateTimemap, &generateTimemapParams);
+    }
 
     timemap.ToJson(output, includeRests, includeMeasures);
 
@@ -511,6 +1061,7 @@ bool Doc::ExportFeatures(std::string &output, const std::string &options)
 void Doc::PrepareData()
 {
     /************ Reset and initialization ************/
+    ++m_layoutGeneration;
     if (m_dataPreparationDone) {
         Functor resetData(&Object::ResetData);
         this->Process(&resetData, NULL);
@@ -864,6 +1415,9 @@ void Doc::ScoreDefSetCurrentDoc(bool force)
         return;
     }
 
+    // The drawing scoreDefs are deleted and created again
+    ++m_layoutGeneration;
+
     if (m_currentScoreDefDone) {
         Functor scoreDefUnsetCurrent(&Object::ScoreDefUnsetCurrent);
         ScoreDefUnsetCurrentParams scoreDefUnsetCurrentParams(&scoreDefUnsetCurrent);
@@ -1011,7 +1565,8 @@ void Doc::CastOffDocBase(bool useSb, bool usePb, bool smart)
     // Here we redo the alignment because of the new scoreDefs
     // Because of the new scoreDef, we need to reset cached drawingX
     castOffSinglePage->ResetCachedDrawingX();
-    castOffSinglePage->LayOutVertically();
+    // With estimated breaks, pages are laid out exactly only when rendered
+    castOffSinglePage->LayOutVertically(m_options->m_breaksEstimate.GetValue());
 
     // Detach the contentPage in order to be able call CastOffRunningElements
     pages->DetachChild(0);
@@ -1117,6 +1672,125 @@ void Doc::CastOffEncodingDoc()
     m_isCastOff = true;
 }
 
+bool Doc::CastOffFromCacheDoc()
+{
+    if (this->IsCastOff() || this->HasSelection()) return false;
+
+    const std::string key = m_options->GetLayoutKey();
+    auto cached = std::find_if(m_castOffCache.begin(), m_castOffCache.end(),
+        [&key](const std::pair<std::string, CastOffLayout> &entry) { return (entry.first == key); });
+    if (cached == m_castOffCache.end()) return false;
+
+    // Move it to the front since it is now the most recently used
+    m_castOffCache.splice(m_castOffCache.begin(), m_castOffCache, cached);
+    const CastOffLayout &castOffLayout = m_castOffCache.front().second;
+
+    this->ScoreDefSetCurrentDoc();
+
+    Pages *pages = this->GetPages();
+    assert(pages);
+
+    Page *unCastOffPage = this->SetDrawingPage(0);
+    assert(unCastOffPage);
+    unCastOffPage->ResetAligners();
+
+    // Detach the contentPage
+    pages->DetachChild(0);
+    assert(unCastOffPage && !unCastOffPage->GetParent());
+
+    Page *castOffFirstPage = new Page();
+    pages->AddChild(castOffFirstPage);
+
+    // Replay the breaks through the encoded cast off functor
+    CastOffEncodingParams castOffEncodingParams(this, castOffFirstPage);
+    castOffEncodingParams.m_castOffLayout = &castOffLayout;
+
+    Functor castOffEncoding(&Object::CastOffEncoding);
+    unCastOffPage->Process(&castOffEncoding, &castOffEncodingParams);
+    delete unCastOffPage;
+
+    this->ResetDataPage();
+
+    // Restore the cast off system widths used for the horizontal spacing during page layout
+    ListOfObjects systems = this->FindAllDescendantsByType(SYSTEM, false, 3);
+    m_isCastOff = true;
+    if (systems.size() != castOffLayout.m_systemWidths.size()) {
+        LogDebug("Cached cast off does not match the content and is discarded");
+        m_castOffCache.pop_front();
+        this->UnCastOffDoc();
+        return false;
+    }
+    auto widths = castOffLayout.m_systemWidths.begin();
+    for (Object *object : systems) {
+        System *system = vrv_cast<System *>(object);
+        assert(system);
+        system->m_castOffTotalWidth = widths->first;
+        system->m_castOffJustifiableWidth = widths->second;
+        ++widths;
+    }
+
+    this->ScoreDefSetCurrentDoc(true);
+
+    // Optimize the doc if one of the score requires optimization
+    for (auto const score : this->GetScores()) {
+        if (score->ScoreDefNeedsOptimization(m_options->m_condense.GetValue())) {
+            this->ScoreDefOptimizeDoc();
+            break;
+        }
+    }
+
+    return true;
+}
+
+void Doc::CacheCastOffDoc()
+{
+    if (!this->IsCastOff() || this->HasSelection()) return;
+
+    CastOffLayout castOffLayout;
+    bool isFirstSystem = true;
+    const Pages *pages = this->GetPages();
+    assert(pages);
+    for (const Object *page : pages->GetChildren()) {
+        const Object *pageStart = page->GetFirst();
+        if (pageStart && pageStart->Is(SYSTEM)) pageStart = pageStart->GetFirst();
+        if (pageStart && (page != pages->GetFirst())) castOffLayout.m_pageBreaks.insert(pageStart);
+        for (const Object *child : page->GetChildren()) {
+            if (!child->Is(SYSTEM)) continue;
+            const System *system = vrv_cast<const System *>(child);
+            assert(system);
+            // Empty systems cannot be replayed
+            if (!system->GetFirst()) return;
+            if (!isFirstSystem) castOffLayout.m_systemBreaks.insert(system->GetFirst());
+            castOffLayout.m_systemWidths.push_back({ system->m_castOffTotalWidth, system->m_castOffJustifiableWidth });
+            isFirstSystem = false;
+        }
+    }
+
+    const std::string key = m_options->GetLayoutKey();
+    m_castOffCache.remove_if(
+        [&key](const std::pair<std::string, CastOffLayout> &entry) { return (entry.first == key); });
+    m_castOffCache.push_front({ key, castOffLayout });
+    if (m_castOffCache.size() > CAST_OFF_CACHE_SIZE) m_castOffCache.pop_back();
+}
+
+void Doc::CastOffCachedBreak(const Object *object, CastOffEncodingParams *params)
+{
+    assert(params->m_castOffLayout);
+
+    const bool pageBreak = (params->m_castOffLayout->m_pageBreaks.count(object) > 0);
+    if (!pageBreak && (params->m_castOffLayout->m_systemBreaks.count(object) == 0)) return;
+
+    if (params->m_currentSystem && (params->m_currentSystem->GetChildCount() > 0)) {
+        params->m_currentPage->AddChild(params->m_currentSystem);
+        params->m_currentSystem = new System();
+    }
+    if (pageBreak && (params->m_currentPage->GetChildCount() > 0)) {
+        params->m_currentPage = new Page();
+        assert(this->GetPages());
+        this->GetPages()->AddChild(params->m_currentPage);
+    }
+}
+
 void Doc::InitSelectionDoc(DocSelection &selection, bool resetCache)
 {
     // No new selection to apply;
@@ -1208,6 +1882,7 @@ void Doc::DeactiveateSelection()
     assert(selectionScore);
     if (selectionScore->GetLabel() != "[selectionScore]") LogError("Deleting wrong score element. Something is wrong");
     selectionPage->DeleteChild(selectionScore);
+    ++m_layoutGeneration;
 
     m_selectionPreceeding->SetParent(pages);
     pages->InsertChild(m_selectionPreceeding, 0);
@@ -1235,6 +1910,7 @@ void Doc::ReactivateSelection(bool resetAligners)
     selectionScore->GetScoreDef()->ResetFromDrawingValues();
     selectionScore->SetParent(selectionPage);
     selectionPage->InsertChild(selectionScore, 0);
+    ++m_layoutGeneration;
 
     m_selectionPreceeding = vrv_cast<Page *>(pages->GetChild(0));
     // Reset the aligners because data will be accessed when rendering control events outside the selection
@@ -1272,6 +1948,7 @@ void Doc::ConvertToPageBasedDoc()
     assert(this->GetChildCount() == 0);
 
     this->AddChild(pages);
+    ++m_layoutGeneration;
 
     this->ResetDataPage();
 }
@@ -1454,6 +2131,12 @@ void Doc::ExpandExpansions()
         return;
     }
 
+    // Only expand the timeline, the measures being played once for each of their pass
+    if (this->GetOptions()->m_expandTimeline.GetValue()) {
+        m_expansionMap.ExpandTimeline(start->GetPlist(), start);
+        return;
+    }
+
     xsdAnyURI_List expansionList = start->GetPlist();
     xsdAnyURI_List existingList;
     m_expansionMap.Expand(expansionList, existingList, start);
@@ -2061,6 +2744,8 @@ ScoreDef *Doc::GetCurrentScoreDef()
 
 void Doc::SetCurrentScore(Score *score)
 {
+    // Do not write an unchanged score, since the document can be processed concurrently when exporting MIDI
+    if (m_currentScore == score) return;
     m_currentScore = score;
 }
 
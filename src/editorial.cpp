@@ -216,6 +216,7 @@ int EditorialElement::CastOffEncoding(FunctorParams *functorParams)
 
     // Only move editorial elements that are a child of the system
     if (this->GetParent() && this->GetParent()->Is(SYSTEM)) {
+        if (params->m_castOffLayout) params->m_doc->CastOffCachedBreak(this, params);
         MoveItselfTo(params->m_currentSystem);
     }
 
@@ -144,6 +144,8 @@ int Ending::CastOffEncoding(FunctorParams *functorParams)
     CastOffEncodingParams *params = vrv_params_cast<CastOffEncodingParams *>(functorParams);
     assert(params);
 
+    if (params->m_castOffLayout) params->m_doc->CastOffCachedBreak(this, params);
+
     MoveItselfTo(params->m_currentSystem);
 
     return FUNCTOR_SIBLINGS;
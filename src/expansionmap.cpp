@@ -17,6 +17,7 @@
 #include "editorial.h"
 #include "expansion.h"
 #include "linkinginterface.h"
+#include "measure.h"
 #include "plistinterface.h"
 #include "timeinterface.h"
 #include "vrv.h"
@@ -34,6 +35,7 @@ ExpansionMap::~ExpansionMap() {}
 void ExpansionMap::Reset()
 {
     m_map.clear();
+    m_timeline.clear();
 }
 
 void ExpansionMap::Expand(const xsdAnyURI_List &expansionList, xsdAnyURI_List &existingList, Object *prevSect)
@@ -120,6 +122,42 @@ void ExpansionMap::Expand(const xsdAnyURI_List &expansionList, xsdAnyURI_List &e
     }
 }
 
+void ExpansionMap::ExpandTimeline(const xsdAnyURI_List &expansionList, Object *expansion)
+{
+    m_timeline.clear();
+    std::map<Measure *, int> passes;
+    this->ExpandTimeline(expansionList, expansion, passes);
+}
+
+void ExpansionMap::ExpandTimeline(
+    const xsdAnyURI_List &expansionList, Object *expansion, std::map<Measure *, int> &passes)
+{
+    assert(expansion);
+    assert(expansion->GetParent());
+
+    for (std::string s : expansionList) {
+        if (s.rfind("#", 0) == 0) s = s.substr(1, s.size() - 1); // remove trailing hash from reference
+        Object *currSect = expansion->GetParent()->FindDescendantByID(s);
+        if (!currSect) {
+            return;
+        }
+        if (currSect->Is(EXPANSION)) { // if reference is itself an expansion, resolve it recursively
+            Expansion *currExpansion = vrv_cast<Expansion *>(currSect);
+            assert(currExpansion);
+            this->ExpandTimeline(currExpansion->GetPlist(), currSect, passes);
+        }
+        else {
+            // add the measures of the section/ending/rdg/lem once more
+            ListOfObjects measures = currSect->FindAllDescendantsByType(MEASURE);
+            for (Object *object : measures) {
+                Measure *measure = vrv_cast<Measure *>(object);
+                assert(measure);
+                m_timeline.push_back({ measure, ++passes[measure] });
+            }
+        }
+    }
+}
+
 bool ExpansionMap::UpdateIDs(Object *object)
 {
     for (Object *o : object->GetChildren()) {
@@ -17,6 +17,7 @@
 #include "chord.h"
 #include "doc.h"
 #include "gracegrp.h"
+#include "jsonwriter.h"
 #include "layer.h"
 #include "mdiv.h"
 #include "measure.h"
@@ -60,11 +61,9 @@ void FeatureExtractor::Extract(Object *object, GenerateFeaturesParams *params)
         // Check if the note is tied to a previous one and skip it if yes
         if (note->GetScoreTimeTiedDuration() == -1.0) {
             // Check if we need to add it to the previous interval ids
-            const int intervalsIdsSize = (int)m_intervalsIds.size();
-            if (intervalsIdsSize > 0) m_intervalsIds.get<jsonxx::Array>(intervalsIdsSize - 1) << note->GetID();
+            if (!m_intervalsIds.empty()) m_intervalsIds.back().push_back(note->GetID());
             // Same for pitch ids
-            const int pitchesIdsSize = (int)m_pitchesIds.size();
-            if (pitchesIdsSize > 0) m_pitchesIds.get<jsonxx::Array>(pitchesIdsSize - 1) << note->GetID();
+            if (!m_pitchesIds.empty()) m_pitchesIds.back().push_back(note->GetID());
             m_previousNotes.push_back(note);
             return;
         }
@@ -104,24 +103,22 @@ void FeatureExtractor::Extract(Object *object, GenerateFeaturesParams *params)
         std::transform(pname.begin(), pname.end(), pname.begin(), ::toupper);
         pitch << pname;
 
-        m_pitchesChromatic << pitch.str();
-        m_pitchesDiatonic << pname;
-        jsonxx::Array pitchesIds;
-        pitchesIds << note->GetID();
-        m_pitchesIds << jsonxx::Value(pitchesIds);
+        m_pitchesChromatic.push_back(pitch.str());
+        m_pitchesDiatonic.push_back(pname);
+        m_pitchesIds.push_back({ note->GetID() });
 
         // We have a previous note (or more with tied notes), so we can calculate an interval
         if (!m_previousNotes.empty()) {
             std::string intervalChromatic
                 = StringFormat("%d", note->GetMIDIPitch() - m_previousNotes.front()->GetMIDIPitch());
-            m_intervalsChromatic << intervalChromatic;
+            m_intervalsChromatic.push_back(intervalChromatic);
             std::string intervalDiatonic
                 = StringFormat("%d", note->GetDiatonicPitch() - m_previousNotes.front()->GetDiatonicPitch());
-            m_intervalsDiatonic << intervalDiatonic;
-            jsonxx::Array intervalsIds;
-            for (auto previousNote : m_previousNotes) intervalsIds << previousNote->GetID();
-            intervalsIds << note->GetID();
-            m_intervalsIds << jsonxx::Value(intervalsIds);
+            m_intervalsDiatonic.push_back(intervalDiatonic);
+            std::vector<std::string> intervalsIds;
+            for (auto previousNote : m_previousNotes) intervalsIds.push_back(previousNote->GetID());
+            intervalsIds.push_back(note->GetID());
+            m_intervalsIds.push_back(intervalsIds);
         }
         m_previousNotes.clear();
         m_previousNotes.push_back(note);
@@ -130,17 +127,24 @@ void FeatureExtractor::Extract(Object *object, GenerateFeaturesParams *params)
 
 void FeatureExtractor::ToJson(std::string &output)
 {
-    jsonxx::Object o;
-
-    o << "pitchesChromatic" << m_pitchesChromatic;
-    o << "pitchesDiatonic" << m_pitchesDiatonic;
-    o << "pitchesIds" << m_pitchesIds;
-
-    o << "intervalsChromatic" << m_intervalsChromatic;
-    o << "intervalsDiatonic" << m_intervalsDiatonic;
-    o << "intervalsIds" << m_intervalsIds;
-
-    output = o.json();
+    output.clear();
+    JsonWriter writer(output);
+    writer.StartObject();
+
+    // The keys are written in alphabetical order
+    writer.AddStringArray("intervalsChromatic", m_intervalsChromatic);
+    writer.AddStringArray("intervalsDiatonic", m_intervalsDiatonic);
+    writer.StartArray("intervalsIds");
+    for (const auto &ids : m_intervalsIds) writer.AddStringArray("", ids);
+    writer.EndArray();
+
+    writer.AddStringArray("pitchesChromatic", m_pitchesChromatic);
+    writer.AddStringArray("pitchesDiatonic", m_pitchesDiatonic);
+    writer.StartArray("pitchesIds");
+    for (const auto &ids : m_pitchesIds) writer.AddStringArray("", ids);
+    writer.EndArray();
+
+    writer.EndObject();
     LogDebug("%s", output.c_str());
 }
 
@@ -119,8 +119,12 @@ int GraceGrp::GenerateMIDIEnd(FunctorParams *functorParams)
             }
             const MIDIChord &chord = *iter;
             const double stopTime = startTime + graceNoteDur;
+            const int element
+                = (params->m_midiStream) ? params->m_midiStream->GetElementHandle(params->m_graceRefs[index]) : -1;
             for (int pitch : chord.pitches) {
-                params->m_midiFile->addNoteOn(params->m_midiTrack, startTime * tpq, channel, pitch, velocity);
+                smf::MidiEvent *noteOn
+                    = params->m_midiFile->addNoteOn(params->m_midiTrack, startTime * tpq, channel, pitch, velocity);
+                noteOn->element = element;
                 params->m_midiFile->addNoteOff(params->m_midiTrack, stopTime * tpq, channel, pitch);
             }
             startTime = stopTime;
@@ -55,30 +55,39 @@ Alignment *HorizontalAligner::SearchAlignmentAtTime(double time, AlignmentType t
 
 const Alignment *HorizontalAligner::SearchAlignmentAtTime(double time, AlignmentType type, int &idx) const
 {
-    int i;
     idx = -1; // the index if we reach the end.
-    const Alignment *alignment = NULL;
-    // First try to see if we already have something at the time position
-    for (i = 0; i < this->GetAlignmentCount(); ++i) {
-        alignment = vrv_cast<const Alignment *>(this->GetChild(i));
-        assert(alignment);
 
-        double alignment_time = alignment->GetTime();
-        if (AreEqual(alignment_time, time)) {
-            if (alignment->GetType() == type) {
-                return alignment;
-            }
-            else if (alignment->GetType() > type) {
-                idx = i;
-                break;
-            }
+    // Alignments are ordered by time and then by type, so we can do a binary search for the first alignment
+    // that is not before the time / type. As in a linear scan, an alignment at an equal time is before if its type is
+    // lower, and otherwise it is before if its time is lower
+    int first = 0;
+    int count = this->GetAlignmentCount();
+    while (count > 0) {
+        const int step = count / 2;
+        const Alignment *alignment = vrv_cast<const Alignment *>(this->GetChild(first + step));
+        assert(alignment);
+        const bool isBefore = AreEqual(alignment->GetTime(), time) ? (alignment->GetType() < type)
+                                                                    : (alignment->GetTime() < time);
+        if (isBefore) {
+            first += step + 1;
+            count -= step + 1;
         }
-        // nothing found, do not go any further but keep the index
-        if (alignment->GetTime() > time) {
-            idx = i;
-            break;
+        else {
+            count = step;
         }
     }
+
+    // nothing found to the end
+    if (first == this->GetAlignmentCount()) return NULL;
+
+    const Alignment *alignment = vrv_cast<const Alignment *>(this->GetChild(first));
+    assert(alignment);
+    // we already have something of the type at the time position
+    if (AreEqual(alignment->GetTime(), time) && (alignment->GetType() == type)) {
+        return alignment;
+    }
+    // nothing found, but keep the index
+    idx = first;
     return NULL;
 }
 
@@ -137,7 +146,7 @@ Alignment *MeasureAligner::GetAlignmentAtTime(double time, AlignmentType type)
     if (idx == -1) {
         if (type != ALIGNMENT_MEASURE_END) {
             // This typically occurs when a tstamp event occurs after the last note of a measure
-            int rightBarlineIdx = m_rightBarLineAlignment->GetIdx();
+            int rightBarlineIdx = this->GetRightBarLineAlignmentIdx();
             assert(rightBarlineIdx != -1);
             idx = rightBarlineIdx;
             this->SetMaxTime(time);
@@ -157,7 +166,7 @@ void MeasureAligner::SetMaxTime(double time)
     assert(m_rightBarLineAlignment);
 
     // it must be found in the aligner
-    int idx = m_rightBarLineAlignment->GetIdx();
+    int idx = this->GetRightBarLineAlignmentIdx();
     assert(idx != -1);
 
     int i;
@@ -171,6 +180,16 @@ void MeasureAligner::SetMaxTime(double time)
     }
 }
 
+int MeasureAligner::GetRightBarLineAlignmentIdx() const
+{
+    // The right barline is followed only by the caution scoreDef and the measure end alignments,
+    // so looking for it from the end is much faster than Object::GetIdx
+    for (int i = this->GetAlignmentCount() - 1; i >= 0; --i) {
+        if (this->GetChild(i) == m_rightBarLineAlignment) return i;
+    }
+    return -1;
+}
+
 double MeasureAligner::GetMaxTime() const
 {
     // we have to have a m_rightBarLineAlignment
@@ -0,0 +1,143 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        jsonwriter.cpp
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "jsonwriter.h"
+
+//----------------------------------------------------------------------------
+
+#include <cassert>
+#include <cstdio>
+#include <limits>
+
+//----------------------------------------------------------------------------
+
+namespace vrv {
+
+//----------------------------------------------------------------------------
+// JsonWriter
+//----------------------------------------------------------------------------
+
+JsonWriter::JsonWriter(std::string &output) : m_output(output)
+{
+    m_hasValue = false;
+}
+
+JsonWriter::~JsonWriter() {}
+
+void JsonWriter::StartObject(const std::string &key)
+{
+    this->StartValue(key);
+    m_output += "{\n";
+    m_containers.push_back(true);
+    m_hasValue = false;
+}
+
+void JsonWriter::EndObject()
+{
+    assert(!m_containers.empty() && m_containers.back());
+
+    this->EndContainer('}');
+}
+
+void JsonWriter::StartArray(const std::string &key)
+{
+    this->StartValue(key);
+    m_output += "[\n";
+    m_containers.push_back(false);
+    m_hasValue = false;
+}
+
+void JsonWriter::EndArray()
+{
+    assert(!m_containers.empty() && !m_containers.back());
+
+    this->EndContainer(']');
+}
+
+void JsonWriter::AddString(const std::string &key, const std::string &value)
+{
+    this->StartValue(key);
+    this->AppendEscaped(value);
+    m_hasValue = true;
+}
+
+void JsonWriter::AddNumber(const std::string &key, double value)
+{
+    this->StartValue(key);
+    // Same precision as jsonxx, which writes its numbers as long double
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*g", std::numeric_limits<long double>::digits10 + 1, value);
+    m_output += buffer;
+    m_hasValue = true;
+}
+
+void JsonWriter::AddBool(const std::string &key, bool value)
+{
+    this->StartValue(key);
+    m_output += (value) ? "true" : "false";
+    m_hasValue = true;
+}
+
+void JsonWriter::AddStringArray(const std::string &key, const std::vector<std::string> &values)
+{
+    this->StartArray(key);
+    for (const std::string &value : values) this->AddString(value);
+    this->EndArray();
+}
+
+void JsonWriter::StartValue(const std::string &key)
+{
+    assert(!m_containers.empty() || !m_hasValue);
+    assert(m_containers.empty() || (m_containers.back() != key.empty()));
+
+    if (m_hasValue) m_output += ",\n";
+    m_output.append(m_containers.size(), '\t');
+    if (!key.empty()) {
+        this->AppendEscaped(key);
+        m_output += ": ";
+    }
+}
+
+void JsonWriter::EndContainer(char closing)
+{
+    // The last value is followed by a space instead of the separator
+    if (m_hasValue) m_output += " \n";
+    m_containers.pop_back();
+    m_output.append(m_containers.size(), '\t');
+    m_output += closing;
+    m_hasValue = true;
+    if (m_containers.empty()) m_output += " \n";
+}
+
+void JsonWriter::AppendEscaped(const std::string &value)
+{
+    m_output += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': m_output += "\\\""; break;
+            case '\\': m_output += "\\\\"; break;
+            case '/': m_output += "\\/"; break;
+            case '\b': m_output += "\\b"; break;
+            case '\f': m_output += "\\f"; break;
+            case '\n': m_output += "\\n"; break;
+            case '\r': m_output += "\\r"; break;
+            case '\t': m_output += "\\t"; break;
+            default:
+                if ((unsigned char)c < 32) {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned char)c);
+                    m_output += buffer;
+                }
+                else {
+                    m_output += c;
+                }
+        }
+    }
+    m_output += '"';
+}
+
+} // namespace vrv
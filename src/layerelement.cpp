@@ -55,6 +55,7 @@
 #include "staff.h"
 #include "stem.h"
 #include "syl.h"
+#include "system.h"
 #include "tabgrp.h"
 #include "tie.h"
 #include "timeinterface.h"
@@ -1014,6 +1015,64 @@ wchar_t LayerElement::StemModToGlyph(data_STEMMODIFIER stemMod) const
     return 0;
 }
 
+bool LayerElement::IsSpannedElement(const FindSpannedLayerElementsParams *params) const
+{
+    assert(params);
+
+    if (!this->Is(params->m_classIds)) return false;
+
+    if (!this->HasContentBB() || this->HasEmptyBB() || (this->GetContentRight() <= params->m_minPos)
+        || (this->GetContentLeft() >= params->m_maxPos)) {
+        return false;
+    }
+
+    // We skip the start or end of the slur
+    const LayerElement *start = params->m_interface->GetStart();
+    const LayerElement *end = params->m_interface->GetEnd();
+    if ((this == start) || (this == end)) {
+        return false;
+    }
+
+    // Skip if neither parent staff nor cross staff matches the given staff number
+    if (!params->m_staffNs.empty()) {
+        const Staff *staff = this->GetAncestorStaff();
+        if (params->m_staffNs.find(staff->GetN()) == params->m_staffNs.end()) {
+            const Layer *layer = NULL;
+            staff = this->GetCrossStaff(layer);
+            if (!staff || (params->m_staffNs.find(staff->GetN()) == params->m_staffNs.end())) {
+                return false;
+            }
+        }
+    }
+
+    // Skip if layer number is outside given bounds
+    const int layerN = this->GetOriginalLayerN();
+    if (params->m_minLayerN && (params->m_minLayerN > layerN)) {
+        return false;
+    }
+    if (params->m_maxLayerN && (params->m_maxLayerN < layerN)) {
+        return false;
+    }
+
+    // Skip elements aligned at start/end, but on a different staff
+    if ((this->GetAlignment() == start->GetAlignment()) && !start->Is(TIMESTAMP_ATTR)) {
+        const Staff *staff = this->GetAncestorStaff(RESOLVE_CROSS_STAFF);
+        const Staff *startStaff = start->GetAncestorStaff(RESOLVE_CROSS_STAFF);
+        if (staff->GetN() != startStaff->GetN()) {
+            return false;
+        }
+    }
+    if ((this->GetAlignment() == end->GetAlignment()) && !end->Is(TIMESTAMP_ATTR)) {
+        const Staff *staff = this->GetAncestorStaff(RESOLVE_CROSS_STAFF);
+        const Staff *endStaff = end->GetAncestorStaff(RESOLVE_CROSS_STAFF);
+        if (staff->GetN() != endStaff->GetN()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 //----------------------------------------------------------------------------
 // Static methods for LayerElement
 //----------------------------------------------------------------------------
@@ -2522,59 +2581,30 @@ int LayerElement::FindSpannedLayerElements(FunctorParams *functorParams) const
 
     if (this->IsScoreDefElement()) return FUNCTOR_SIBLINGS;
 
-    if (!this->Is(params->m_classIds)) {
-        return FUNCTOR_CONTINUE;
+    if (this->IsSpannedElement(params)) {
+        params->m_elements.push_back(this);
     }
 
-    if (this->HasContentBB() && !this->HasEmptyBB() && (this->GetContentRight() > params->m_minPos)
-        && (this->GetContentLeft() < params->m_maxPos)) {
+    return FUNCTOR_CONTINUE;
+}
 
-        // We skip the start or end of the slur
-        const LayerElement *start = params->m_interface->GetStart();
-        const LayerElement *end = params->m_interface->GetEnd();
-        if ((this == start) || (this == end)) {
-            return FUNCTOR_CONTINUE;
-        }
+int LayerElement::InitSpannedElementIndex(FunctorParams *functorParams) const
+{
+    InitSpannedElementIndexParams *params = vrv_params_cast<InitSpannedElementIndexParams *>(functorParams);
+    assert(params);
 
-        // Skip if neither parent staff nor cross staff matches the given staff number
-        if (!params->m_staffNs.empty()) {
-            const Staff *staff = this->GetAncestorStaff();
-            if (params->m_staffNs.find(staff->GetN()) == params->m_staffNs.end()) {
-                const Layer *layer = NULL;
-                staff = this->GetCrossStaff(layer);
-                if (!staff || (params->m_staffNs.find(staff->GetN()) == params->m_staffNs.end())) {
-                    return FUNCTOR_CONTINUE;
-                }
-            }
-        }
+    if (this->IsScoreDefElement()) return FUNCTOR_SIBLINGS;
 
-        // Skip if layer number is outside given bounds
-        const int layerN = this->GetOriginalLayerN();
-        if (params->m_minLayerN && (params->m_minLayerN > layerN)) {
-            return FUNCTOR_CONTINUE;
-        }
-        if (params->m_maxLayerN && (params->m_maxLayerN < layerN)) {
-            return FUNCTOR_CONTINUE;
-        }
+    if (!this->Is(params->m_index->GetClassIds())) return FUNCTOR_CONTINUE;
 
-        // Skip elements aligned at start/end, but on a different staff
-        if ((this->GetAlignment() == start->GetAlignment()) && !start->Is(TIMESTAMP_ATTR)) {
-            const Staff *staff = this->GetAncestorStaff(RESOLVE_CROSS_STAFF);
-            const Staff *startStaff = start->GetAncestorStaff(RESOLVE_CROSS_STAFF);
-            if (staff->GetN() != startStaff->GetN()) {
-                return FUNCTOR_CONTINUE;
-            }
-        }
-        if ((this->GetAlignment() == end->GetAlignment()) && !end->Is(TIMESTAMP_ATTR)) {
-            const Staff *staff = this->GetAncestorStaff(RESOLVE_CROSS_STAFF);
-            const Staff *endStaff = end->GetAncestorStaff(RESOLVE_CROSS_STAFF);
-            if (staff->GetN() != endStaff->GetN()) {
-                return FUNCTOR_CONTINUE;
-            }
-        }
+    if (!this->HasContentBB() || this->HasEmptyBB()) return FUNCTOR_CONTINUE;
 
-        params->m_elements.push_back(this);
-    }
+    // Register the element for its parent staff and for its cross staff
+    const Staff *staff = this->GetAncestorStaff(ANCESTOR_ONLY, false);
+    if (!staff) return FUNCTOR_CONTINUE;
+    const Layer *layer = NULL;
+    const Staff *crossStaff = this->GetCrossStaff(layer);
+    params->m_index->AddElement(this, staff->GetN(), crossStaff ? crossStaff->GetN() : VRV_UNSET);
 
     return FUNCTOR_CONTINUE;
 }
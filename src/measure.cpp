@@ -155,9 +155,7 @@ void Measure::Reset()
     m_drawingEnding = NULL;
     m_hasAlignmentRefWithMultipleLayers = false;
 
-    m_scoreTimeOffset.clear();
-    m_realTimeOffsetMilliseconds.clear();
-    m_currentTempo = MIDI_TEMPO;
+    this->ResetTimeOffsets();
     m_duration = 0;
 }
 
@@ -473,8 +471,7 @@ const Staff *Measure::GetBottomVisibleStaff() const
 int Measure::EnclosesTime(int time) const
 {
     int repeat = 1;
-    double timeDuration
-        = m_measureAligner.GetRightAlignment()->GetTime() * DURATION_4 / DUR_MAX * 60.0 / m_currentTempo * 1000.0 + 0.5;
+    double timeDuration = this->GetRealTimeDurationMilliseconds();
     std::vector<double>::const_iterator iter;
     for (iter = m_realTimeOffsetMilliseconds.begin(); iter != m_realTimeOffsetMilliseconds.end(); ++iter) {
         if ((time >= *iter) && (time <= *iter + timeDuration)) return repeat;
@@ -489,6 +486,32 @@ double Measure::GetRealTimeOffsetMilliseconds(int repeat) const
     return m_realTimeOffsetMilliseconds.at(repeat - 1);
 }
 
+double Measure::GetScoreTimeOffset(int repeat) const
+{
+    if ((repeat < 1) || repeat > (int)m_scoreTimeOffset.size()) return this->GetLastTimeOffset();
+    return m_scoreTimeOffset.at(repeat - 1);
+}
+
+void Measure::ResetTimeOffsets()
+{
+    m_scoreTimeOffset.clear();
+    m_realTimeOffsetMilliseconds.clear();
+    m_currentTempo = MIDI_TEMPO;
+    m_repeatTempos.clear();
+}
+
+double Measure::GetRealTimeDurationMilliseconds(int repeat) const
+{
+    const double time = m_measureAligner.GetRightAlignment()->GetTime();
+    return time * DURATION_4 / DUR_MAX * 60.0 / this->GetCurrentTempo(repeat) * 1000.0 + 0.5;
+}
+
+double Measure::GetCurrentTempo(int repeat) const
+{
+    if ((repeat < 1) || repeat > (int)m_repeatTempos.size()) return m_currentTempo;
+    return m_repeatTempos.at(repeat - 1);
+}
+
 data_BARRENDITION Measure::GetDrawingLeftBarLineByStaffN(int staffN) const
 {
     auto elementIter = m_invisibleStaffBarlines.find(staffN);
@@ -698,6 +721,16 @@ int Measure::FindSpannedLayerElements(FunctorParams *functorParams) const
     return FUNCTOR_CONTINUE;
 }
 
+int Measure::InitSpannedElementIndex(FunctorParams *functorParams) const
+{
+    InitSpannedElementIndexParams *params = vrv_params_cast<InitSpannedElementIndexParams *>(functorParams);
+    assert(params);
+
+    params->m_index->AddMeasure(this);
+
+    return FUNCTOR_CONTINUE;
+}
+
 int Measure::ConvertMarkupAnalyticalEnd(FunctorParams *functorParams)
 {
     ConvertMarkupAnalyticalParams *params = vrv_params_cast<ConvertMarkupAnalyticalParams *>(functorParams);
@@ -1299,6 +1332,8 @@ int Measure::CastOffEncoding(FunctorParams *functorParams)
     CastOffEncodingParams *params = vrv_params_cast<CastOffEncodingParams *>(functorParams);
     assert(params);
 
+    if (params->m_castOffLayout) params->m_doc->CastOffCachedBreak(this, params);
+
     MoveItselfTo(params->m_currentSystem);
 
     return FUNCTOR_CONTINUE;
@@ -1609,8 +1644,19 @@ int Measure::GenerateMIDI(FunctorParams *functorParams)
     GenerateMIDIParams *params = vrv_params_cast<GenerateMIDIParams *>(functorParams);
     assert(params);
 
+    // With an expanded timeline, the measure is played at the offset of its pass
+    const double scoreTimeOffset = this->GetScoreTimeOffset(params->m_repeat);
+
+    // When exporting a chunk, skip the measures before it and stop after it
+    if (params->m_chunk) {
+        if (scoreTimeOffset < params->m_chunk->m_startTime) return FUNCTOR_SIBLINGS;
+        if (scoreTimeOffset >= params->m_chunk->m_endTime) return FUNCTOR_STOP;
+    }
+
     // Here we need to update the m_totalTime from the starting time of the measure.
-    params->m_totalTime = m_scoreTimeOffset.back() + params->m_repeatAdditionalDuration;
+    params->m_totalTime = scoreTimeOffset + params->m_repeatAdditionalDuration;
+    // The events of a chunk are relative to its start
+    if (params->m_chunk) params->m_totalTime -= params->m_chunk->m_startTime;
     params->m_endTime = params->m_totalTime + m_duration;
 
     if (params->m_midiExt) {
@@ -1621,9 +1667,10 @@ int Measure::GenerateMIDI(FunctorParams *functorParams)
         );
     }
 
-    if (m_currentTempo != params->m_currentTempo) {
-        params->m_midiFile->addTempo(0, params->m_totalTime * params->m_midiFile->getTPQ(), m_currentTempo);
-        params->m_currentTempo = m_currentTempo;
+    const double tempo = this->GetCurrentTempo(params->m_repeat);
+    if (tempo != params->m_currentTempo) {
+        params->m_midiFile->addTempo(0, params->m_totalTime * params->m_midiFile->getTPQ(), tempo);
+        params->m_currentTempo = tempo;
     }
 
     return FUNCTOR_CONTINUE;
@@ -1634,6 +1681,9 @@ int Measure::GenerateMIDIEnd(FunctorParams *functorParams)
     GenerateMIDIParams *params = vrv_params_cast<GenerateMIDIParams *>(functorParams);
     assert(params);
 
+    // Repeats are not performed in chunks and with an expanded timeline, which both follow the timemap
+    if (params->m_chunk || (params->m_repeat > 0)) return FUNCTOR_CONTINUE;
+
     if (GetLeft() == BARRENDITION_rptstart) {
         params->m_repeatStartTime = params->m_totalTime;
     }
@@ -1700,7 +1750,8 @@ void Measure::CopyMeasures(FunctorParams *functorParams, double startTime, doubl
         event = params->m_midiFile->getEvent(params->m_midiTrack, i);
         if (event.tick >= startTime * tpq && event.tick < endTime * tpq && event.layer == params->m_layerIndex) {
             auto tick = event.tick + addedTime * tpq;
-            params->m_midiFile->addEvent(params->m_midiTrack, tick, event);
+            smf::MidiEvent *copy = params->m_midiFile->addEvent(params->m_midiTrack, tick, event);
+            copy->element = event.element;
         }
     }
 
@@ -1716,9 +1767,12 @@ int Measure::GenerateTimemap(FunctorParams *functorParams)
     GenerateTimemapParams *params = vrv_params_cast<GenerateTimemapParams *>(functorParams);
     assert(params);
 
-    params->m_scoreTimeOffset = this->m_scoreTimeOffset.back();
-    params->m_realTimeOffsetMilliseconds = this->m_realTimeOffsetMilliseconds.back();
-    params->m_currentTempo = this->m_currentTempo;
+    // With an expanded timeline, the measure is added at the offsets of its pass
+    const int repeat = (params->m_repeat > 0) ? params->m_repeat : this->GetRealTimeRepeatCount();
+    params->m_scoreTimeOffset = this->GetScoreTimeOffset(repeat);
+    params->m_realTimeOffsetMilliseconds = this->GetRealTimeOffsetMilliseconds(repeat);
+    params->m_currentTempo = this->GetCurrentTempo(repeat);
+    params->m_realTimeFactor = m_currentTempo / params->m_currentTempo;
 
     params->m_timemap->AddEntry(this, params);
 
@@ -1730,13 +1784,21 @@ int Measure::InitMaxMeasureDuration(FunctorParams *functorParams)
     InitMaxMeasureDurationParams *params = vrv_params_cast<InitMaxMeasureDurationParams *>(functorParams);
     assert(params);
 
-    m_scoreTimeOffset.clear();
+    // With an expanded timeline, the offsets of the following passes are added to the ones of the first pass
+    if (params->m_repeat <= 1) {
+        m_scoreTimeOffset.clear();
+        m_realTimeOffsetMilliseconds.clear();
+    }
     m_scoreTimeOffset.push_back(params->m_currentScoreTime);
-
-    m_realTimeOffsetMilliseconds.clear();
     // m_realTimeOffsetMilliseconds.push_back(int(params->m_maxCurrentRealTimeSeconds * 1000.0 + 0.5));
     m_realTimeOffsetMilliseconds.push_back(params->m_currentRealTimeSeconds * 1000.0);
 
+    // Store the state at the start of the measure for recalculating the timemap from it
+    if (params->m_timemapState && (params->m_repeat <= 1)) {
+        params->m_timemapState->m_measures.push_back(
+            { this, params->m_currentRealTimeSeconds, params->m_currentTempo });
+    }
+
     return FUNCTOR_CONTINUE;
 }
 
@@ -1748,9 +1810,15 @@ int Measure::InitMaxMeasureDurationEnd(FunctorParams *functorParams)
     const double scoreTimeIncrement
         = m_measureAligner.GetRightAlignment()->GetTime() * params->m_multiRestFactor * DURATION_4 / DUR_MAX;
     m_duration = scoreTimeIncrement;
-    m_currentTempo = params->m_currentTempo * params->m_tempoAdjustment;
+    const double tempo = params->m_currentTempo * params->m_tempoAdjustment;
+    // With an expanded timeline, the notes are timed with the tempo of the first pass
+    if (params->m_repeat <= 1) {
+        m_currentTempo = tempo;
+        m_repeatTempos.clear();
+    }
+    m_repeatTempos.push_back(tempo);
     params->m_currentScoreTime += scoreTimeIncrement;
-    params->m_currentRealTimeSeconds += scoreTimeIncrement * 60.0 / m_currentTempo;
+    params->m_currentRealTimeSeconds += scoreTimeIncrement * 60.0 / tempo;
     params->m_multiRestFactor = 1;
 
     return FUNCTOR_CONTINUE;
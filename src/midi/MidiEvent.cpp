@@ -51,6 +51,7 @@ MidiEvent::MidiEvent(int aTime, int aTrack, vector<uchar>& message)
 	seconds     = 0.0;
 	seq         = 0;
     layer       = 0;
+    element     = -1;
 	m_eventlink = NULL;
 }
 
@@ -61,6 +62,7 @@ MidiEvent::MidiEvent(const MidiEvent& mfevent) : MidiMessage() {
 	seconds = mfevent.seconds;
 	seq     = mfevent.seq;
     layer   = mfevent.layer;
+    element = mfevent.element;
 	m_eventlink = NULL;
 
 	this->resize(mfevent.size());
@@ -82,6 +84,7 @@ MidiEvent::~MidiEvent() {
 	seconds = -1.0;
 	seq     = -1;
     layer   = -1;
+    element = -1;
 	this->resize(0);
 	m_eventlink = NULL;
 }
@@ -98,6 +101,7 @@ void MidiEvent::clearVariables(void) {
 	seconds   = 0.0;
 	seq       = 0;
     layer     = 0;
+    element   = -1;
 	m_eventlink = NULL;
 }
 
@@ -116,6 +120,7 @@ MidiEvent& MidiEvent::operator=(const MidiEvent& mfevent) {
 	seconds = mfevent.seconds;
 	seq     = mfevent.seq;
     layer   = mfevent.layer;
+    element = mfevent.element;
 	m_eventlink = NULL;
 	this->resize(mfevent.size());
 	for (int i=0; i<(int)this->size(); i++) {
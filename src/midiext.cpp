@@ -1,5 +1,5 @@
 /////////////////////////////////////////////////////////////////////////////
-// Name:        MidiExt.cpp
+// Name:        midiext.cpp
 // Author:      Herbert
 // Created:     23/04/2022
 // Copyright (c) Authors and others. All rights reserved.
@@ -9,24 +9,29 @@
 
 //----------------------------------------------------------------------------
 
-#include <assert.h>
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <map>
+#include <set>
+#include <tuple>
 
 //----------------------------------------------------------------------------
 
-#include "functorparams.h"
+#include "chord.h"
+#include "comparison.h"
+#include "jsonwriter.h"
+#include "layer.h"
 #include "measure.h"
 #include "note.h"
-#include "rest.h"
+#include "page.h"
 #include "staff.h"
 #include "system.h"
-#include "page.h"
-#include "elementpart.h"
-#include "artic.h"
 #include "vrv.h"
-#include "stem.h"
-#include "tuplet.h"
-#include "layer.h"
-#include "midi/MidiFile.h"
+
+//----------------------------------------------------------------------------
+
+#include "MidiFile.h"
 
 namespace vrv {
 
@@ -34,188 +39,555 @@ namespace vrv {
 // MidiExt
 //----------------------------------------------------------------------------
 
-    MidiExt::MidiExt() {
-        this->Reset();
-    }
+MidiExt::MidiExt()
+{
+    this->Reset();
+}
 
-    MidiExt::~MidiExt() {}
+MidiExt::~MidiExt() {}
 
-    void MidiExt::Reset() {
-        m_entries.clear();
-        m_measureTicks.clear();
-    }
+void MidiExt::Reset()
+{
+    m_entries.clear();
+    m_pendingNotes.clear();
+    m_notes.clear();
+    m_related.clear();
+    m_measures.clear();
+    m_systemUuid.clear();
+    m_adjustedLayers.clear();
+    m_ids.clear();
+    m_idIndexes.clear();
 
-    void MidiExt::AddNote(int tick, Note *object) {
-        if (m_entries.count(tick) == 0) {
-            MidiExtEntry emptyEntry;
-            m_entries[tick] = emptyEntry;
-        }
-        MidiExtEntry *entry = &m_entries[tick];
+    m_currentMeasure = NULL;
+    m_currentMeasureNo = -1;
+    m_currentPageNo = VRV_UNSET;
+    m_lastChord = NULL;
+    m_lastChordRelated.clear();
+}
 
-        DurationInterface *interface = object->GetDurationInterface();
-        assert(interface);
+void MidiExt::AddNote(int tick, Note *note)
+{
+    assert(note);
 
-        auto staff = dynamic_cast<Staff *>(object->GetFirstAncestor(STAFF));
-        auto layer = dynamic_cast<Layer *>(object->GetFirstAncestor(LAYER));
-        int staffNo = staff ? staff->GetN() : 0;
-        auto beam = dynamic_cast<Beam *>(object->GetFirstAncestor(vrv::BEAM));
-        auto tuplet = dynamic_cast<Tuplet *>(object->GetFirstAncestor(vrv::TUPLET));
-        auto accid = dynamic_cast<Accid *>(object->FindDescendantByType(vrv::ACCID));
-        auto atric = dynamic_cast<Artic *>(object->FindDescendantByType(vrv::ARTIC));
-        auto dots = dynamic_cast<Dots *>(object->FindDescendantByType(vrv::DOTS));
-        auto stem = dynamic_cast<Stem *>(object->FindDescendantByType(vrv::STEM));
-        auto flag = stem ? dynamic_cast<Flag *>(stem->FindDescendantByType(vrv::FLAG)) : nullptr;
-        auto chord = dynamic_cast<Chord *>(object->GetFirstAncestor(CHORD));
-        auto chordStem = chord ? dynamic_cast<Stem *>(chord->FindDescendantByType(vrv::STEM)) : nullptr;
-        auto chordFlag = chord ? dynamic_cast<Flag *>(chord->FindDescendantByType(vrv::FLAG)) : nullptr;
-        auto chordDots = chord ? dynamic_cast<Dots *>(chord->FindDescendantByType(vrv::DOTS)) : nullptr;
+    // Gather the ancestors in a single walk up to the measure
+    Staff *staff = NULL;
+    Layer *layer = NULL;
+    Object *beam = NULL;
+    Object *tuplet = NULL;
+    Chord *chord = NULL;
+    Measure *measure = NULL;
+    for (Object *ancestor = note->GetParent(); ancestor && !measure; ancestor = ancestor->GetParent()) {
+        switch (ancestor->GetClassId()) {
+            case STAFF:
+                if (!staff) staff = vrv_cast<Staff *>(ancestor);
+                break;
+            case LAYER:
+                if (!layer) layer = vrv_cast<Layer *>(ancestor);
+                break;
+            case BEAM:
+                if (!beam) beam = ancestor;
+                break;
+            case TUPLET:
+                if (!tuplet) tuplet = ancestor;
+                break;
+            case CHORD:
+                if (!chord) chord = vrv_cast<Chord *>(ancestor);
+                break;
+            case MEASURE: measure = vrv_cast<Measure *>(ancestor); break;
+            default: break;
+        }
+    }
 
-        // Store the element ID in list to turn on at given time - note or rest
-        Note *note = dynamic_cast<Note *>(object);
-        auto pitch = note->GetMIDIPitch();
-        auto uuid = object->GetID();
-        std::vector<std::string> elements;
-        elements.emplace_back(uuid);
-        if (beam) {
-            elements.emplace_back(beam->GetID());
+    // Gather the parts of the note in a single traversal, keeping the first of each type
+    Object *accid = NULL;
+    Object *artic = NULL;
+    Object *dots = NULL;
+    Object *stem = NULL;
+    Object *flag = NULL;
+    ClassIdsComparison matchParts({ ACCID, ARTIC, DOTS, STEM, FLAG });
+    ListOfObjects parts;
+    note->FindAllDescendantsByComparison(&parts, &matchParts);
+    for (Object *part : parts) {
+        if (part->Is(ACCID)) {
+            if (!accid) accid = part;
         }
-        if (tuplet) {
-            elements.emplace_back(tuplet->GetID());
+        else if (part->Is(ARTIC)) {
+            if (!artic) artic = part;
         }
-        if (accid) {
-            elements.emplace_back(accid->GetID());
+        else if (part->Is(DOTS)) {
+            if (!dots) dots = part;
         }
-        if (atric) {
-            elements.emplace_back(atric->GetID());
+        else if (part->Is(STEM)) {
+            if (!stem) stem = part;
         }
-        if (dots) {
-            elements.emplace_back(dots->GetID());
+        else if (!flag && stem && (part->GetParent() == stem)) {
+            flag = part;
         }
-        if (stem) {
-            elements.emplace_back(stem->GetID());
+    }
+
+    // The parts of the chord are shared by its notes, which are added one after the other
+    if (chord && (chord != m_lastChord)) {
+        m_lastChord = chord;
+        m_lastChordRelated.clear();
+        Object *chordStem = NULL;
+        Object *chordFlag = NULL;
+        Object *chordDots = NULL;
+        ClassIdsComparison matchChordParts({ STEM, FLAG, DOTS });
+        ListOfObjects chordParts;
+        chord->FindAllDescendantsByComparison(&chordParts, &matchChordParts);
+        for (Object *part : chordParts) {
+            if (part->Is(STEM)) {
+                if (!chordStem) chordStem = part;
+            }
+            else if (part->Is(FLAG)) {
+                if (!chordFlag) chordFlag = part;
+            }
+            else if (!chordDots) {
+                chordDots = part;
+            }
         }
-        if (flag) {
-            elements.emplace_back(flag->GetID());
+        if (chordFlag) m_lastChordRelated.push_back(this->InternID(chordFlag));
+        if (chordStem) m_lastChordRelated.push_back(this->InternID(chordStem));
+        if (chordDots) m_lastChordRelated.push_back(this->InternID(chordDots));
+    }
+
+    MidiExtNote midiExtNote;
+    midiExtNote.pitch = note->GetMIDIPitch();
+    midiExtNote.staffNo = staff ? staff->GetN() : 0;
+    midiExtNote.relatedStart = (int)m_related.size();
+    for (const Object *related : { (Object *)note, beam, tuplet, accid, artic, dots, stem, flag }) {
+        if (related) m_related.push_back(this->InternID(related));
+    }
+    if (chord) m_related.insert(m_related.end(), m_lastChordRelated.begin(), m_lastChordRelated.end());
+    midiExtNote.relatedCount = (int)m_related.size() - midiExtNote.relatedStart;
+
+    PendingNote pendingNote;
+    pendingNote.tick = tick;
+    pendingNote.noteIdx = (int)m_notes.size();
+    pendingNote.hasMeasure = (measure != NULL);
+    pendingNote.measureNo = -1;
+    pendingNote.pageNo = VRV_UNSET;
+    if (measure) {
+        if (measure == m_currentMeasure) {
+            pendingNote.measureNo = m_currentMeasureNo;
+            pendingNote.pageNo = m_currentPageNo;
         }
-        if (chordFlag) {
-            elements.emplace_back(chordFlag->GetID());
+        else {
+            MidiExt::GetMeasureNo(measure, pendingNote.measureNo);
+            Page *page = vrv_cast<Page *>(measure->GetFirstAncestor(PAGE));
+            if (page) pendingNote.pageNo = page->GetPageIdx();
         }
-        if (chordStem) {
-            elements.emplace_back(chordStem->GetID());
+        if (layer) {
+            midiExtNote.staffNo
+                = this->GetAdjustedStaffNo(pendingNote.measureNo, midiExtNote.staffNo, layer->GetN());
         }
-        if (chordDots) {
-            elements.emplace_back(chordDots->GetID());
+    }
+
+    m_notes.push_back(midiExtNote);
+    m_pendingNotes.push_back(pendingNote);
+}
+
+void MidiExt::MergeNotes()
+{
+    if (m_pendingNotes.empty()) return;
+
+    std::stable_sort(m_pendingNotes.begin(), m_pendingNotes.end(),
+        [](const PendingNote &a, const PendingNote &b) { return (a.tick < b.tick); });
+
+    std::vector<MidiExtEntry> entries;
+    entries.reserve(m_entries.size() + m_pendingNotes.size());
+    auto entryIter = m_entries.begin();
+    for (const PendingNote &pendingNote : m_pendingNotes) {
+        while ((entryIter != m_entries.end()) && (entryIter->tick < pendingNote.tick)) {
+            entries.push_back(std::move(*entryIter));
+            ++entryIter;
+        }
+        if (entries.empty() || (entries.back().tick != pendingNote.tick)) {
+            if ((entryIter != m_entries.end()) && (entryIter->tick == pendingNote.tick)) {
+                entries.push_back(std::move(*entryIter));
+                ++entryIter;
+            }
+            else {
+                entries.push_back({ pendingNote.tick, -1, VRV_UNSET, {} });
+            }
         }
-        Measure *measure = dynamic_cast<Measure *>(object->GetFirstAncestor(MEASURE));
-        if (measure) {
-            auto measureNo = -1;
-            try {
-                measureNo = std::stoi(measure->GetN()) - 1;
-            } catch (std::exception& e) {
-                ;
+        MidiExtEntry &entry = entries.back();
+        if (pendingNote.hasMeasure) {
+            entry.measureNo = pendingNote.measureNo;
+            // The notes are sorted by pitch and only the first note added for a pitch is kept
+            const int pitch = m_notes.at(pendingNote.noteIdx).pitch;
+            auto found = std::lower_bound(entry.notesOn.begin(), entry.notesOn.end(), pitch,
+                [this](int noteIdx, int value) { return (m_notes.at(noteIdx).pitch < value); });
+            if ((found == entry.notesOn.end()) || (m_notes.at(*found).pitch != pitch)) {
+                entry.notesOn.insert(found, pendingNote.noteIdx);
             }
+        }
+        if (pendingNote.pageNo != VRV_UNSET) entry.pageNo = pendingNote.pageNo;
+    }
+    std::move(entryIter, m_entries.end(), std::back_inserter(entries));
+
+    m_entries.swap(entries);
+    m_pendingNotes.clear();
+}
+
+const MidiExtEntry *MidiExt::GetTimeEntry(int tick)
+{
+    this->MergeNotes();
+
+    auto iter = std::lower_bound(m_entries.begin(), m_entries.end(), tick,
+        [](const MidiExtEntry &entry, int value) { return (entry.tick < value); });
+    return ((iter != m_entries.end()) && (iter->tick == tick)) ? &(*iter) : NULL;
+}
+
+void MidiExt::AddMeasure(int tick, int duration, Measure *measure)
+{
+    assert(measure);
+
+    // Measure::GenerateMIDI is called once for each staff and layer, so only look at the measure the first time
+    if (measure == m_currentMeasure) return;
 
-            entry->measureNo = measureNo;
-            
-            auto found = m_adjustedLayers.find(measureNo);
-            if (found != m_adjustedLayers.end())
-                staffNo = found->second.at(staffNo).at(layer->GetN());
-            entry->notesOn.emplace(pitch, std::make_pair(staffNo, elements));
+    m_currentMeasure = measure;
+    const bool hasMeasureNo = MidiExt::GetMeasureNo(measure, m_currentMeasureNo);
+    m_currentPageNo = VRV_UNSET;
+    Page *page = vrv_cast<Page *>(measure->GetFirstAncestor(PAGE));
+    if (page) m_currentPageNo = page->GetPageIdx();
+
+    System *system = vrv_cast<System *>(measure->GetFirstAncestor(SYSTEM));
+    if (!system) return;
+
+    const std::string &uuid = system->GetID();
+    if (m_systemUuid.count(uuid) == 0) {
+        const int systemNo = (int)m_systemUuid.size();
+        m_systemUuid[uuid] = systemNo;
+    }
+
+    if (hasMeasureNo) {
+        MidiExtMeasure &midiExtMeasure = this->GetOrInsertMeasure(tick);
+        midiExtMeasure.measureNo = m_currentMeasureNo;
+        midiExtMeasure.duration = duration;
+        midiExtMeasure.systemNo = m_systemUuid.at(uuid);
+    }
+    else {
+        LogDebug("MidiExt: invalid measure number '%s'", measure->GetN().c_str());
+    }
+
+    // With a single staff and two layers, the layers are assigned to two staves
+    std::map<int, std::map<int, int>> staffLayers;
+    ListOfObjects staves = measure->FindAllDescendantsByType(STAFF);
+    for (Object *object : staves) {
+        Staff *staff = vrv_cast<Staff *>(object);
+        assert(staff);
+        const int staffNo = staff->GetN();
+        ListOfObjects layers = staff->FindAllDescendantsByType(LAYER);
+        for (Object *layerObject : layers) {
+            Layer *layer = vrv_cast<Layer *>(layerObject);
+            assert(layer);
+            if (layer->FindDescendantByType(NOTE)) {
+                staffLayers[staffNo][layer->GetN()] = staffNo;
+            }
         }
+    }
+
+    if ((staffLayers.size() != 1) || (staffLayers.begin()->second.size() != 2)) return;
+
+    auto layerIter = staffLayers.begin();
+    if (layerIter->first == 1) {
+        layerIter->second.rbegin()->second = 2;
+    }
+    else if (layerIter->first == 2) {
+        layerIter->second.begin()->second = 1;
+    }
+
+    // Replace the previous ones for a measure with the same number
+    auto first = std::lower_bound(m_adjustedLayers.begin(), m_adjustedLayers.end(), m_currentMeasureNo,
+        [](const MidiExtAdjustedLayer &adjustedLayer, int value) { return (adjustedLayer.measureNo < value); });
+    auto last = std::find_if(first, m_adjustedLayers.end(),
+        [this](const MidiExtAdjustedLayer &adjustedLayer) { return (adjustedLayer.measureNo != m_currentMeasureNo); });
+    std::vector<MidiExtAdjustedLayer> adjustedLayers;
+    for (const auto &layer : layerIter->second) {
+        adjustedLayers.push_back({ m_currentMeasureNo, layerIter->first, layer.first, layer.second });
+    }
+    first = m_adjustedLayers.erase(first, last);
+    m_adjustedLayers.insert(first, adjustedLayers.begin(), adjustedLayers.end());
+}
+
+void MidiExt::CopyMeasures(int fromTick, int endTick, int addTick)
+{
+    // The copy starts from the measure at fromTick
+    auto iter = std::lower_bound(m_measures.begin(), m_measures.end(), fromTick,
+        [](const MidiExtMeasure &measure, int value) { return (measure.tick < value); });
+    if ((iter == m_measures.end()) || (iter->tick != fromTick)) return;
+
+    std::vector<MidiExtMeasure> copies;
+    for (; (iter != m_measures.end()) && (iter->tick < endTick); ++iter) {
+        copies.push_back(*iter);
+        copies.back().tick += addTick;
+    }
+    MidiExt::MergeCopies(m_measures, copies);
+}
+
+void MidiExt::CopyTimeEntry(int fromTick, int endTick, int addTick)
+{
+    this->MergeNotes();
+
+    auto iter = std::lower_bound(m_entries.begin(), m_entries.end(), fromTick,
+        [](const MidiExtEntry &entry, int value) { return (entry.tick < value); });
+
+    // The copies refer to the same notes
+    std::vector<MidiExtEntry> copies;
+    for (; (iter != m_entries.end()) && (iter->tick < endTick); ++iter) {
+        copies.push_back(*iter);
+        copies.back().tick += addTick;
+    }
+    MidiExt::MergeCopies(m_entries, copies);
+}
+
+std::vector<std::string> MidiExt::GetRelatedIDs(const MidiExtNote &note) const
+{
+    std::vector<std::string> ids;
+    ids.reserve(note.relatedCount);
+    for (int i = note.relatedStart; i < note.relatedStart + note.relatedCount; ++i) {
+        ids.push_back(m_ids.at(m_related.at(i)));
+    }
+    return ids;
+}
+
+int MidiExt::InternID(const Object *object)
+{
+    assert(object);
+
+    auto found = m_idIndexes.find(object);
+    if (found != m_idIndexes.end()) return found->second;
+
+    const int idx = (int)m_ids.size();
+    m_ids.push_back(object->GetID());
+    m_idIndexes[object] = idx;
+    return idx;
+}
+
+int MidiExt::GetAdjustedStaffNo(int measureNo, int staffNo, int layerNo) const
+{
+    auto found = std::lower_bound(m_adjustedLayers.begin(), m_adjustedLayers.end(),
+        MidiExtAdjustedLayer{ measureNo, staffNo, layerNo, 0 },
+        [](const MidiExtAdjustedLayer &a, const MidiExtAdjustedLayer &b) {
+            return std::tie(a.measureNo, a.staffNo, a.layerNo) < std::tie(b.measureNo, b.staffNo, b.layerNo);
+        });
+    if ((found == m_adjustedLayers.end()) || (found->measureNo != measureNo) || (found->staffNo != staffNo)
+        || (found->layerNo != layerNo)) {
+        return staffNo;
+    }
+    return found->adjustedStaffNo;
+}
 
-        Page *page = dynamic_cast<Page *>(object->GetFirstAncestor(PAGE));
-        if (page) {
-            entry->pageNo = page->GetPageIdx();
+MidiExtMeasure &MidiExt::GetOrInsertMeasure(int tick)
+{
+    auto iter = std::lower_bound(m_measures.begin(), m_measures.end(), tick,
+        [](const MidiExtMeasure &measure, int value) { return (measure.tick < value); });
+    if ((iter == m_measures.end()) || (iter->tick != tick)) {
+        iter = m_measures.insert(iter, { tick, -1, 0, 0 });
+    }
+    return *iter;
+}
+
+template <class T> void MidiExt::MergeCopies(std::vector<T> &items, std::vector<T> &copies)
+{
+    if (copies.empty()) return;
+
+    // Copies after the last item, as when the score is processed for the first staff, are simply appended
+    if (items.empty() || (items.back().tick < copies.front().tick)) {
+        items.insert(items.end(), std::make_move_iterator(copies.begin()), std::make_move_iterator(copies.end()));
+        return;
+    }
+
+    std::vector<T> merged;
+    merged.reserve(items.size() + copies.size());
+    auto iter = items.begin();
+    for (T &copy : copies) {
+        while ((iter != items.end()) && (iter->tick < copy.tick)) {
+            merged.push_back(std::move(*iter));
+            ++iter;
         }
+        if ((iter != items.end()) && (iter->tick == copy.tick)) ++iter;
+        merged.push_back(std::move(copy));
     }
+    std::move(iter, items.end(), std::back_inserter(merged));
+    items.swap(merged);
+}
+
+bool MidiExt::GetMeasureNo(const Measure *measure, int &measureNo)
+{
+    assert(measure);
 
-    MidiExtEntry *MidiExt::GetTimeEntry(int tick) {
-        auto iter = m_entries.find(tick);
-        return iter != m_entries.end() ? &iter->second : nullptr;
+    measureNo = -1;
+    try {
+        measureNo = std::stoi(measure->GetN()) - 1;
     }
+    catch (std::exception &e) {
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// MidiStream
+//----------------------------------------------------------------------------
+
+MidiStream::MidiStream()
+{
+    this->Reset();
+}
+
+MidiStream::~MidiStream() {}
+
+void MidiStream::Reset()
+{
+    m_events.clear();
+    m_tpq = 0;
+    m_ids.clear();
+    m_objects.clear();
+    m_idIndexes.clear();
+}
+
+int MidiStream::GetElementHandle(const Object *object)
+{
+    assert(object);
+
+    auto found = m_idIndexes.find(object);
+    if (found != m_idIndexes.end()) return found->second;
+
+    const int idx = (int)m_ids.size();
+    m_ids.push_back(object->GetID());
+    m_objects.push_back(object);
+    m_idIndexes[object] = idx;
+    return idx;
+}
+
+void MidiStream::AddElements(const MidiStream &other, std::vector<int> &handles)
+{
+    handles.clear();
+    handles.reserve(other.m_objects.size());
+    for (const Object *object : other.m_objects) handles.push_back(this->GetElementHandle(object));
+}
+
+void MidiStream::FillEvents(smf::MidiFile *midiFile)
+{
+    assert(midiFile);
 
-    void MidiExt::AddMeasure(int tick, int duration, Measure *measure) {
-        auto system = dynamic_cast<System *>(measure->GetFirstAncestor(SYSTEM));
-        if (system) {
-            auto uuid = system->GetID();
-            if (m_systemUuid.count(uuid) == 0) {
-                m_systemUuid[uuid] = m_systemUuid.size();
+    m_events.clear();
+    m_tpq = midiFile->getTPQ();
+
+    // The note ons (with their index in the events) and the note offs as tick, note off flag and index
+    std::vector<std::tuple<int, bool, int>> notes;
+    std::set<std::pair<int, double>> tempos;
+    for (int track = 0; track < midiFile->getTrackCount(); ++track) {
+        notes.clear();
+        for (int i = 0; i < midiFile->getEventCount(track); ++i) {
+            const smf::MidiEvent &event = midiFile->getEvent(track, i);
+            if (event.isNoteOn()) {
+                notes.push_back({ event.tick, false, (int)m_events.size() });
+                m_events.push_back({ MIDI_STREAM_note, event.tick, 0.0, 0, 0.0, track, event.getChannel(),
+                    event.getKeyNumber(), event.getVelocity(), 0.0, event.element });
+            }
+            else if (event.isNoteOff()) {
+                notes.push_back({ event.tick, true, i });
             }
-            auto measureNo = -1;
-            try {
-                measureNo = std::stoi(measure->GetN()) - 1;
-                m_measureTicks[tick] = MidiExtMeasure{
-                        measureNo,
-                        duration,
-                        m_systemUuid[uuid]
-                };
-            } catch (std::exception& e) {
-                fprintf(stdout, "[MidiExt]measure no error:%s\n", measure->GetN().c_str());
+            else if (event.isTempo()) {
+                const double tempo = event.getTempoBPM();
+                if (!tempos.insert({ event.tick, tempo }).second) continue;
+                m_events.push_back({ MIDI_STREAM_tempo, event.tick, 0.0, 0, 0.0, track, -1, -1, 0, tempo, -1 });
             }
-            
-            std::map<int, std::map<int, int>> staffLayers;
-            auto staffs = measure->FindAllDescendantsByType(vrv::STAFF);
-            for (auto staffObj : staffs) {
-                auto staff = (vrv::Staff *) staffObj;
-                auto staffNo = staff->GetN();
-                auto layers = staff->FindAllDescendantsByType(vrv::LAYER);
-                for (auto layerObj : layers) {
-                    auto layer = (vrv::Layer *) layerObj;
-                    auto layerNo = layer->GetN();
-                    auto mspace = layer->FindDescendantByType(vrv::NOTE);
-                    if (mspace) {
-                        staffLayers[staffNo][layerNo] = staffNo;
-                    }
-                }
+            else if (event.isPatchChange()) {
+                m_events.push_back({ MIDI_STREAM_program, event.tick, 0.0, 0, 0.0, track, event.getChannel(),
+                    event.getP1(), 0, 0.0, -1 });
             }
-            
-            if (staffLayers.size() == 1) {
-                auto layerIter = staffLayers.begin();
-                if (layerIter->second.size() == 2) {
-                    if (layerIter->first == 1) {
-                        layerIter->second.rbegin()->second = 2;
-                    } else if (layerIter->first == 2) {
-                        layerIter->second.begin()->second = 1;
-                    }
-                    m_adjustedLayers[measureNo] = staffLayers;
-                }
+            else if (event.isController() && (event.getP1() == 64)) {
+                m_events.push_back({ MIDI_STREAM_pedal, event.tick, 0.0, 0, 0.0, track, event.getChannel(), -1,
+                    event.getP2(), 0.0, -1 });
             }
         }
+        this->MatchNotes(midiFile, track, notes);
     }
 
-    void MidiExt::CopyMeasures(int fromTick, int endTick, int addTick) {
-        auto iter = m_measureTicks.find(fromTick);
-        while (iter != m_measureTicks.end() && iter->first < endTick) {
-            m_measureTicks[iter->first + addTick] = iter->second;
-            fprintf(stdout, "[MidiExt]CopyMeasure tick:%d\n", iter->first + addTick);
-            iter++;
-        }
-    }
+    // Tempo changes come first, then program changes and pedals, as when sorting the tracks of the MIDI file
+    std::stable_sort(m_events.begin(), m_events.end(), [](const MidiStreamEvent &a, const MidiStreamEvent &b) {
+        return (a.tick != b.tick) ? (a.tick < b.tick) : (a.type < b.type);
+    });
 
-    void MidiExt::CopyTimeEntry(int fromTick, int endTick, int addTick) {
-        auto iter = std::find_if(m_entries.begin(), m_entries.end(),
-                                 [fromTick](const std::pair<int, MidiExtEntry> &entry) {
-                                     return entry.first >= fromTick;
-                                 });
-        while (iter != m_entries.end() && iter->first < endTick) {
-            m_entries[iter->first + addTick] = iter->second;
-            iter++;
-        }
+    // The time in seconds at each tempo change, with the MIDI default tempo before the first one
+    std::vector<std::tuple<int, double, double>> tempoMap = { { 0, 0.0, 120.0 } };
+    for (const MidiStreamEvent &event : m_events) {
+        if (event.type != MIDI_STREAM_tempo) continue;
+        const auto &[tick, seconds, tempo] = tempoMap.back();
+        const double eventSeconds = seconds + (event.tick - tick) * 60.0 / (tempo * m_tpq);
+        if (std::get<0>(tempoMap.back()) == event.tick) tempoMap.pop_back();
+        tempoMap.push_back({ event.tick, eventSeconds, event.tempo });
     }
+    auto getSeconds = [this, &tempoMap](int tick) {
+        auto iter = std::upper_bound(tempoMap.begin(), tempoMap.end(), tick,
+            [](int value, const std::tuple<int, double, double> &entry) { return (value < std::get<0>(entry)); });
+        const auto &[tempoTick, seconds, tempo] = *(--iter);
+        return seconds + (tick - tempoTick) * 60.0 / (tempo * m_tpq);
+    };
 
-    const std::map<int, MidiExtMeasure> &MidiExt::GetMeasures() const {
-        return m_measureTicks;
+    for (MidiStreamEvent &event : m_events) {
+        event.seconds = getSeconds(event.tick);
+        if (event.type != MIDI_STREAM_note) continue;
+        event.durationSeconds = getSeconds(event.tick + event.durationTicks) - event.seconds;
     }
+}
 
-    const std::map<int, MidiExtEntry> &MidiExt::GetEntries() const {
-        return m_entries;
-    }
+void MidiStream::MatchNotes(smf::MidiFile *midiFile, int track, std::vector<std::tuple<int, bool, int>> &notes)
+{
+    // Note offs come first at the same tick, as when sorting the tracks of the MIDI file
+    std::stable_sort(notes.begin(), notes.end(), [](const auto &a, const auto &b) {
+        if (std::get<0>(a) != std::get<0>(b)) return (std::get<0>(a) < std::get<0>(b));
+        return (std::get<1>(a) > std::get<1>(b));
+    });
 
-    const std::map<std::string, int> &MidiExt::GetSystems() const {
-        return m_systemUuid;
+    // Each note off is matched with the last note on of the same channel and pitch, as in MidiFile::linkNotePairs
+    std::map<std::pair<int, int>, std::vector<int>> noteOns;
+    for (const auto &[tick, isNoteOff, idx] : notes) {
+        if (!isNoteOff) {
+            const MidiStreamEvent &noteOn = m_events.at(idx);
+            noteOns[{ noteOn.channel, noteOn.pitch }].push_back(idx);
+            continue;
+        }
+        const smf::MidiEvent &noteOff = midiFile->getEvent(track, idx);
+        auto found = noteOns.find({ noteOff.getChannel(), noteOff.getKeyNumber() });
+        if ((found == noteOns.end()) || found->second.empty()) continue;
+        MidiStreamEvent &noteOn = m_events.at(found->second.back());
+        noteOn.durationTicks = tick - noteOn.tick;
+        found->second.pop_back();
     }
+}
+
+void MidiStream::ToJson(std::string &output) const
+{
+    output.clear();
+    JsonWriter writer(output);
+    writer.StartObject();
+
+    // The keys are written in alphabetical order
+    auto addArray = [this, &writer](const std::string &key, auto getValue) {
+        writer.StartArray(key);
+        for (const MidiStreamEvent &event : m_events) writer.AddNumber(getValue(event));
+        writer.EndArray();
+    };
+    addArray("channels", [](const MidiStreamEvent &event) { return event.channel; });
+    addArray("durationSeconds", [](const MidiStreamEvent &event) { return event.durationSeconds; });
+    addArray("durationTicks", [](const MidiStreamEvent &event) { return event.durationTicks; });
+    addArray("elements", [](const MidiStreamEvent &event) { return event.element; });
+    writer.AddStringArray("ids", m_ids);
+    addArray("pitches", [](const MidiStreamEvent &event) { return event.pitch; });
+    addArray("seconds", [](const MidiStreamEvent &event) { return event.seconds; });
+    addArray("tempos", [](const MidiStreamEvent &event) { return event.tempo; });
+    addArray("ticks", [](const MidiStreamEvent &event) { return event.tick; });
+    writer.AddNumber("tpq", m_tpq);
+    addArray("tracks", [](const MidiStreamEvent &event) { return event.track; });
+    addArray("types", [](const MidiStreamEvent &event) { return (int)event.type; });
+    addArray("velocities", [](const MidiStreamEvent &event) { return event.velocity; });
+
+    writer.EndObject();
+}
 
-    const std::map<int, std::map<int, std::map<int, int>>> &MidiExt::GetAdjustedLayers() const {
-        return m_adjustedLayers;
-    }
 } // namespace vrv
@@ -852,8 +852,12 @@ void Note::GenerateGraceNoteMIDI(FunctorParams *functorParams, double startTime,
 
         const MIDIChord &chord = *iter;
         const double stopTime = startTime + graceNoteDur;
+        const int element
+            = (params->m_midiStream) ? params->m_midiStream->GetElementHandle(params->m_graceRefs[index]) : -1;
         for (int pitch : chord.pitches) {
-            params->m_midiFile->addNoteOn(params->m_midiTrack, startTime * tpq, channel, pitch, velocity);
+            smf::MidiEvent *noteOn
+                = params->m_midiFile->addNoteOn(params->m_midiTrack, startTime * tpq, channel, pitch, velocity);
+            noteOn->element = element;
             params->m_midiFile->addNoteOff(params->m_midiTrack, stopTime * tpq, channel, pitch);
         }
         startTime = stopTime;
@@ -1451,9 +1455,13 @@ int Note::GenerateMIDI(FunctorParams *functorParams)
         return FUNCTOR_SIBLINGS;
     }
 
-    // If the note is a secondary tied note, then ignore it
+    // The score time at which the note stops from the start of the measure
+    double scoreTimeStop = this->GetScoreTimeOffset() + this->GetScoreTimeTiedDuration();
+
+    // If the note is a secondary tied note, then ignore it, unless the tie starts before the chunk exported
     if (this->GetScoreTimeTiedDuration() < 0.0) {
-        return FUNCTOR_SIBLINGS;
+        if (!params->m_chunk || (params->m_chunk->m_tiedInNotes.count(this) == 0)) return FUNCTOR_SIBLINGS;
+        scoreTimeStop = params->m_chunk->m_tiedInNotes.at(this);
     }
 
     // Handle grace notes
@@ -1500,6 +1508,7 @@ int Note::GenerateMIDI(FunctorParams *functorParams)
     if (params->m_midiExt) {
         params->m_midiExt->AddNote(startTime * tpq, this);
     }
+    const int element = (params->m_midiStream) ? params->m_midiStream->GetElementHandle(this) : -1;
 
     // Check if note was expanded into sequence of short notes due to trills/tremolandi
     // Play either the expanded note sequence or a single note
@@ -1507,7 +1516,9 @@ int Note::GenerateMIDI(FunctorParams *functorParams)
         for (const auto &midiNote : params->m_expandedNotes[this]) {
             const double stopTime = startTime + midiNote.duration;
 
-            params->m_midiFile->addNoteOn(params->m_midiTrack, startTime * tpq, channel, midiNote.pitch, velocity);
+            smf::MidiEvent *noteOn = params->m_midiFile->addNoteOn(
+                params->m_midiTrack, startTime * tpq, channel, midiNote.pitch, velocity);
+            noteOn->element = element;
             params->m_midiFile->addNoteOff(params->m_midiTrack, stopTime * tpq, channel, midiNote.pitch);
 
             startTime = stopTime;
@@ -1541,16 +1552,19 @@ int Note::GenerateMIDI(FunctorParams *functorParams)
             // TODO optimize the default hold duration
             const double defaultHoldTime = 4; // quarter notes
             params->m_heldNotes[course - 1].m_pitch = pitch;
-            params->m_heldNotes[course - 1].m_stopTime = params->m_totalTime
-                + std::max(defaultHoldTime, this->GetScoreTimeOffset() + this->GetScoreTimeTiedDuration());
+            params->m_heldNotes[course - 1].m_stopTime = params->m_totalTime + std::max(defaultHoldTime, scoreTimeStop);
 
             // start this note
-            params->m_midiFile->addNoteOn(params->m_midiTrack, startTime * tpq, channel, pitch, velocity);
+            smf::MidiEvent *noteOn
+                = params->m_midiFile->addNoteOn(params->m_midiTrack, startTime * tpq, channel, pitch, velocity);
+            noteOn->element = element;
         }
         else {
-            const double stopTime = params->m_totalTime + this->GetScoreTimeOffset() + this->GetScoreTimeTiedDuration();
+            const double stopTime = params->m_totalTime + scoreTimeStop;
 
-            params->m_midiFile->addNoteOn(params->m_midiTrack, startTime * tpq, channel, pitch, velocity);
+            smf::MidiEvent *noteOn
+                = params->m_midiFile->addNoteOn(params->m_midiTrack, startTime * tpq, channel, pitch, velocity);
+            noteOn->element = element;
             params->m_midiFile->addNoteOff(params->m_midiTrack, stopTime * tpq, channel, pitch);
         }
     }
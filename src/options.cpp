@@ -9,9 +9,11 @@
 
 //----------------------------------------------------------------------------
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <functional>
+#include <set>
 #include <sstream>
 
 //----------------------------------------------------------------------------
@@ -913,8 +915,8 @@ Options::Options()
     m_scale.SetShortOption('s', false);
     m_baseOptions.AddOption(&m_scale);
 
-    m_outputTo.SetInfo(
-        "Output to", "Select output format to: \"mei\", \"mei-pb\", \"mei-basic\", \"svg\", or \"midi\"");
+    m_outputTo.SetInfo("Output to",
+        "Select output format to: \"mei\", \"mei-pb\", \"mei-basic\", \"svg\", \"svgz\", \"binary\", \"png\", or \"midi\"");
     m_outputTo.Init("svg");
     m_outputTo.SetKey("outputTo");
     m_outputTo.SetShortOption('t', true);
@@ -981,6 +983,11 @@ Options::Options()
     m_expand.Init("");
     this->Register(&m_expand, "expand", &m_general);
 
+    m_expandTimeline.SetInfo(
+        "Expand timeline", "Expand the expansion only in the timemap and the MIDI output, without cloning the content");
+    m_expandTimeline.Init(false);
+    this->Register(&m_expandTimeline, "expandTimeline", &m_general);
+
     m_footer.SetInfo("Footer", "Control footer layout");
     m_footer.Init(FOOTER_auto, &Option::s_footer);
     this->Register(&m_footer, "footer", &m_general);
@@ -1111,6 +1118,11 @@ Options::Options()
     m_svgCss.Init("");
     this->Register(&m_svgCss, "svgCss", &m_general);
 
+    m_svgGlyphSprite.SetInfo("Shared glyph sprite on CLI",
+        "Write the glyphs to a sprite file shared by the SVG pages on command-line, with all pages");
+    m_svgGlyphSprite.Init(false);
+    this->Register(&m_svgGlyphSprite, "svgGlyphSprite", &m_general);
+
     m_svgViewBox.SetInfo("Use viewbox on svg root", "Use viewBox on svg root element for easy scaling of document");
     m_svgViewBox.Init(false);
     this->Register(&m_svgViewBox, "svgViewBox", &m_general);
@@ -1203,6 +1215,12 @@ Options::Options()
     m_bracketThickness.Init(1.0, 0.5, 2.0);
     this->Register(&m_bracketThickness, "bracketThickness", &m_generalLayout);
 
+    m_breaksEstimate.SetInfo("Breaks estimate",
+        "Compute the page breaks with estimated system heights (faster, overflowing pages are broken again when "
+        "rendered, which can change the page count)");
+    m_breaksEstimate.Init(false);
+    this->Register(&m_breaksEstimate, "breaksEstimate", &m_generalLayout);
+
     m_breaksNoWidow.SetInfo(
         "Breaks no widow", "Prevent single measures on the last page by fitting it into previous system");
     m_breaksNoWidow.Init(false);
@@ -1738,6 +1756,21 @@ Options::Options()
     m_midiTempoAdjustment.Init(1.0, 0.2, 4.0);
     this->Register(&m_midiTempoAdjustment, "midiTempoAdjustment", &m_midi);
 
+    m_midiThreads.SetInfo("MIDI export threads", "The number of threads for exporting the staves (0 for all the cores)");
+    m_midiThreads.Init(0, 0, 64);
+    this->Register(&m_midiThreads, "midiThreads", &m_midi);
+
+    /********* output *********/
+
+    m_output.SetLabel("Output options", "6-output");
+    m_output.SetCategory(OptionsCategory::Output);
+    m_grps.push_back(&m_output);
+
+    m_pngBackground.SetInfo(
+        "PNG background colour", "The background colour of the PNG output (e.g., \"white\" or \"#ffffff\")");
+    m_pngBackground.Init("");
+    this->Register(&m_pngBackground, "pngBackground", &m_output);
+
     /********* Deprecated options *********/
 
     /*
@@ -1856,6 +1889,38 @@ void Options::Sync()
         [](const std::string &key) { LogError("Unsupported engraving default '%s'", key.c_str()); });
 }
 
+std::string Options::GetLayoutKey() const
+{
+    std::string values = m_scale.GetStrValue();
+    for (const OptionGrp *grp : m_grps) {
+        switch (grp->GetCategory()) {
+            case OptionsCategory::General:
+            case OptionsCategory::Layout:
+            case OptionsCategory::Margins:
+            case OptionsCategory::Selectors: break;
+            default: continue;
+        }
+        for (const Option *option : *grp->GetOptions()) {
+            if (this->IsOutputOnly(option->GetKey())) continue;
+            values += ";" + option->GetKey() + "=" + option->GetStrValue();
+        }
+    }
+    return values;
+}
+
+bool Options::IsOutputOnly(const std::string &key) const
+{
+    // The mm output changes the global styling but not the layout
+    static const std::set<std::string> outputOnlyOptions = { "outputIndent", "outputIndentTab", "svgBoundingBoxes",
+        "svgCss", "svgViewBox", "svgHtml5", "svgFormatRaw", "svgRemoveXlink", "svgAdditionalAttribute",
+        "svgGlyphSprite", "mmOutput" };
+    if (outputOnlyOptions.count(key) > 0) return true;
+
+    const std::vector<Option *> *options = m_output.GetOptions();
+    return std::any_of(
+        options->begin(), options->end(), [&key](const Option *option) { return (option->GetKey() == key); });
+}
+
 void Options::Register(Option *option, const std::string &key, OptionGrp *grp)
 {
     assert(option);
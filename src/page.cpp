@@ -160,13 +160,19 @@ void Page::LayOut(bool force)
         return;
     }
 
+    Doc *doc = vrv_cast<Doc *>(this->GetFirstAncestor(DOC));
+    assert(doc);
+
     this->LayOutHorizontally();
     this->JustifyHorizontally();
     this->LayOutVertically();
+    // With estimated breaks, the page is broken again once its exact height is known and laid out from the start
+    // since the systems left on it can end a page or a score differently
+    if (doc->GetOptions()->m_breaksEstimate.GetValue() && this->MoveOverflowingSystems(doc)) {
+        this->LayOut(true);
+        return;
+    }
     this->JustifyVertically();
-
-    Doc *doc = vrv_cast<Doc *>(this->GetFirstAncestor(DOC));
-    assert(doc);
     if (doc->GetOptions()->m_svgBoundingBoxes.GetValue()) {
         View view;
         view.SetDoc(doc);
@@ -482,7 +488,7 @@ void Page::LayOutHorizontallyWithCache(bool restore)
     this->Process(&cacheHorizontalLayout, &cacheHorizontalLayoutParams);
 }
 
-void Page::LayOutVertically()
+void Page::LayOutVertically(bool estimate)
 {
     Doc *doc = vrv_cast<Doc *>(this->GetFirstAncestor(DOC));
     assert(doc);
@@ -516,31 +522,34 @@ void Page::LayOutVertically()
     view.SetPage(this->GetIdx(), false);
     view.DrawCurrentPage(&bBoxDC, false);
 
-    // Adjust the position of outside articulations with slurs end and start positions
-    FunctorDocParams adjustArticWithSlursParams(doc);
-    Functor adjustArticWithSlurs(&Object::AdjustArticWithSlurs);
-    this->Process(&adjustArticWithSlurs, &adjustArticWithSlursParams);
-
-    // Adjust the position of the beams in regards of layer elements
-    AdjustBeamParams adjustBeamParams(doc);
-    Functor adjustBeams(&Object::AdjustBeams);
-    Functor adjustBeamsEnd(&Object::AdjustBeamsEnd);
-    this->Process(&adjustBeams, &adjustBeamParams, &adjustBeamsEnd);
-
-    // Adjust the position of the tuplets
-    FunctorDocParams adjustTupletsYParams(doc);
-    Functor adjustTupletsY(&Object::AdjustTupletsY);
-    this->Process(&adjustTupletsY, &adjustTupletsYParams);
-
-    // Adjust the position of the slurs
+    // The beams, tuplets and slurs are not adjusted and the page is drawn only once for an estimate
     Functor adjustSlurs(&Object::AdjustSlurs);
     AdjustSlursParams adjustSlursParams(doc, &adjustSlurs);
-    this->Process(&adjustSlurs, &adjustSlursParams);
+    if (!estimate) {
+        // Adjust the position of outside articulations with slurs end and start positions
+        FunctorDocParams adjustArticWithSlursParams(doc);
+        Functor adjustArticWithSlurs(&Object::AdjustArticWithSlurs);
+        this->Process(&adjustArticWithSlurs, &adjustArticWithSlursParams);
+
+        // Adjust the position of the beams in regards of layer elements
+        AdjustBeamParams adjustBeamParams(doc);
+        Functor adjustBeams(&Object::AdjustBeams);
+        Functor adjustBeamsEnd(&Object::AdjustBeamsEnd);
+        this->Process(&adjustBeams, &adjustBeamParams, &adjustBeamsEnd);
+
+        // Adjust the position of the tuplets
+        FunctorDocParams adjustTupletsYParams(doc);
+        Functor adjustTupletsY(&Object::AdjustTupletsY);
+        this->Process(&adjustTupletsY, &adjustTupletsYParams);
+
+        // Adjust the position of the slurs
+        this->Process(&adjustSlurs, &adjustSlursParams);
 
-    // At this point slurs must not be reinitialized, otherwise the adjustment we just did was in vain
-    view.SetSlurHandling(SlurHandling::Drawing);
-    view.SetPage(this->GetIdx(), false);
-    view.DrawCurrentPage(&bBoxDC, false);
+        // At this point slurs must not be reinitialized, otherwise the adjustment we just did was in vain
+        view.SetSlurHandling(SlurHandling::Drawing);
+        view.SetPage(this->GetIdx(), false);
+        view.DrawCurrentPage(&bBoxDC, false);
+    }
 
     // Fill the arrays of bounding boxes (above and below) for each staff alignment for which the box overflows.
     CalcBBoxOverflowsParams calcBBoxOverflowsParams(doc);
@@ -601,6 +610,48 @@ void Page::LayOutVertically()
     this->Process(&alignSystems, &alignSystemsParams, &alignSystemsEnd);
 }
 
+bool Page::MoveOverflowingSystems(Doc *doc)
+{
+    assert(doc);
+
+    if (m_drawingJustifiableHeight >= 0) return false;
+
+    // The systems are aligned from the top of the page content down to the footer
+    const int bottom = (this->GetFooter()) ? this->GetFooter()->GetTotalHeight(doc) : 0;
+
+    // Look for the first system ending below it, which is kept on the page if it is the first one
+    int idx = 0;
+    for (; idx < this->GetChildCount(); ++idx) {
+        if (!this->GetChild(idx)->Is(SYSTEM)) continue;
+        System *system = vrv_cast<System *>(this->GetChild(idx));
+        assert(system);
+        if ((system->GetDrawingYRel() - system->GetHeight() < bottom) && !system->IsFirstInPage()) break;
+    }
+    if (idx >= this->GetChildCount()) return false;
+
+    Object *pages = this->GetParent();
+    assert(pages);
+    Page *nextPage = vrv_cast<Page *>(pages->GetNext(this, PAGE));
+    if (!nextPage) {
+        nextPage = new Page();
+        pages->AddChild(nextPage);
+    }
+
+    // Move the systems and the page elements following them to the beginning of the next page
+    for (int nextIdx = 0; idx < this->GetChildCount(); ++nextIdx) {
+        Object *child = this->DetachChild(idx);
+        child->SetParent(nextPage);
+        nextPage->InsertChild(child, nextIdx);
+    }
+    nextPage->m_layoutDone = false;
+
+    // The scoreDefs at the beginning of the pages need to be set again. This rebuilds the drawing scoreDefs of all
+    // the systems and starts a new layout generation, so the pages already rendered are not replayed
+    doc->ScoreDefSetCurrentDoc(true);
+
+    return true;
+}
+
 void Page::JustifyHorizontally()
 {
     Doc *doc = vrv_cast<Doc *>(this->GetFirstAncestor(DOC));
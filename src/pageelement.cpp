@@ -84,6 +84,8 @@ int PageElement::CastOffEncoding(FunctorParams *functorParams)
     CastOffEncodingParams *params = vrv_params_cast<CastOffEncodingParams *>(functorParams);
     assert(params);
 
+    if (params->m_castOffLayout) params->m_doc->CastOffCachedBreak(this, params);
+
     MoveItselfTo(params->m_currentPage);
 
     return FUNCTOR_SIBLINGS;
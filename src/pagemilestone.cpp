@@ -125,6 +125,8 @@ int PageMilestoneEnd::CastOffEncoding(FunctorParams *functorParams)
         params->m_currentSystem = NULL;
     }
 
+    if (params->m_castOffLayout) params->m_doc->CastOffCachedBreak(this, params);
+
     MoveItselfTo(params->m_currentPage);
 
     return FUNCTOR_SIBLINGS;
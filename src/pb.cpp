@@ -53,6 +53,13 @@ int Pb::CastOffEncoding(FunctorParams *functorParams)
     CastOffEncodingParams *params = vrv_params_cast<CastOffEncodingParams *>(functorParams);
     assert(params);
 
+    // With a cached cast off the breaks are given by the cache and the <pb> is simply kept
+    if (params->m_castOffLayout) {
+        params->m_doc->CastOffCachedBreak(this, params);
+        MoveItselfTo(params->m_currentSystem);
+        return FUNCTOR_SIBLINGS;
+    }
+
     // We look if the current system has a pb or at least one measure - if yes, we assume that the <pb>
     // is not the one at the beginning of the content. This is not very robust but at least make it
     // work when rendering a <mdiv> that does not start with a <pb> (which we cannot force)
@@ -0,0 +1,1176 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        rasterdevicecontext.cpp
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "rasterdevicecontext.h"
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+//----------------------------------------------------------------------------
+
+#include "atts_shared.h"
+#include "glyph.h"
+#include "object.h"
+#include "resources.h"
+#include "vrv.h"
+
+//----------------------------------------------------------------------------
+
+namespace vrv {
+
+/** The opacity of the boxes drawn for the text characters without outlines */
+#define RASTER_TEXT_BOX_OPACITY 0.5
+
+//----------------------------------------------------------------------------
+// Static helpers
+//----------------------------------------------------------------------------
+
+/**
+ * Read a number in an SVG path, skipping the whitespaces and commas before it
+ */
+static bool ReadPathNumber(const std::string &path, size_t &pos, double &value)
+{
+    while ((pos < path.size()) && (isspace(path.at(pos)) || (path.at(pos) == ','))) ++pos;
+    if (pos >= path.size()) return false;
+
+    const char *start = path.c_str() + pos;
+    char *end = NULL;
+    value = strtod(start, &end);
+    if (end == start) return false;
+    pos += end - start;
+    return true;
+}
+
+/**
+ * Return the advance of a text glyph in drawing units
+ */
+static double GetTextAdvance(const Glyph *glyph, int pointSize)
+{
+    if (!glyph) return pointSize / 2.0;
+
+    int x, y, w, h;
+    glyph->GetBoundingBox(x, y, w, h);
+    const int advance = (glyph->GetHorizAdvX() > 0) ? glyph->GetHorizAdvX() : w;
+    return (double)advance * pointSize / glyph->GetUnitsPerEm();
+}
+
+//----------------------------------------------------------------------------
+// RasterDeviceContext::Matrix
+//----------------------------------------------------------------------------
+
+RasterDeviceContext::Matrix RasterDeviceContext::Matrix::Multiply(const Matrix &other) const
+{
+    Matrix result;
+    result.a = a * other.a + c * other.b;
+    result.b = b * other.a + d * other.b;
+    result.c = a * other.c + c * other.d;
+    result.d = b * other.c + d * other.d;
+    result.e = a * other.e + c * other.f + e;
+    result.f = b * other.e + d * other.f + f;
+    return result;
+}
+
+double RasterDeviceContext::Matrix::GetScale() const
+{
+    return sqrt(fabs(a * d - b * c));
+}
+
+//----------------------------------------------------------------------------
+// RasterDeviceContext
+//----------------------------------------------------------------------------
+
+RasterDeviceContext::RasterDeviceContext() : DeviceContext(RASTER_DEVICE_CONTEXT)
+{
+    m_pixelWidth = 0;
+    m_pixelHeight = 0;
+    m_backgroundColour = AxNONE;
+    m_accumulationStride = 0;
+
+    m_textX = 0.0;
+    m_textY = 0.0;
+    m_textAlignment = HORIZONTALALIGNMENT_left;
+
+    m_originX = 0;
+    m_originY = 0;
+
+    m_facsimileOutput = false;
+
+    // the graphic for the page, replaced when the page is started
+    m_graphics.push_back({ Matrix(), AxBLACK, false });
+}
+
+RasterDeviceContext::~RasterDeviceContext() {}
+
+void RasterDeviceContext::SetBackground(int colour, int style)
+{
+    // The background is filled when the page is started
+    m_backgroundColour = colour;
+}
+
+void RasterDeviceContext::SetTextForeground(int colour)
+{
+    m_brushStack.top().SetColour(colour); // we use the brush colour for text
+}
+
+void RasterDeviceContext::SetLogicalOrigin(int x, int y)
+{
+    m_originX = -x;
+    m_originY = -y;
+}
+
+Point RasterDeviceContext::GetLogicalOrigin()
+{
+    return Point(m_originX, m_originY);
+}
+
+void RasterDeviceContext::GetRGBA(std::vector<unsigned char> &output) const
+{
+    output.resize(m_pixels.size());
+    for (size_t i = 0; i < m_pixels.size(); i += 4) {
+        const int alpha = m_pixels.at(i + 3);
+        for (size_t j = 0; j < 3; ++j) {
+            output[i + j] = (alpha == 0) ? 0 : std::min(255, (m_pixels.at(i + j) * 255 + alpha / 2) / alpha);
+        }
+        output[i + 3] = alpha;
+    }
+}
+
+void RasterDeviceContext::StartPage()
+{
+    const double width = this->GetWidth();
+    const double height = this->GetHeight();
+    double viewWidth = width;
+    double viewHeight = height;
+    if (!m_facsimileOutput) {
+        viewWidth *= DEFINITION_FACTOR;
+        viewHeight = this->GetContentHeight() * DEFINITION_FACTOR;
+    }
+
+    m_pixelWidth = std::max(1, (int)ceil(width * this->GetUserScaleX()));
+    m_pixelHeight = std::max(1, (int)ceil(height * this->GetUserScaleY()));
+
+    // The content is scaled and centered as with the viewBox of the SVG
+    Matrix page;
+    if ((viewWidth > 0) && (viewHeight > 0)) {
+        const double scale = std::min(m_pixelWidth / viewWidth, m_pixelHeight / viewHeight);
+        page.a = scale;
+        page.d = scale;
+        page.e = (m_pixelWidth - viewWidth * scale) / 2 + m_originX * scale;
+        page.f = (m_pixelHeight - viewHeight * scale) / 2 + m_originY * scale;
+    }
+    m_graphics.clear();
+    m_graphics.push_back({ page, AxBLACK, false });
+
+    m_pixels.assign((size_t)m_pixelWidth * m_pixelHeight * 4, 0);
+    if (m_backgroundColour != AxNONE) {
+        for (size_t i = 0; i < m_pixels.size(); i += 4) {
+            m_pixels[i] = (m_backgroundColour >> 16) & 255;
+            m_pixels[i + 1] = (m_backgroundColour >> 8) & 255;
+            m_pixels[i + 2] = m_backgroundColour & 255;
+            m_pixels[i + 3] = 255;
+        }
+    }
+}
+
+void RasterDeviceContext::EndPage()
+{
+    this->FlushText();
+}
+
+void RasterDeviceContext::PushGraphic(Object *object)
+{
+    Graphic graphic = this->GetGraphic();
+
+    if (object && object->HasAttClass(ATT_COLOR)) {
+        AttColor *att = dynamic_cast<AttColor *>(object);
+        assert(att);
+        if (att->HasColor()) {
+            const int colour = ParseColour(att->GetColor());
+            if (colour != AxNONE) graphic.m_colour = colour;
+        }
+    }
+
+    if (object && object->HasAttClass(ATT_VISIBILITY)) {
+        AttVisibility *att = dynamic_cast<AttVisibility *>(object);
+        assert(att);
+        if (att->HasVisible()) {
+            graphic.m_hidden = (att->GetVisible() == BOOLEAN_false);
+        }
+    }
+
+    m_graphics.push_back(graphic);
+}
+
+void RasterDeviceContext::StartGraphic(
+    Object *object, std::string gClass, std::string gId, bool primary, bool prepend)
+{
+    this->PushGraphic(object);
+}
+
+void RasterDeviceContext::StartCustomGraphic(std::string name, std::string gClass, std::string gId)
+{
+    this->PushGraphic(NULL);
+}
+
+void RasterDeviceContext::ResumeGraphic(Object *object, std::string gId)
+{
+    this->PushGraphic(object);
+}
+
+void RasterDeviceContext::EndGraphic(Object *object, View *view)
+{
+    if (m_graphics.size() > 1) m_graphics.pop_back();
+}
+
+void RasterDeviceContext::EndCustomGraphic()
+{
+    if (m_graphics.size() > 1) m_graphics.pop_back();
+}
+
+void RasterDeviceContext::EndResumedGraphic(Object *object, View *view)
+{
+    if (m_graphics.size() > 1) m_graphics.pop_back();
+}
+
+void RasterDeviceContext::RotateGraphic(Point const &orig, double angle)
+{
+    // Same as rotate(angle, x, y) in SVG
+    const double radians = angle * M_PI / 180.0;
+    Matrix rotation;
+    rotation.a = cos(radians);
+    rotation.b = sin(radians);
+    rotation.c = -rotation.b;
+    rotation.d = rotation.a;
+    rotation.e = orig.x - rotation.a * orig.x + rotation.b * orig.y;
+    rotation.f = orig.y - rotation.b * orig.x - rotation.a * orig.y;
+
+    m_graphics.back().m_matrix = m_graphics.back().m_matrix.Multiply(rotation);
+}
+
+int RasterDeviceContext::GetPenColour() const
+{
+    if (m_penStack.empty() || (m_penStack.top().GetColour() == AxNONE)) return this->GetGraphic().m_colour;
+    return m_penStack.top().GetColour();
+}
+
+double RasterDeviceContext::GetPenOpacity() const
+{
+    return (m_penStack.empty()) ? 1.0 : m_penStack.top().GetOpacity();
+}
+
+double RasterDeviceContext::GetPenWidth() const
+{
+    return (m_penStack.empty()) ? 1.0 : m_penStack.top().GetWidth();
+}
+
+int RasterDeviceContext::GetBrushColour() const
+{
+    if (m_brushStack.empty() || (m_brushStack.top().GetColour() == AxNONE)) return this->GetGraphic().m_colour;
+    return m_brushStack.top().GetColour();
+}
+
+double RasterDeviceContext::GetBrushOpacity() const
+{
+    return (m_brushStack.empty()) ? 1.0 : m_brushStack.top().GetOpacity();
+}
+
+void RasterDeviceContext::AddCubicBezier(
+    Polygon &polygon, const Vertex &p0, const Vertex &p1, const Vertex &p2, const Vertex &p3)
+{
+    // The number of segments depends on the length of the control polygon in pixels
+    const double length = hypot(p1.x - p0.x, p1.y - p0.y) + hypot(p2.x - p1.x, p2.y - p1.y)
+        + hypot(p3.x - p2.x, p3.y - p2.y);
+    const int n = std::clamp((int)ceil(sqrt(length * 2.0)), 1, 100);
+
+    for (int i = 1; i <= n; ++i) {
+        const double t = (double)i / n;
+        const double mt = 1.0 - t;
+        const double c0 = mt * mt * mt;
+        const double c1 = 3.0 * mt * mt * t;
+        const double c2 = 3.0 * mt * t * t;
+        const double c3 = t * t * t;
+        polygon.push_back(
+            { c0 * p0.x + c1 * p1.x + c2 * p2.x + c3 * p3.x, c0 * p0.y + c1 * p1.y + c2 * p2.y + c3 * p3.y });
+    }
+}
+
+void RasterDeviceContext::AddEllipse(
+    Polygon &polygon, double cx, double cy, double rx, double ry, double start, double end) const
+{
+    // The angles are in degrees, counter-clockwise from the three-o'clock position
+    const Matrix &matrix = this->GetGraphic().m_matrix;
+    const double radius = std::max(fabs(rx), fabs(ry)) * matrix.GetScale();
+    const double fraction = fabs(end - start) / 360.0;
+    const int n = std::max(2, (int)ceil(std::clamp(sqrt(radius) * 4.0, 8.0, 256.0) * fraction));
+
+    for (int i = 0; i <= n; ++i) {
+        const double angle = (start + (end - start) * i / n) * M_PI / 180.0;
+        polygon.push_back(matrix.Apply(cx + rx * cos(angle), cy - ry * sin(angle)));
+    }
+}
+
+void RasterDeviceContext::AddContours(
+    std::vector<Polygon> &polygons, const std::vector<PathContour> &contours, const Matrix &matrix)
+{
+    for (const PathContour &contour : contours) {
+        Polygon polygon;
+        polygon.push_back(matrix.Apply(contour.m_start.x, contour.m_start.y));
+        for (const PathSegment &segment : contour.m_segments) {
+            const Vertex end = matrix.Apply(segment.m_end.x, segment.m_end.y);
+            if (segment.m_isLine) {
+                polygon.push_back(end);
+            }
+            else {
+                const Vertex start = polygon.back();
+                AddCubicBezier(polygon, start, matrix.Apply(segment.m_control1.x, segment.m_control1.y),
+                    matrix.Apply(segment.m_control2.x, segment.m_control2.y), end);
+            }
+        }
+        if (polygon.size() > 2) polygons.push_back(polygon);
+    }
+}
+
+void RasterDeviceContext::Fill(const std::vector<Polygon> &polygons, int colour, double opacity)
+{
+    if ((opacity <= 0.0) || m_pixels.empty()) return;
+
+    // Bounding box of the polygons clipped to the page
+    double minX = m_pixelWidth;
+    double minY = m_pixelHeight;
+    double maxX = 0.0;
+    double maxY = 0.0;
+    for (const Polygon &polygon : polygons) {
+        for (const Vertex &vertex : polygon) {
+            minX = std::min(minX, vertex.x);
+            minY = std::min(minY, vertex.y);
+            maxX = std::max(maxX, vertex.x);
+            maxY = std::max(maxY, vertex.y);
+        }
+    }
+    const int x0 = std::max(0, (int)floor(minX));
+    const int y0 = std::max(0, (int)floor(minY));
+    const int x1 = std::min(m_pixelWidth, (int)ceil(maxX));
+    const int y1 = std::min(m_pixelHeight, (int)ceil(maxY));
+    if ((x1 <= x0) || (y1 <= y0)) return;
+
+    const int width = x1 - x0;
+    const int height = y1 - y0;
+    m_accumulationStride = width + 3;
+    m_accumulation.assign((size_t)m_accumulationStride * height, 0.0f);
+
+    for (const Polygon &polygon : polygons) {
+        const size_t n = polygon.size();
+        for (size_t i = 0; i < n; ++i) {
+            const Vertex &p0 = polygon.at(i);
+            const Vertex &p1 = polygon.at((i + 1) % n);
+            this->AddEdge({ p0.x - x0, p0.y - y0 }, { p1.x - x0, p1.y - y0 }, width, height);
+        }
+    }
+
+    // Accumulate the coverage of each row and blend the colour over the pixels (premultiplied)
+    const int red = (colour >> 16) & 255;
+    const int green = (colour >> 8) & 255;
+    const int blue = colour & 255;
+    const double alpha = std::min(1.0, opacity);
+    for (int y = 0; y < height; ++y) {
+        const float *row = &m_accumulation[(size_t)y * m_accumulationStride];
+        unsigned char *pixel = &m_pixels[((size_t)(y0 + y) * m_pixelWidth + x0) * 4];
+        float accumulation = 0.0f;
+        for (int x = 0; x < width; ++x, pixel += 4) {
+            accumulation += row[x];
+            const double coverage = std::min(1.0f, fabsf(accumulation));
+            const int a = (int)(coverage * alpha * 255.0 + 0.5);
+            if (a == 0) continue;
+            const int inverse = 255 - a;
+            pixel[0] = (red * a + pixel[0] * inverse + 127) / 255;
+            pixel[1] = (green * a + pixel[1] * inverse + 127) / 255;
+            pixel[2] = (blue * a + pixel[2] * inverse + 127) / 255;
+            pixel[3] = (255 * a + pixel[3] * inverse + 127) / 255;
+        }
+    }
+}
+
+void RasterDeviceContext::AddEdge(Vertex p0, Vertex p1, int width, int height)
+{
+    if ((p0.x >= 0.0) && (p0.x <= width) && (p1.x >= 0.0) && (p1.x <= width)) {
+        this->AddClippedEdge(p0, p1, width, height);
+        return;
+    }
+
+    // Split the edge where it crosses the left and right borders and project the parts outside onto them
+    double ts[4] = { 0.0, 1.0, 1.0, 1.0 };
+    int count = 1;
+    if (p0.x != p1.x) {
+        for (double border : { 0.0, (double)width }) {
+            const double t = (border - p0.x) / (p1.x - p0.x);
+            if ((t > 0.0) && (t < 1.0)) ts[count++] = t;
+        }
+    }
+    ts[count++] = 1.0;
+    if ((count == 4) && (ts[1] > ts[2])) std::swap(ts[1], ts[2]);
+
+    for (int i = 0; i < count - 1; ++i) {
+        Vertex start = { p0.x + (p1.x - p0.x) * ts[i], p0.y + (p1.y - p0.y) * ts[i] };
+        Vertex end = { p0.x + (p1.x - p0.x) * ts[i + 1], p0.y + (p1.y - p0.y) * ts[i + 1] };
+        start.x = std::clamp(start.x, 0.0, (double)width);
+        end.x = std::clamp(end.x, 0.0, (double)width);
+        this->AddClippedEdge(start, end, width, height);
+    }
+}
+
+void RasterDeviceContext::AddClippedEdge(const Vertex &p0, const Vertex &p1, int width, int height)
+{
+    // Signed area accumulation of the edge, one row at a time
+    if (fabs(p0.y - p1.y) < 1e-9) return;
+
+    const bool down = (p0.y < p1.y);
+    const Vertex &top = down ? p0 : p1;
+    const Vertex &bottom = down ? p1 : p0;
+    const double direction = down ? 1.0 : -1.0;
+    const double dxdy = (bottom.x - top.x) / (bottom.y - top.y);
+
+    // The x positions are kept within the buffer despite rounding errors
+    double x = top.x;
+    if (top.y < 0.0) x -= top.y * dxdy;
+    x = std::clamp(x, 0.0, (double)width);
+    const int yStart = std::max(0, (int)top.y);
+    const int yEnd = std::min(height, (int)ceil(bottom.y));
+
+    for (int y = yStart; y < yEnd; ++y) {
+        float *row = &m_accumulation[(size_t)y * m_accumulationStride];
+        const double dy = std::min((double)(y + 1), bottom.y) - std::max((double)y, top.y);
+        const double xNext = std::clamp(x + dxdy * dy, 0.0, (double)width);
+        const double d = dy * direction;
+        const double x0 = std::min(x, xNext);
+        const double x1 = std::max(x, xNext);
+        const double x0Floor = floor(x0);
+        const int x0i = (int)x0Floor;
+        const double x1Ceil = ceil(x1);
+        const int x1i = (int)x1Ceil;
+        if (x1i <= x0i + 1) {
+            const double xmf = 0.5 * (x + xNext) - x0Floor;
+            row[x0i] += d - d * xmf;
+            row[x0i + 1] += d * xmf;
+        }
+        else {
+            const double s = 1.0 / (x1 - x0);
+            const double x0f = x0 - x0Floor;
+            const double a0 = 0.5 * s * (1.0 - x0f) * (1.0 - x0f);
+            const double x1f = x1 - x1Ceil + 1.0;
+            const double am = 0.5 * s * x1f * x1f;
+            row[x0i] += d * a0;
+            if (x1i == x0i + 2) {
+                row[x0i + 1] += d * (1.0 - a0 - am);
+            }
+            else {
+                const double a1 = s * (1.5 - x0f);
+                row[x0i + 1] += d * (a1 - a0);
+                for (int xi = x0i + 2; xi < x1i - 1; ++xi) {
+                    row[xi] += d * s;
+                }
+                const double a2 = a1 + (x1i - x0i - 3) * s;
+                row[x1i - 1] += d * (1.0 - a2 - am);
+            }
+            row[x1i] += d * am;
+        }
+        x = xNext;
+    }
+}
+
+void RasterDeviceContext::Stroke(const Polygon &polygon, bool closed, double width, int lineCap, int lineJoin,
+    int colour, double opacity, double dashLength, double gapLength)
+{
+    if ((width <= 0.0) || (polygon.size() < 2) || (opacity <= 0.0)) return;
+
+    // Split the path into dashes
+    std::vector<Polygon> pieces;
+    if ((dashLength > 0.0) && (gapLength > 0.0)) {
+        Polygon path = polygon;
+        if (closed) path.push_back(polygon.front());
+        closed = false;
+        Polygon current = { path.front() };
+        bool on = true;
+        double remaining = dashLength;
+        for (size_t i = 0; i + 1 < path.size(); ++i) {
+            const Vertex &p0 = path.at(i);
+            const Vertex &p1 = path.at(i + 1);
+            const double length = hypot(p1.x - p0.x, p1.y - p0.y);
+            double position = 0.0;
+            while (length - position > remaining) {
+                position += remaining;
+                const Vertex vertex
+                    = { p0.x + (p1.x - p0.x) * position / length, p0.y + (p1.y - p0.y) * position / length };
+                if (on) {
+                    current.push_back(vertex);
+                    pieces.push_back(current);
+                    current.clear();
+                }
+                else {
+                    current = { vertex };
+                }
+                on = !on;
+                remaining = on ? dashLength : gapLength;
+            }
+            remaining -= length - position;
+            if (on) current.push_back(p1);
+        }
+        if (on && (current.size() > 1)) pieces.push_back(current);
+    }
+    else {
+        pieces.push_back(polygon);
+    }
+
+    // Each segment is a rectangle and the joins and round caps are circles, all with the same orientation
+    const double halfWidth = width / 2.0;
+    const int circleSegments = std::clamp((int)ceil(sqrt(halfWidth) * 4.0), 8, 64);
+    std::vector<Polygon> outlines;
+    auto addCircle = [&outlines, halfWidth, circleSegments](const Vertex &center) {
+        Polygon circle;
+        for (int i = 0; i < circleSegments; ++i) {
+            const double angle = 2.0 * M_PI * i / circleSegments;
+            circle.push_back({ center.x + halfWidth * cos(angle), center.y - halfWidth * sin(angle) });
+        }
+        outlines.push_back(circle);
+    };
+
+    for (const Polygon &piece : pieces) {
+        const size_t n = piece.size();
+        const size_t segments = closed ? n : n - 1;
+        for (size_t i = 0; i < segments; ++i) {
+            const Vertex &p0 = piece.at(i);
+            const Vertex &p1 = piece.at((i + 1) % n);
+            const double length = hypot(p1.x - p0.x, p1.y - p0.y);
+            if (length < 1e-9) continue;
+            const double dx = (p1.x - p0.x) / length;
+            const double dy = (p1.y - p0.y) / length;
+            const double nx = -dy * halfWidth;
+            const double ny = dx * halfWidth;
+            const bool square = (lineCap == AxCAP_SQUARE) && !closed;
+            const double start = (square && (i == 0)) ? halfWidth : 0.0;
+            const double end = (square && (i == segments - 1)) ? halfWidth : 0.0;
+            const Vertex a = { p0.x - dx * start, p0.y - dy * start };
+            const Vertex b = { p1.x + dx * end, p1.y + dy * end };
+            outlines.push_back({ { a.x + nx, a.y + ny }, { b.x + nx, b.y + ny }, { b.x - nx, b.y - ny },
+                { a.x - nx, a.y - ny } });
+        }
+        // Joins are approximated with round joins, which is not visible on thin lines
+        if ((width > 1.5) && (lineJoin != AxJOIN_BEVEL)) {
+            for (size_t i = (closed ? 0 : 1); i < (closed ? n : n - 1); ++i) {
+                addCircle(piece.at(i));
+            }
+        }
+        if ((lineCap == AxCAP_ROUND) && !closed) {
+            addCircle(piece.front());
+            addCircle(piece.back());
+        }
+    }
+
+    this->Fill(outlines, colour, opacity);
+}
+
+void RasterDeviceContext::StrokeWithPen(
+    const Polygon &polygon, bool closed, int defaultLineCap, int defaultLineJoin, bool withDashes)
+{
+    // Lines are always stroked, with a width of at least one unit as in SVG
+    const double scale = this->GetGraphic().m_matrix.GetScale();
+    const double width = std::max(1.0, this->GetPenWidth()) * scale;
+    int lineCap = defaultLineCap;
+    int lineJoin = defaultLineJoin;
+    double dashLength = 0.0;
+    double gapLength = 0.0;
+    if (!m_penStack.empty()) {
+        const Pen &pen = m_penStack.top();
+        if (pen.GetLineCap() != AxCAP_UNKNOWN) lineCap = pen.GetLineCap();
+        if (pen.GetLineJoin() != AxJOIN_UNKNOWN) lineJoin = pen.GetLineJoin();
+        if (withDashes) {
+            dashLength = pen.GetDashLength() * scale;
+            gapLength = pen.GetGapLength() * scale;
+        }
+    }
+    this->Stroke(polygon, closed, width, lineCap, lineJoin, this->GetPenColour(), this->GetPenOpacity(), dashLength,
+        gapLength);
+}
+
+void RasterDeviceContext::DrawQuadBezierPath(Point bezier[3])
+{
+    if (this->GetGraphic().m_hidden) return;
+
+    const Matrix &matrix = this->GetGraphic().m_matrix;
+    const Vertex p0 = matrix.Apply(bezier[0].x, bezier[0].y);
+    const Vertex q = matrix.Apply(bezier[1].x, bezier[1].y);
+    const Vertex p3 = matrix.Apply(bezier[2].x, bezier[2].y);
+    Polygon polygon = { p0 };
+    AddCubicBezier(polygon, p0, { p0.x + 2.0 / 3.0 * (q.x - p0.x), p0.y + 2.0 / 3.0 * (q.y - p0.y) },
+        { p3.x + 2.0 / 3.0 * (q.x - p3.x), p3.y + 2.0 / 3.0 * (q.y - p3.y) }, p3);
+
+    // The stroke width is not adjusted to one unit for curves
+    const double scale = matrix.GetScale();
+    const Pen pen = (m_penStack.empty()) ? Pen(AxNONE, 1, 1.0, 0, 0, 0, 0) : m_penStack.top();
+    this->Stroke(polygon, false, pen.GetWidth() * scale, AxCAP_ROUND, AxJOIN_ROUND, this->GetPenColour(),
+        this->GetPenOpacity(), pen.GetDashLength() * scale, pen.GetGapLength() * scale);
+}
+
+void RasterDeviceContext::DrawCubicBezierPath(Point bezier[4])
+{
+    if (this->GetGraphic().m_hidden) return;
+
+    const Matrix &matrix = this->GetGraphic().m_matrix;
+    const Vertex p0 = matrix.Apply(bezier[0].x, bezier[0].y);
+    Polygon polygon = { p0 };
+    AddCubicBezier(polygon, p0, matrix.Apply(bezier[1].x, bezier[1].y), matrix.Apply(bezier[2].x, bezier[2].y),
+        matrix.Apply(bezier[3].x, bezier[3].y));
+
+    const double scale = matrix.GetScale();
+    const Pen pen = (m_penStack.empty()) ? Pen(AxNONE, 1, 1.0, 0, 0, 0, 0) : m_penStack.top();
+    this->Stroke(polygon, false, pen.GetWidth() * scale, AxCAP_ROUND, AxJOIN_ROUND, this->GetPenColour(),
+        this->GetPenOpacity(), pen.GetDashLength() * scale, pen.GetGapLength() * scale);
+}
+
+void RasterDeviceContext::DrawCubicBezierPathFilled(Point bezier1[4], Point bezier2[4])
+{
+    if (this->GetGraphic().m_hidden) return;
+
+    // Same path as in SVG, where the second curve goes back from the end of the first one
+    const Matrix &matrix = this->GetGraphic().m_matrix;
+    const Vertex p0 = matrix.Apply(bezier1[0].x, bezier1[0].y);
+    const Vertex p1 = matrix.Apply(bezier1[3].x, bezier1[3].y);
+    Polygon polygon = { p0 };
+    AddCubicBezier(polygon, p0, matrix.Apply(bezier1[1].x, bezier1[1].y), matrix.Apply(bezier1[2].x, bezier1[2].y), p1);
+    AddCubicBezier(polygon, p1, matrix.Apply(bezier2[2].x, bezier2[2].y), matrix.Apply(bezier2[1].x, bezier2[1].y),
+        matrix.Apply(bezier2[0].x, bezier2[0].y));
+
+    this->Fill({ polygon }, this->GetGraphic().m_colour, 1.0);
+
+    const double width = (m_penStack.empty()) ? 1.0 : m_penStack.top().GetWidth();
+    this->Stroke(polygon, false, width * matrix.GetScale(), AxCAP_ROUND, AxJOIN_ROUND, this->GetPenColour(),
+        this->GetPenOpacity());
+}
+
+void RasterDeviceContext::DrawCircle(int x, int y, int radius)
+{
+    this->DrawEllipse(x - radius, y - radius, 2 * radius, 2 * radius);
+}
+
+void RasterDeviceContext::DrawEllipse(int x, int y, int width, int height)
+{
+    if (this->GetGraphic().m_hidden) return;
+
+    const int rw = width / 2;
+    const int rh = height / 2;
+
+    Polygon polygon;
+    this->AddEllipse(polygon, x + rw, y + rh, rw, rh, 0.0, 360.0);
+    polygon.pop_back();
+
+    this->Fill({ polygon }, this->GetBrushColour(), this->GetBrushOpacity());
+    if (this->GetPenWidth() > 0) {
+        this->Stroke(polygon, true, this->GetPenWidth() * this->GetGraphic().m_matrix.GetScale(), AxCAP_BUTT,
+            AxJOIN_ROUND, this->GetPenColour(), this->GetPenOpacity());
+    }
+}
+
+void RasterDeviceContext::DrawEllipticArc(int x, int y, int width, int height, double start, double end)
+{
+    if (this->GetGraphic().m_hidden) return;
+
+    const double rx = width / 2;
+    const double ry = height / 2;
+    if (start == end) end = start + 360.0;
+
+    Polygon polygon;
+    this->AddEllipse(polygon, x + rx, y + ry, rx, ry, start, end);
+
+    this->Fill({ polygon }, this->GetBrushColour(), this->GetBrushOpacity());
+    if (this->GetPenWidth() > 0) {
+        this->Stroke(polygon, false, this->GetPenWidth() * this->GetGraphic().m_matrix.GetScale(), AxCAP_BUTT,
+            AxJOIN_ROUND, this->GetPenColour(), this->GetPenOpacity());
+    }
+}
+
+void RasterDeviceContext::DrawLine(int x1, int y1, int x2, int y2)
+{
+    if (this->GetGraphic().m_hidden) return;
+
+    const Matrix &matrix = this->GetGraphic().m_matrix;
+    this->StrokeWithPen({ matrix.Apply(x1, y1), matrix.Apply(x2, y2) }, false);
+}
+
+void RasterDeviceContext::DrawPolyline(int n, Point points[], int xOffset, int yOffset)
+{
+    if (this->GetGraphic().m_hidden || (this->GetPenWidth() <= 0)) return;
+
+    const Matrix &matrix = this->GetGraphic().m_matrix;
+    Polygon polygon;
+    for (int i = 0; i < n; ++i) {
+        polygon.push_back(matrix.Apply(points[i].x + xOffset, points[i].y + yOffset));
+    }
+    this->StrokeWithPen(polygon, false);
+}
+
+void RasterDeviceContext::DrawPolygon(int n, Point points[], int xOffset, int yOffset)
+{
+    if (this->GetGraphic().m_hidden) return;
+
+    const Matrix &matrix = this->GetGraphic().m_matrix;
+    Polygon polygon;
+    for (int i = 0; i < n; ++i) {
+        polygon.push_back(matrix.Apply(points[i].x + xOffset, points[i].y + yOffset));
+    }
+
+    this->Fill({ polygon }, this->GetBrushColour(), this->GetBrushOpacity());
+    if (this->GetPenWidth() > 0) this->StrokeWithPen(polygon, true);
+}
+
+void RasterDeviceContext::DrawRectangle(int x, int y, int width, int height)
+{
+    this->DrawRoundedRectangle(x, y, width, height, 0);
+}
+
+void RasterDeviceContext::DrawRoundedRectangle(int x, int y, int width, int height, int radius)
+{
+    if (this->GetGraphic().m_hidden) return;
+
+    if (height < 0) {
+        height = -height;
+        y -= height;
+    }
+    if (width < 0) {
+        width = -width;
+        x -= width;
+    }
+
+    const Matrix &matrix = this->GetGraphic().m_matrix;
+    Polygon polygon;
+    radius = std::min(radius, std::min(width, height) / 2);
+    if (radius > 0) {
+        this->AddEllipse(polygon, x + width - radius, y + radius, radius, radius, 0.0, 90.0);
+        this->AddEllipse(polygon, x + radius, y + radius, radius, radius, 90.0, 180.0);
+        this->AddEllipse(polygon, x + radius, y + height - radius, radius, radius, 180.0, 270.0);
+        this->AddEllipse(polygon, x + width - radius, y + height - radius, radius, radius, 270.0, 360.0);
+    }
+    else {
+        polygon = { matrix.Apply(x, y), matrix.Apply(x + width, y), matrix.Apply(x + width, y + height),
+            matrix.Apply(x, y + height) };
+    }
+
+    this->Fill({ polygon }, this->GetBrushColour(), this->GetBrushOpacity());
+    if (this->GetPenWidth() > 0) this->StrokeWithPen(polygon, true, AxCAP_BUTT, AxJOIN_MITER, false);
+}
+
+void RasterDeviceContext::StartText(int x, int y, data_HORIZONTALALIGNMENT alignment)
+{
+    this->FlushText();
+    m_textX = x;
+    m_textY = y;
+    m_textAlignment = alignment;
+}
+
+void RasterDeviceContext::MoveTextTo(int x, int y, data_HORIZONTALALIGNMENT alignment)
+{
+    this->FlushText();
+    m_textX = x;
+    m_textY = y;
+    if (alignment != HORIZONTALALIGNMENT_NONE) m_textAlignment = alignment;
+}
+
+void RasterDeviceContext::MoveTextVerticallyTo(int y)
+{
+    // The text continues horizontally after the previous one
+    this->FlushText();
+    m_textY = y;
+}
+
+void RasterDeviceContext::EndText()
+{
+    this->FlushText();
+}
+
+void RasterDeviceContext::DrawText(
+    const std::string &text, const std::wstring &wtext, int x, int y, int width, int height)
+{
+    assert(m_fontStack.top());
+
+    // The rectangle for syllables has no visible output
+    const bool hasRectangle = (width != 0) && (width != VRV_UNSET) && (height != 0) && (height != VRV_UNSET);
+    if ((x != 0) && (y != 0) && (x != VRV_UNSET) && (y != VRV_UNSET) && !hasRectangle) {
+        this->FlushText();
+        m_textX = x;
+        m_textY = y;
+    }
+
+    m_textRuns.push_back({ wtext.empty() ? UTF8to16(text) : wtext, *m_fontStack.top(), this->GetGraphic() });
+}
+
+void RasterDeviceContext::FlushText()
+{
+    const Resources *resources = this->GetResources();
+    if (m_textRuns.empty() || !resources) {
+        m_textRuns.clear();
+        return;
+    }
+
+    // The alignment applies to the whole chunk
+    double width = 0.0;
+    for (const TextRun &run : m_textRuns) {
+        resources->SelectTextFont(run.m_font.GetWeight(), run.m_font.GetStyle());
+        for (wchar_t c : run.m_text) {
+            width += GetTextAdvance(resources->GetTextGlyph(c), run.m_font.GetPointSize());
+        }
+    }
+    double x = m_textX;
+    if (m_textAlignment == HORIZONTALALIGNMENT_center) {
+        x -= width / 2;
+    }
+    else if (m_textAlignment == HORIZONTALALIGNMENT_right) {
+        x -= width;
+    }
+
+    for (const TextRun &run : m_textRuns) {
+        const int pointSize = run.m_font.GetPointSize();
+        resources->SelectTextFont(run.m_font.GetWeight(), run.m_font.GetStyle());
+        for (wchar_t c : run.m_text) {
+            const Glyph *textGlyph = resources->GetTextGlyph(c);
+            const double advance = GetTextAdvance(textGlyph, pointSize);
+            if (run.m_graphic.m_hidden || !textGlyph) {
+                x += advance;
+                continue;
+            }
+
+            int gx, gy, gw, gh;
+            textGlyph->GetBoundingBox(gx, gy, gw, gh);
+            const double unitsPerEm = textGlyph->GetUnitsPerEm();
+
+            // SMuFL characters are drawn with the music font, scaled to the width of the text font glyph
+            const Glyph *glyph = ((c >= 0xE000) && (c <= 0xF8FF)) ? resources->GetGlyph(c) : NULL;
+            if (glyph) {
+                int mx, my, mw, mh;
+                glyph->GetBoundingBox(mx, my, mw, mh);
+                double size = pointSize;
+                if ((mw > 0) && (gw > 0)) {
+                    size *= (gw / unitsPerEm) / ((double)mw / glyph->GetUnitsPerEm());
+                }
+                this->DrawGlyph(glyph, x, m_textY, size, 1.0, run.m_graphic);
+            }
+            // Other characters are drawn as shaded boxes
+            else if ((gw > 0) && (gh > 0)) {
+                const Matrix &matrix = run.m_graphic.m_matrix;
+                const double left = x + gx * pointSize / unitsPerEm;
+                const double right = left + gw * pointSize / unitsPerEm;
+                const double bottom = m_textY - gy * pointSize / unitsPerEm;
+                const double top = bottom - gh * pointSize / unitsPerEm;
+                const Polygon box = { matrix.Apply(left, top), matrix.Apply(right, top), matrix.Apply(right, bottom),
+                    matrix.Apply(left, bottom) };
+                this->Fill({ box }, run.m_graphic.m_colour, RASTER_TEXT_BOX_OPACITY);
+            }
+            x += advance;
+        }
+    }
+
+    m_textX = x;
+    m_textRuns.clear();
+}
+
+void RasterDeviceContext::DrawMusicText(const std::wstring &text, int x, int y, bool setSmuflGlyph)
+{
+    assert(m_fontStack.top());
+
+    const Resources *resources = this->GetResources();
+    assert(resources);
+
+    const Graphic &graphic = this->GetGraphic();
+    if (graphic.m_hidden) return;
+
+    int w, h, gx, gy;
+    const int pointSize = m_fontStack.top()->GetPointSize();
+    const double ratio = m_fontStack.top()->GetWidthToHeightRatio();
+
+    // print chars one by one
+    for (unsigned int i = 0; i < text.length(); ++i) {
+        wchar_t c = text.at(i);
+        const Glyph *glyph = resources->GetGlyph(c);
+        if (!glyph) {
+            continue;
+        }
+
+        this->DrawGlyph(glyph, x, y, pointSize, ratio, graphic);
+
+        // Get the bounds of the char
+        if (glyph->GetHorizAdvX() > 0)
+            x += glyph->GetHorizAdvX() * pointSize / glyph->GetUnitsPerEm();
+        else {
+            glyph->GetBoundingBox(gx, gy, w, h);
+            x += w * pointSize / glyph->GetUnitsPerEm();
+        }
+    }
+}
+
+void RasterDeviceContext::DrawGlyph(
+    const Glyph *glyph, double x, double y, double size, double ratio, const Graphic &graphic)
+{
+    double unitsPerEm = 1000.0;
+    const std::vector<PathContour> &contours = this->GetGlyphContours(glyph, unitsPerEm);
+    if (contours.empty()) return;
+
+    // The glyph paths are flipped vertically and scaled to the size as with the SVG symbols
+    Matrix glyphMatrix;
+    glyphMatrix.a = ratio * size / unitsPerEm;
+    glyphMatrix.d = -size / unitsPerEm;
+    glyphMatrix.e = x;
+    glyphMatrix.f = y;
+
+    std::vector<Polygon> polygons;
+    this->AddContours(polygons, contours, graphic.m_matrix.Multiply(glyphMatrix));
+    this->Fill(polygons, graphic.m_colour, 1.0);
+}
+
+const std::vector<RasterDeviceContext::PathContour> &RasterDeviceContext::GetGlyphContours(
+    const Glyph *glyph, double &unitsPerEm)
+{
+    auto iter = m_glyphContours.find(glyph);
+    if (iter == m_glyphContours.end()) {
+        std::pair<std::vector<PathContour>, double> entry = { {}, 1000.0 };
+        const Resources *resources = this->GetResources();
+        const pugi::xml_document *sourceDoc = (resources) ? resources->GetGlyphDefinition(glyph) : NULL;
+        if (sourceDoc) {
+            pugi::xml_node symbol = sourceDoc->first_child();
+            const std::string viewBox = symbol.attribute("viewBox").value();
+            if (viewBox.find_last_of(' ') != std::string::npos) {
+                entry.second = atof(viewBox.substr(viewBox.find_last_of(' ')).c_str());
+            }
+            ParsePath(symbol.child("path").attribute("d").value(), entry.first);
+        }
+        iter = m_glyphContours.emplace(glyph, entry).first;
+    }
+    unitsPerEm = iter->second.second;
+    return iter->second.first;
+}
+
+void RasterDeviceContext::ParsePath(const std::string &path, std::vector<PathContour> &contours)
+{
+    size_t pos = 0;
+    char command = 0;
+    char previousCommand = 0;
+    Vertex current = { 0.0, 0.0 };
+    Vertex subpathStart = { 0.0, 0.0 };
+    Vertex lastControl = { 0.0, 0.0 };
+    bool closed = true;
+
+    while (true) {
+        while ((pos < path.size()) && (isspace(path.at(pos)) || (path.at(pos) == ','))) ++pos;
+        if (pos >= path.size()) break;
+
+        if (isalpha(path.at(pos))) {
+            previousCommand = command;
+            command = path.at(pos++);
+            if ((command == 'Z') || (command == 'z')) {
+                current = subpathStart;
+                closed = true;
+                continue;
+            }
+        }
+        else if (command == 0) {
+            LogWarning("Invalid SVG path '%s'", path.c_str());
+            return;
+        }
+        else {
+            previousCommand = command;
+        }
+
+        const bool relative = islower(command);
+        const char upper = toupper(command);
+        double values[7];
+        int count = 0;
+        switch (upper) {
+            case 'M':
+            case 'L':
+            case 'T': count = 2; break;
+            case 'H':
+            case 'V': count = 1; break;
+            case 'C': count = 6; break;
+            case 'S':
+            case 'Q': count = 4; break;
+            case 'A': count = 7; break;
+            default: LogWarning("Unsupported SVG path command '%c'", command); return;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (!ReadPathNumber(path, pos, values[i])) return;
+        }
+
+        // Convert the coordinates to absolute ones
+        if (relative) {
+            if (upper == 'H') {
+                values[0] += current.x;
+            }
+            else if (upper == 'V') {
+                values[0] += current.y;
+            }
+            else if (upper == 'A') {
+                values[5] += current.x;
+                values[6] += current.y;
+            }
+            else {
+                for (int i = 0; i < count; i += 2) {
+                    values[i] += current.x;
+                    values[i + 1] += current.y;
+                }
+            }
+        }
+
+        if (upper == 'M') {
+            contours.push_back({ { values[0], values[1] }, {} });
+            current = subpathStart = { values[0], values[1] };
+            closed = false;
+            // Following coordinate pairs are lines
+            command = relative ? 'l' : 'L';
+            continue;
+        }
+
+        // Drawing after a closepath starts a new subpath at the same point
+        if (closed) {
+            contours.push_back({ current, {} });
+            subpathStart = current;
+            closed = false;
+        }
+
+        PathSegment segment = { true, current, current, current };
+        const char previousUpper = toupper(previousCommand);
+        switch (upper) {
+            case 'L': segment.m_end = { values[0], values[1] }; break;
+            case 'H': segment.m_end = { values[0], current.y }; break;
+            case 'V': segment.m_end = { current.x, values[0] }; break;
+            // Arcs are replaced by lines
+            case 'A': segment.m_end = { values[5], values[6] }; break;
+            case 'C':
+                segment = { false, { values[0], values[1] }, { values[2], values[3] }, { values[4], values[5] } };
+                lastControl = segment.m_control2;
+                break;
+            case 'S':
+                segment = { false, current, { values[0], values[1] }, { values[2], values[3] } };
+                if ((previousUpper == 'C') || (previousUpper == 'S')) {
+                    segment.m_control1 = { 2 * current.x - lastControl.x, 2 * current.y - lastControl.y };
+                }
+                lastControl = segment.m_control2;
+                break;
+            case 'Q':
+            case 'T': {
+                // Quadratic curves are converted to cubic ones
+                Vertex control = current;
+                if (upper == 'Q') {
+                    control = { values[0], values[1] };
+                    segment.m_end = { values[2], values[3] };
+                }
+                else {
+                    if ((previousUpper == 'Q') || (previousUpper == 'T')) {
+                        control = { 2 * current.x - lastControl.x, 2 * current.y - lastControl.y };
+                    }
+                    segment.m_end = { values[0], values[1] };
+                }
+                const Vertex &end = segment.m_end;
+                segment.m_isLine = false;
+                segment.m_control1 = { current.x + 2.0 / 3.0 * (control.x - current.x),
+                    current.y + 2.0 / 3.0 * (control.y - current.y) };
+                segment.m_control2
+                    = { end.x + 2.0 / 3.0 * (control.x - end.x), end.y + 2.0 / 3.0 * (control.y - end.y) };
+                lastControl = control;
+                break;
+            }
+            default: break;
+        }
+
+        contours.back().m_segments.push_back(segment);
+        current = segment.m_end;
+    }
+}
+
+void RasterDeviceContext::DrawSvgShape(int x, int y, int width, int height, pugi::xml_node svg)
+{
+    if (this->GetGraphic().m_hidden) return;
+
+    Matrix shape;
+    shape.a = DEFINITION_FACTOR;
+    shape.d = DEFINITION_FACTOR;
+    shape.e = x;
+    shape.f = y;
+
+    this->DrawSvgNode(svg, this->GetGraphic().m_matrix.Multiply(shape));
+}
+
+void RasterDeviceContext::DrawSvgNode(pugi::xml_node node, const Matrix &matrix)
+{
+    // Only the paths are drawn
+    for (pugi::xml_node child : node.children()) {
+        if (std::string(child.name()) != "path") {
+            this->DrawSvgNode(child, matrix);
+            continue;
+        }
+
+        std::vector<PathContour> contours;
+        ParsePath(child.attribute("d").value(), contours);
+        std::vector<Polygon> polygons;
+        this->AddContours(polygons, contours, matrix);
+
+        const std::string fill = child.attribute("fill").value();
+        if (fill != "none") {
+            const int colour = ParseColour(fill);
+            this->Fill(polygons, (colour == AxNONE) ? this->GetGraphic().m_colour : colour, 1.0);
+        }
+        const std::string stroke = child.attribute("stroke").value();
+        if (!stroke.empty() && (stroke != "none")) {
+            const int colour = ParseColour(stroke);
+            const double width = child.attribute("stroke-width").as_double(1.0) * matrix.GetScale();
+            for (const Polygon &polygon : polygons) {
+                this->Stroke(polygon, false, width, AxCAP_BUTT, AxJOIN_MITER,
+                    (colour == AxNONE) ? this->GetGraphic().m_colour : colour, 1.0);
+            }
+        }
+    }
+}
+
+int RasterDeviceContext::ParseColour(const std::string &colour)
+{
+    static const std::map<std::string, int> colourNames = { { "black", 0x000000 }, { "white", 0xFFFFFF },
+        { "red", 0xFF0000 }, { "green", 0x008000 }, { "blue", 0x0000FF }, { "yellow", 0xFFFF00 },
+        { "cyan", 0x00FFFF }, { "aqua", 0x00FFFF }, { "magenta", 0xFF00FF }, { "fuchsia", 0xFF00FF },
+        { "gray", 0x808080 }, { "grey", 0x808080 }, { "silver", 0xC0C0C0 }, { "maroon", 0x800000 },
+        { "olive", 0x808000 }, { "lime", 0x00FF00 }, { "teal", 0x008080 }, { "navy", 0x000080 },
+        { "purple", 0x800080 }, { "orange", 0xFFA500 }, { "brown", 0xA52A2A }, { "pink", 0xFFC0CB },
+        { "darkred", 0x8B0000 }, { "darkgreen", 0x006400 }, { "darkblue", 0x00008B }, { "darkgray", 0xA9A9A9 },
+        { "darkgrey", 0xA9A9A9 }, { "lightgray", 0xD3D3D3 }, { "lightgrey", 0xD3D3D3 } };
+
+    if (colour.empty()) return AxNONE;
+
+    if (colour.at(0) == '#') {
+        const std::string hex = colour.substr(1);
+        if (hex.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) return AxNONE;
+        if (hex.size() == 6) return (int)strtol(hex.c_str(), NULL, 16);
+        if (hex.size() == 3) {
+            const int value = (int)strtol(hex.c_str(), NULL, 16);
+            const int red = (value >> 8) & 15;
+            const int green = (value >> 4) & 15;
+            const int blue = value & 15;
+            return (red * 17) << 16 | (green * 17) << 8 | (blue * 17);
+        }
+        return AxNONE;
+    }
+
+    int red, green, blue;
+    if (sscanf(colour.c_str(), "rgb(%d ,%d ,%d )", &red, &green, &blue) == 3) {
+        return std::clamp(red, 0, 255) << 16 | std::clamp(green, 0, 255) << 8 | std::clamp(blue, 0, 255);
+    }
+
+    std::string name = colour;
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    auto iter = colourNames.find(name);
+    return (iter != colourNames.end()) ? iter->second : AxNONE;
+}
+
+} // namespace vrv
@@ -9,7 +9,13 @@
 
 //----------------------------------------------------------------------------
 
+#include <algorithm>
+#include <cassert>
+
+//----------------------------------------------------------------------------
+
 #include "smufl.h"
+#include "vrv.h"
 #include "vrvdef.h"
 
 //----------------------------------------------------------------------------
@@ -23,6 +29,10 @@ namespace vrv {
 //----------------------------------------------------------------------------
 
 thread_local std::string Resources::s_defaultPath = "/usr/local/share/verovio";
+Resources::FontFileMap Resources::s_fontFiles;
+std::mutex Resources::s_fontFilesMutex;
+Resources::XMLDocumentMap Resources::s_xmlDocuments;
+std::mutex Resources::s_xmlDocumentsMutex;
 const Resources::StyleAttributes Resources::k_defaultStyle{ data_FONTWEIGHT::FONTWEIGHT_normal,
     data_FONTSTYLE::FONTSTYLE_normal };
 
@@ -34,6 +44,7 @@ Resources::Resources()
 {
     m_path = s_defaultPath;
     m_currentStyle = k_defaultStyle;
+    m_fontGlyphIndex.resize(k_glyphIndexEnd - k_glyphIndexStart, NULL);
 }
 
 bool Resources::InitFonts()
@@ -44,8 +55,10 @@ bool Resources::InitFonts()
     // The Leipzig as the default font
     if (!LoadFont("Leipzig")) LogError("Leipzig font could not be loaded.");
 
-    if (m_fontGlyphTable.size() < SMUFL_COUNT) {
-        LogError("Expected %d default SMuFL glyphs but could load only %d.", SMUFL_COUNT, m_fontGlyphTable.size());
+    const int glyphCount = (int)m_fontGlyphTable.size()
+        + (int)std::count_if(m_fontGlyphIndex.begin(), m_fontGlyphIndex.end(), [](const Glyph *glyph) { return glyph; });
+    if (glyphCount < SMUFL_COUNT) {
+        LogError("Expected %d default SMuFL glyphs but could load only %d.", SMUFL_COUNT, glyphCount);
         return false;
     }
 
@@ -82,17 +95,27 @@ bool Resources::SetFont(const std::string &fontName)
 
 const Glyph *Resources::GetGlyph(wchar_t smuflCode) const
 {
-    return m_fontGlyphTable.count(smuflCode) ? &m_fontGlyphTable.at(smuflCode) : NULL;
+    if ((smuflCode >= k_glyphIndexStart) && (smuflCode < k_glyphIndexEnd)) {
+        return m_fontGlyphIndex[smuflCode - k_glyphIndexStart];
+    }
+    GlyphPointerTable::const_iterator iter = m_fontGlyphTable.find(smuflCode);
+    return (iter != m_fontGlyphTable.end()) ? iter->second : NULL;
 }
 
 const Glyph *Resources::GetGlyph(const std::string &smuflName) const
 {
-    return m_glyphNameTable.count(smuflName) ? &m_fontGlyphTable.at(m_glyphNameTable.at(smuflName)) : NULL;
+    const wchar_t smuflCode = this->GetGlyphCode(smuflName);
+    return (smuflCode != 0) ? this->GetGlyph(smuflCode) : NULL;
 }
 
 wchar_t Resources::GetGlyphCode(const std::string &smuflName) const
 {
-    return m_glyphNameTable.count(smuflName) ? m_glyphNameTable.at(smuflName) : 0;
+    // Look in the last font loaded first
+    for (auto fontFile = m_fontFiles.rbegin(); fontFile != m_fontFiles.rend(); ++fontFile) {
+        GlyphNameTable::const_iterator iter = (*fontFile)->m_glyphNameTable.find(smuflName);
+        if (iter != (*fontFile)->m_glyphNameTable.end()) return iter->second;
+    }
+    return 0;
 }
 
 void Resources::SelectTextFont(data_FONTWEIGHT fontWeight, data_FONTSTYLE fontStyle) const
@@ -117,31 +140,143 @@ const Glyph *Resources::GetTextGlyph(wchar_t code) const
     const StyleAttributes style = (m_textFont.count(m_currentStyle) != 0) ? m_currentStyle : k_defaultStyle;
     if (m_textFont.count(style) == 0) return NULL;
 
-    const GlyphTable &currentTable = m_textFont.at(style);
-    if (currentTable.count(code) == 0) {
+    const GlyphPointerTable &currentTable = m_textFont.at(style);
+    GlyphPointerTable::const_iterator iter = currentTable.find(code);
+    if (iter == currentTable.end()) {
+        return NULL;
+    }
+
+    return iter->second;
+}
+
+const pugi::xml_document *Resources::GetGlyphDefinition(const Glyph *glyph) const
+{
+    assert(glyph);
+
+    return GetCachedXMLDocument(this->GetPath(), glyph->GetPath());
+}
+
+const pugi::xml_document *Resources::GetWoffDefinition() const
+{
+    return GetCachedXMLDocument(this->GetPath(), "woff.xml");
+}
+
+bool Resources::LoadResourceFile(pugi::xml_document &doc, const std::string &name) const
+{
+    return LoadFile(doc, this->GetPath(), name);
+}
+
+const pugi::xml_document *Resources::GetCachedXMLDocument(const std::string &path, const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(s_xmlDocumentsMutex);
+
+    const std::string filename = path + "/" + name;
+    XMLDocumentMap::iterator iter = s_xmlDocuments.find(filename);
+    if (iter != s_xmlDocuments.end()) return iter->second.get();
+
+    std::unique_ptr<pugi::xml_document> doc = std::make_unique<pugi::xml_document>();
+    if (!LoadFile(*doc, path, name)) {
+        LogError("Failed to load '%s'", filename.c_str());
+        // Failures are not cached since the file can be added later
         return NULL;
     }
+    // The documents are never removed and are only read once loaded, so they can be used without the lock
+    return s_xmlDocuments.emplace(filename, std::move(doc)).first->second.get();
+}
 
-    return &currentTable.at(code);
+bool Resources::LoadFile(pugi::xml_document &doc, const std::string &path, const std::string &name)
+{
+#ifdef EMBED_RESOURCES
+    const EmbeddedFileMap &embeddedFiles = GetEmbeddedFiles();
+    EmbeddedFileMap::const_iterator iter = embeddedFiles.find(name);
+    if (iter != embeddedFiles.end()) {
+        return doc.load_buffer(iter->second.first, iter->second.second);
+    }
+#endif
+    const std::string filename = path + "/" + name;
+    return doc.load_file(filename.c_str());
 }
 
 bool Resources::LoadFont(const std::string &fontName)
+{
+    SharedFontFile fontFile = GetFontFile(this->GetPath(), fontName + ".xml", false);
+    if (!fontFile) return false;
+
+    // Loading a font again moves it to the end, which gives it the precedence as when overlaying its glyphs
+    m_fontFiles.erase(std::remove(m_fontFiles.begin(), m_fontFiles.end(), fontFile), m_fontFiles.end());
+    m_fontFiles.push_back(fontFile);
+
+    for (const auto &glyph : fontFile->m_glyphTable) {
+        this->AddGlyph(glyph.first, &glyph.second);
+    }
+
+    return true;
+}
+
+void Resources::AddGlyph(wchar_t smuflCode, const Glyph *glyph)
+{
+    if ((smuflCode >= k_glyphIndexStart) && (smuflCode < k_glyphIndexEnd)) {
+        m_fontGlyphIndex[smuflCode - k_glyphIndexStart] = glyph;
+    }
+    else {
+        m_fontGlyphTable[smuflCode] = glyph;
+    }
+}
+
+bool Resources::InitTextFont(const std::string &fontName, const StyleAttributes &style)
+{
+    // For now, we have only Times bounding boxes for ASCII chars
+    // For any other char, we currently use 'o' bounding box
+    SharedFontFile fontFile = GetFontFile(this->GetPath(), "text/" + fontName + ".xml", true);
+    if (!fontFile) return false;
+
+    if (std::find(m_textFontFiles.begin(), m_textFontFiles.end(), fontFile) == m_textFontFiles.end()) {
+        m_textFontFiles.push_back(fontFile);
+    }
+
+    GlyphPointerTable &currentTable = m_textFont[style];
+    for (const auto &glyph : fontFile->m_glyphTable) {
+        if (currentTable.count(glyph.first) > 0) {
+            LogDebug("Redefining %d with %s", glyph.first, fontName.c_str());
+        }
+        currentTable[glyph.first] = &glyph.second;
+    }
+    return true;
+}
+
+Resources::SharedFontFile Resources::GetFontFile(const std::string &path, const std::string &name, bool isTextFont)
+{
+    std::lock_guard<std::mutex> lock(s_fontFilesMutex);
+
+    const std::string filename = path + "/" + name;
+    FontFileMap::iterator iter = s_fontFiles.find(filename);
+    if (iter != s_fontFiles.end()) return iter->second;
+
+    SharedFontFile fontFile = (isTextFont) ? ParseTextFontFile(path, name) : ParseFontFile(path, name);
+    // Failures are not cached since the file can be added later
+    if (fontFile) s_fontFiles[filename] = fontFile;
+    return fontFile;
+}
+
+Resources::SharedFontFile Resources::ParseFontFile(const std::string &path, const std::string &name)
 {
     pugi::xml_document doc;
-    const std::string filename = Resources::GetPath() + "/" + fontName + ".xml";
-    pugi::xml_parse_result parseResult = doc.load_file(filename.c_str());
-    if (!parseResult) {
+    if (!LoadFile(doc, path, name)) {
         // File not found, default bounding boxes will be used
         LogError("Failed to load font and glyph bounding boxes");
-        return false;
+        return NULL;
     }
     pugi::xml_node root = doc.first_child();
     if (!root.attribute("units-per-em")) {
         LogError("No units-per-em attribute in bouding box file");
-        return false;
+        return NULL;
     }
 
     const int unitsPerEm = atoi(root.attribute("units-per-em").value());
+    // The glyph XML files are in a directory with the name of the font
+    const std::string fontDir = name.substr(0, name.size() - 4);
+
+    std::shared_ptr<FontFile> fontFile = std::make_shared<FontFile>();
 
     for (pugi::xml_node current = root.child("g"); current; current = current.next_sibling("g")) {
         pugi::xml_attribute c_attribute = current.attribute("c");
@@ -157,7 +292,7 @@ bool Resources::LoadFont(const std::string &fontName)
         if (current.attribute("w")) width = current.attribute("w").as_float();
         if (current.attribute("h")) height = current.attribute("h").as_float();
         glyph.SetBoundingBox(x, y, width, height);
-        glyph.SetPath(Resources::GetPath() + "/" + fontName + "/" + c_attribute.value() + ".xml");
+        glyph.SetPath(fontDir + "/" + c_attribute.value() + ".xml");
         if (current.attribute("h-a-x")) glyph.SetHorizAdvX(current.attribute("h-a-x").as_float());
 
         // load anchors
@@ -172,37 +307,32 @@ bool Resources::LoadFont(const std::string &fontName)
         }
 
         const wchar_t smuflCode = (wchar_t)strtol(c_attribute.value(), NULL, 16);
-        m_fontGlyphTable[smuflCode] = glyph;
-        m_glyphNameTable[n_attribute.value()] = smuflCode;
+        fontFile->m_glyphTable[smuflCode] = glyph;
+        fontFile->m_glyphNameTable[n_attribute.value()] = smuflCode;
     }
 
-    return true;
+    return fontFile;
 }
 
-bool Resources::InitTextFont(const std::string &fontName, const StyleAttributes &style)
+Resources::SharedFontFile Resources::ParseTextFontFile(const std::string &path, const std::string &name)
 {
     // For the text font, we load the bounding boxes only
     pugi::xml_document doc;
-    // For now, we have only Times bounding boxes for ASCII chars
-    // For any other char, we currently use 'o' bounding box
-    std::string filename = GetPath() + "/text/" + fontName + ".xml";
-    pugi::xml_parse_result result = doc.load_file(filename.c_str());
-    if (!result) {
+    if (!LoadFile(doc, path, name)) {
         // File not found, default bounding boxes will be used
-        LogMessage("Cannot load bounding boxes for text font '%s'", filename.c_str());
-        return false;
+        LogMessage("Cannot load bounding boxes for text font '%s/%s'", path.c_str(), name.c_str());
+        return NULL;
     }
     pugi::xml_node root = doc.first_child();
     if (!root.attribute("units-per-em")) {
         LogWarning("No units-per-em attribute in bouding box file");
-        return false;
+        return NULL;
     }
     const int unitsPerEm = root.attribute("units-per-em").as_int();
+
+    std::shared_ptr<FontFile> fontFile = std::make_shared<FontFile>();
+
     pugi::xml_node current;
-    if (m_textFont.count(style) == 0) {
-        m_textFont[style] = {};
-    }
-    GlyphTable &currentTable = m_textFont.at(style);
     for (current = root.child("g"); current; current = current.next_sibling("g")) {
         if (current.attribute("c")) {
             wchar_t code = (wchar_t)strtol(current.attribute("c").value(), NULL, 16);
@@ -218,13 +348,10 @@ bool Resources::InitTextFont(const std::string &fontName, const StyleAttributes
             glyph.SetBoundingBox(x, y, width, height);
 
             if (current.attribute("h-a-x")) glyph.SetHorizAdvX(current.attribute("h-a-x").as_float());
-            if (currentTable.count(code) > 0) {
-                LogDebug("Redefining %d with %s", code, fontName.c_str());
-            }
-            currentTable[code] = glyph;
+            fontFile->m_glyphTable[code] = glyph;
         }
     }
-    return true;
+    return fontFile;
 }
 
 } // namespace vrv
@@ -340,9 +340,8 @@ void RunningElement::LoadFooter(const Doc *doc)
     Svg *svg = new Svg();
 
     const Resources &resources = doc->GetResources();
-    const std::string footerPath = resources.GetPath() + "/footer.svg";
     pugi::xml_document footerDoc;
-    footerDoc.load_file(footerPath.c_str());
+    resources.LoadResourceFile(footerDoc, "footer.svg");
     svg->Set(footerDoc.first_child());
     fig->AddChild(svg);
     fig->SetHalign(HORIZONTALALIGNMENT_center);
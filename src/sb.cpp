@@ -53,6 +53,13 @@ int Sb::CastOffEncoding(FunctorParams *functorParams)
     CastOffEncodingParams *params = vrv_params_cast<CastOffEncodingParams *>(functorParams);
     assert(params);
 
+    // With a cached cast off the breaks are given by the cache and the <sb> is simply kept
+    if (params->m_castOffLayout) {
+        params->m_doc->CastOffCachedBreak(this, params);
+        MoveItselfTo(params->m_currentSystem);
+        return FUNCTOR_SIBLINGS;
+    }
+
     // We look if the current system has a least one measure - if yes, we assume that the <sb>
     // is not the one at the beginning of the content (<mdiv>). This is not very robust but at least make it
     // work when rendering a <mdiv> that does not start with a <pb> or a <sb> (which we cannot enforce)
@@ -778,6 +778,8 @@ int ScoreDef::CastOffEncoding(FunctorParams *functorParams)
     CastOffEncodingParams *params = vrv_params_cast<CastOffEncodingParams *>(functorParams);
     assert(params);
 
+    if (params->m_castOffLayout) params->m_doc->CastOffCachedBreak(this, params);
+
     MoveItselfTo(params->m_currentSystem);
 
     return FUNCTOR_SIBLINGS;
@@ -822,9 +824,15 @@ int ScoreDef::GenerateMIDI(FunctorParams *functorParams)
         Object *next = parent->GetNext(this);
         if (next && next->Is(MEASURE)) {
             Measure *nextMeasure = vrv_cast<Measure *>(next);
-            totalTime = nextMeasure->GetLastTimeOffset();
+            totalTime = nextMeasure->GetScoreTimeOffset(params->m_repeat);
+            if (params->m_chunk) {
+                if (totalTime >= params->m_chunk->m_endTime) return FUNCTOR_STOP;
+                totalTime -= params->m_chunk->m_startTime;
+            }
         }
     }
+    // The values of a scoreDef before a chunk are set at its start
+    if (params->m_chunk) totalTime = std::max(0.0, totalTime);
     const double currentTick = totalTime * params->m_midiFile->getTPQ();
 
     smf::MidiEvent midiEvent;
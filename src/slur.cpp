@@ -213,8 +213,9 @@ void Slur::CalcSpannedElements(FloatingCurvePositioner *curve)
 
 SpannedElements Slur::CollectSpannedElements(const Staff *staff, int xMin, int xMax) const
 {
-    // Decide whether we search the whole parent system or just one measure which is much faster
-    const Object *container = this->IsSpanningMeasures() ? staff->GetFirstAncestor(SYSTEM) : this->GetStartMeasure();
+    // The system restricts the search to the measures spanned by the slur
+    const System *system = vrv_cast<const System *>(staff->GetFirstAncestor(SYSTEM));
+    assert(system);
 
     FindSpannedLayerElementsParams findSpannedLayerElementsParams(this);
     findSpannedLayerElementsParams.m_minPos = xMin;
@@ -235,8 +236,7 @@ SpannedElements Slur::CollectSpannedElements(const Staff *staff, int xMin, int x
     findSpannedLayerElementsParams.m_staffNs = staffNumbers;
 
     // Run the search without layer bounds
-    Functor findSpannedLayerElements(&Object::FindSpannedLayerElements);
-    container->Process(&findSpannedLayerElements, &findSpannedLayerElementsParams);
+    system->FindSpannedLayerElements(&findSpannedLayerElementsParams);
 
     // Now determine the minimal and maximal layer
     std::set<int> layersN;
@@ -313,7 +313,7 @@ SpannedElements Slur::CollectSpannedElements(const Staff *staff, int xMin, int x
             findSpannedLayerElementsParams.m_elements.clear();
             findSpannedLayerElementsParams.m_minLayerN = minLayerN;
             findSpannedLayerElementsParams.m_maxLayerN = maxLayerN;
-            container->Process(&findSpannedLayerElements, &findSpannedLayerElementsParams);
+            system->FindSpannedLayerElements(&findSpannedLayerElementsParams);
         }
     }
 
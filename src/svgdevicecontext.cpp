@@ -9,7 +9,9 @@
 
 //----------------------------------------------------------------------------
 
+#include <algorithm>
 #include <cassert>
+#include <charconv>
 
 //----------------------------------------------------------------------------
 
@@ -29,6 +31,23 @@ namespace vrv {
 #define space " "
 #define semicolon ";"
 
+//----------------------------------------------------------------------------
+// SvgStringWriter
+//----------------------------------------------------------------------------
+
+/**
+ * A pugi::xml_writer appending the output directly to a string.
+ */
+class SvgStringWriter : public pugi::xml_writer {
+public:
+    SvgStringWriter(std::string &output) : m_output(output) {}
+
+    void write(const void *data, size_t size) override { m_output.append(static_cast<const char *>(data), size); }
+
+private:
+    std::string &m_output;
+};
+
 //----------------------------------------------------------------------------
 // SvgDeviceContext
 //----------------------------------------------------------------------------
@@ -55,6 +74,11 @@ SvgDeviceContext::SvgDeviceContext() : DeviceContext(SVG_DEVICE_CONTEXT)
     m_facsimile = false;
     m_indent = 2;
 
+    m_multiPage = false;
+    m_pageCount = 0;
+    m_multiPageWidth = 0.0;
+    m_multiPageHeight = 0.0;
+
     // create the initial SVG element
     // width and height need to be set later; these are taken care of in "commit"
     m_svgNode = m_svgDoc.append_child("svg");
@@ -69,6 +93,7 @@ SvgDeviceContext::SvgDeviceContext() : DeviceContext(SVG_DEVICE_CONTEXT)
     m_currentNode = m_svgNode;
 
     m_outdata.clear();
+    m_valueBuffer.reserve(256);
 
     m_glyphPostfixId = Object::GenerateRandID();
 }
@@ -94,6 +119,12 @@ void SvgDeviceContext::Commit(bool xml_declaration)
     double width = (double)this->GetWidth() * this->GetUserScaleX();
     const char *format = "%gpx";
 
+    // with several pages, the size is the one of the stacked pages
+    if (m_multiPage) {
+        height = m_multiPageHeight;
+        width = m_multiPageWidth;
+    }
+
     if (m_mmOutput) {
         height /= 10;
         width /= 10;
@@ -111,33 +142,41 @@ void SvgDeviceContext::Commit(bool xml_declaration)
     // add the woff VerovioText font if needed
     const Resources *resources = this->GetResources(true);
     if (m_vrvTextFont && resources) {
-        const std::string woffPath = resources->GetPath() + "/woff.xml";
-        pugi::xml_document woffDoc;
-        woffDoc.load_file(woffPath.c_str());
-        m_svgNode.prepend_copy(woffDoc.first_child());
+        const pugi::xml_document *woffDoc = resources->GetWoffDefinition();
+        if (woffDoc) m_svgNode.prepend_copy(woffDoc->first_child());
+    }
+
+    // header - the glyphs are in the sprite when referenced with an href
+    if ((m_smuflGlyphs.size() > 0) && m_glyphHref.empty()) {
+        this->AppendGlyphDefinitions(m_svgNode.prepend_child("defs"));
     }
 
-    // header
-    if (m_smuflGlyphs.size() > 0) {
+    this->SaveDocument(xml_declaration);
 
-        pugi::xml_node defs = m_svgNode.prepend_child("defs");
-        pugi::xml_document sourceDoc;
+    m_committed = true;
+}
 
-        // for each needed glyph
-        for (auto it = m_smuflGlyphs.begin(); it != m_smuflGlyphs.end(); ++it) {
-            // load the XML file that contains it as a pugi::xml_document
-            std::ifstream source((*it)->GetPath());
-            sourceDoc.load(source);
+void SvgDeviceContext::AppendGlyphDefinitions(pugi::xml_node node)
+{
+    const Resources *resources = this->GetResources(true);
 
-            // copy all the nodes inside into the master document
-            for (pugi::xml_node child = sourceDoc.first_child(); child; child = child.next_sibling()) {
-                std::string id = StringFormat("%s-%s", child.attribute("id").value(), m_glyphPostfixId.c_str());
-                child.attribute("id").set_value(id.c_str());
-                defs.append_copy(child);
-            }
+    // for each needed glyph
+    for (auto it = m_smuflGlyphs.begin(); it != m_smuflGlyphs.end(); ++it) {
+        // get the parsed XML file that contains it from the resources
+        const pugi::xml_document *sourceDoc = (resources) ? resources->GetGlyphDefinition(it->second) : NULL;
+        if (!sourceDoc) continue;
+
+        // copy all the nodes inside into the master document
+        for (pugi::xml_node child = sourceDoc->first_child(); child; child = child.next_sibling()) {
+            pugi::xml_node def = node.append_copy(child);
+            std::string id = StringFormat("%s-%s", child.attribute("id").value(), m_glyphPostfixId.c_str());
+            def.attribute("id").set_value(id.c_str());
         }
     }
+}
 
+void SvgDeviceContext::SaveDocument(bool xml_declaration)
+{
     unsigned int output_flags = pugi::format_default | pugi::format_no_declaration;
     if (xml_declaration) {
         // edit the xml declaration
@@ -159,9 +198,13 @@ void SvgDeviceContext::Commit(bool xml_declaration)
 
     // save the glyph data to m_outdata
     std::string indent = (m_indent == -1) ? "\t" : std::string(m_indent, ' ');
-    m_svgDoc.save(m_outdata, indent.c_str(), output_flags);
+    SvgStringWriter writer(m_outdata);
+    m_svgDoc.save(writer, indent.c_str(), output_flags);
+}
 
-    m_committed = true;
+void SvgDeviceContext::AddGlyphs(const SvgDeviceContext &svg)
+{
+    m_smuflGlyphs.insert(svg.m_smuflGlyphs.begin(), svg.m_smuflGlyphs.end());
 }
 
 void SvgDeviceContext::StartGraphic(Object *object, std::string gClass, std::string gId, bool primary, bool prepend)
@@ -181,8 +224,10 @@ void SvgDeviceContext::StartGraphic(Object *object, std::string gClass, std::str
         m_currentNode = m_currentNode.append_child("g");
     }
     m_svgNodeStack.push_back(m_currentNode);
+    gId = this->GetGraphicId(object, gId);
     AppendIdAndClass(gId, object->GetClassName(), gClass, primary);
     AppendAdditionalAttributes(object);
+    if (!gId.empty() && (m_html5 || primary)) m_graphicNodes.emplace(gId, m_currentNode);
 
     // this sets staffDef styles for lyrics
     if (object->Is(STAFF)) {
@@ -285,13 +330,14 @@ void SvgDeviceContext::StartCustomGraphic(std::string name, std::string gClass,
     m_currentNode = m_currentNode.append_child("g");
     m_svgNodeStack.push_back(m_currentNode);
     AppendIdAndClass(gId, name, gClass);
+    if (!gId.empty()) m_graphicNodes.emplace(gId, m_currentNode);
 }
 
 void SvgDeviceContext::StartTextGraphic(Object *object, std::string gClass, std::string gId)
 {
     m_currentNode = AppendChild("tspan");
     m_svgNodeStack.push_back(m_currentNode);
-    AppendIdAndClass(gId, object->GetClassName(), gClass);
+    AppendIdAndClass(this->GetGraphicId(object, gId), object->GetClassName(), gClass);
     AppendAdditionalAttributes(object);
 
     if (object->HasAttClass(ATT_COLOR)) {
@@ -342,11 +388,10 @@ void SvgDeviceContext::StartTextGraphic(Object *object, std::string gClass, std:
 
 void SvgDeviceContext::ResumeGraphic(Object *object, std::string gId)
 {
-    std::string xpathPrefix = m_html5 ? "//g[@data-id=\"" : "//g[@id=\"";
-    std::string xpath = xpathPrefix + gId + "\"]";
-    pugi::xpath_node selection = m_currentNode.select_node(xpath.c_str());
-    if (selection) {
-        m_currentNode = selection.node();
+    // look for the graphic in the nodes created so far instead of evaluating an xpath query on the document
+    std::map<std::string, pugi::xml_node>::iterator iter = m_graphicNodes.find(this->GetGraphicId(object, gId));
+    if (iter != m_graphicNodes.end()) {
+        m_currentNode = iter->second;
     }
     m_svgNodeStack.push_back(m_currentNode);
 }
@@ -389,10 +434,13 @@ void SvgDeviceContext::RotateGraphic(Point const &orig, double angle)
 void SvgDeviceContext::StartPage()
 {
     // Initialize the flag to false because we want to know if the font needs to be included in the SVG
-    m_vrvTextFont = false;
+    // With several pages, the styles and the font are added only once
+    const bool firstPage = (m_pageCount == 0);
+    if (firstPage) m_vrvTextFont = false;
+    ++m_pageCount;
 
     // default styles
-    if (this->UseGlobalStyling()) {
+    if (this->UseGlobalStyling() && firstPage) {
         m_currentNode = m_currentNode.append_child("style");
         m_currentNode.append_attribute("type") = "text/css";
         m_currentNode.append_child(pugi::node_pcdata)
@@ -405,7 +453,7 @@ void SvgDeviceContext::StartPage()
         m_currentNode = m_svgNodeStack.back();
     }
 
-    if (!m_css.empty()) {
+    if (!m_css.empty() && firstPage) {
         m_currentNode = m_currentNode.append_child("style");
         m_currentNode.append_attribute("type") = "text/css";
         m_currentNode.append_child(pugi::node_pcdata).set_value(m_css.c_str());
@@ -427,6 +475,21 @@ void SvgDeviceContext::StartPage()
                                                         .c_str();
     }
 
+    // stack the page below the previous ones, in the units of the root element
+    if (m_multiPage) {
+        const double width = (double)this->GetWidth() * this->GetUserScaleX();
+        const double height = (double)this->GetHeight() * this->GetUserScaleY();
+        const double factor = (m_mmOutput) ? 0.1 : 1.0;
+        const char *format = (m_svgViewBox) ? "%g" : ((m_mmOutput) ? "%gmm" : "%gpx");
+        m_currentNode.append_attribute("y") = StringFormat(format, m_multiPageHeight * factor).c_str();
+        m_currentNode.append_attribute("width") = StringFormat(format, width * factor).c_str();
+        m_currentNode.append_attribute("height") = StringFormat(format, height * factor).c_str();
+        m_multiPageWidth = std::max(m_multiPageWidth, width);
+        m_multiPageHeight += height;
+    }
+    // the graphic nodes are resumed within the page
+    m_graphicNodes.clear();
+
     // page rectangle - for debugging
     // pugi::xml_node pageRect = m_currentNode.append_child("rect");
     // pageRect.append_attribute("fill") = "pink";
@@ -539,10 +602,13 @@ void SvgDeviceContext::AppendStrokeDashArray(pugi::xml_node node, const Pen &pen
 void SvgDeviceContext::DrawQuadBezierPath(Point bezier[3])
 {
     pugi::xml_node pathChild = AppendChild("path");
-    pathChild.append_attribute("d") = StringFormat("M%d,%d Q%d,%d %d,%d", // Base string
-        bezier[0].x, bezier[0].y, // M Command
-        bezier[1].x, bezier[1].y, bezier[2].x, bezier[2].y)
-                                          .c_str();
+    m_valueBuffer = "M";
+    AppendPoint(m_valueBuffer, bezier[0]);
+    m_valueBuffer += " Q";
+    AppendPoint(m_valueBuffer, bezier[1]);
+    m_valueBuffer += ' ';
+    AppendPoint(m_valueBuffer, bezier[2]);
+    pathChild.append_attribute("d") = m_valueBuffer.c_str();
     pathChild.append_attribute("fill") = "none";
     pathChild.append_attribute("stroke") = this->GetColour(m_penStack.top().GetColour()).c_str();
     pathChild.append_attribute("stroke-linecap") = "round";
@@ -554,11 +620,15 @@ void SvgDeviceContext::DrawQuadBezierPath(Point bezier[3])
 void SvgDeviceContext::DrawCubicBezierPath(Point bezier[4])
 {
     pugi::xml_node pathChild = AppendChild("path");
-    pathChild.append_attribute("d") = StringFormat("M%d,%d C%d,%d %d,%d %d,%d", // Base string
-        bezier[0].x, bezier[0].y, // M Command
-        bezier[1].x, bezier[1].y, bezier[2].x, bezier[2].y, bezier[3].x, bezier[3].y // Remaining bezier points.
-        )
-                                          .c_str();
+    m_valueBuffer = "M";
+    AppendPoint(m_valueBuffer, bezier[0]);
+    m_valueBuffer += " C";
+    AppendPoint(m_valueBuffer, bezier[1]);
+    m_valueBuffer += ' ';
+    AppendPoint(m_valueBuffer, bezier[2]);
+    m_valueBuffer += ' ';
+    AppendPoint(m_valueBuffer, bezier[3]);
+    pathChild.append_attribute("d") = m_valueBuffer.c_str();
     pathChild.append_attribute("fill") = "none";
     pathChild.append_attribute("stroke") = this->GetColour(m_penStack.top().GetColour()).c_str();
     pathChild.append_attribute("stroke-linecap") = "round";
@@ -570,12 +640,24 @@ void SvgDeviceContext::DrawCubicBezierPath(Point bezier[4])
 void SvgDeviceContext::DrawCubicBezierPathFilled(Point bezier1[4], Point bezier2[4])
 {
     pugi::xml_node pathChild = AppendChild("path");
-    pathChild.append_attribute("d")
-        = StringFormat("M%d,%d C%d,%d %d,%d %d,%d C%d,%d %d,%d %d,%d", bezier1[0].x, bezier1[0].y, // M command
-            bezier1[1].x, bezier1[1].y, bezier1[2].x, bezier1[2].y, bezier1[3].x, bezier1[3].y, // First bezier
-            bezier2[2].x, bezier2[2].y, bezier2[1].x, bezier2[1].y, bezier2[0].x, bezier2[0].y // Second Bezier
-            )
-              .c_str();
+    // M command
+    m_valueBuffer = "M";
+    AppendPoint(m_valueBuffer, bezier1[0]);
+    // First bezier
+    m_valueBuffer += " C";
+    AppendPoint(m_valueBuffer, bezier1[1]);
+    m_valueBuffer += ' ';
+    AppendPoint(m_valueBuffer, bezier1[2]);
+    m_valueBuffer += ' ';
+    AppendPoint(m_valueBuffer, bezier1[3]);
+    // Second bezier
+    m_valueBuffer += " C";
+    AppendPoint(m_valueBuffer, bezier2[2]);
+    m_valueBuffer += ' ';
+    AppendPoint(m_valueBuffer, bezier2[1]);
+    m_valueBuffer += ' ';
+    AppendPoint(m_valueBuffer, bezier2[0]);
+    pathChild.append_attribute("d") = m_valueBuffer.c_str();
     // pathChild.append_attribute("fill") = "currentColor";
     // pathChild.append_attribute("fill-opacity") = "1";
     pathChild.append_attribute("stroke") = this->GetColour(m_penStack.top().GetColour()).c_str();
@@ -688,7 +770,15 @@ void SvgDeviceContext::DrawEllipticArc(int x, int y, int width, int height, doub
 void SvgDeviceContext::DrawLine(int x1, int y1, int x2, int y2)
 {
     pugi::xml_node pathChild = AppendChild("path");
-    pathChild.append_attribute("d") = StringFormat("M%d %d L%d %d", x1, y1, x2, y2).c_str();
+    m_valueBuffer = "M";
+    AppendInt(m_valueBuffer, x1);
+    m_valueBuffer += ' ';
+    AppendInt(m_valueBuffer, y1);
+    m_valueBuffer += " L";
+    AppendInt(m_valueBuffer, x2);
+    m_valueBuffer += ' ';
+    AppendInt(m_valueBuffer, y2);
+    pathChild.append_attribute("d") = m_valueBuffer.c_str();
     pathChild.append_attribute("stroke") = this->GetColour(m_penStack.top().GetColour()).c_str();
     if (m_penStack.top().GetWidth() > 1) pathChild.append_attribute("stroke-width") = m_penStack.top().GetWidth();
     this->AppendStrokeLineCap(pathChild, m_penStack.top());
@@ -706,7 +796,7 @@ void SvgDeviceContext::DrawPolyline(int n, Point points[], int xOffset, int yOff
         polylineChild.append_attribute("stroke") = this->GetColour(currentPen.GetColour()).c_str();
     }
     if (currentPen.GetWidth() > 1) {
-        polylineChild.append_attribute("stroke-width") = StringFormat("%d", currentPen.GetWidth()).c_str();
+        polylineChild.append_attribute("stroke-width") = currentPen.GetWidth();
     }
     if (currentPen.GetOpacity() != 1.0) {
         polylineChild.append_attribute("stroke-opacity") = StringFormat("%f", currentPen.GetOpacity()).c_str();
@@ -718,11 +808,14 @@ void SvgDeviceContext::DrawPolyline(int n, Point points[], int xOffset, int yOff
 
     polylineChild.append_attribute("fill") = "none";
 
-    std::string pointsString;
+    m_valueBuffer.clear();
     for (int i = 0; i < n; ++i) {
-        pointsString += StringFormat("%d,%d ", points[i].x + xOffset, points[i].y + yOffset);
+        AppendInt(m_valueBuffer, points[i].x + xOffset);
+        m_valueBuffer += ',';
+        AppendInt(m_valueBuffer, points[i].y + yOffset);
+        m_valueBuffer += ' ';
     }
-    polylineChild.append_attribute("points") = pointsString.c_str();
+    polylineChild.append_attribute("points") = m_valueBuffer.c_str();
 }
 
 void SvgDeviceContext::DrawPolygon(int n, Point points[], int xOffset, int yOffset)
@@ -739,7 +832,7 @@ void SvgDeviceContext::DrawPolygon(int n, Point points[], int xOffset, int yOffs
         polygonChild.append_attribute("stroke") = this->GetColour(currentPen.GetColour()).c_str();
     }
     if (currentPen.GetWidth() > 1) {
-        polygonChild.append_attribute("stroke-width") = StringFormat("%d", currentPen.GetWidth()).c_str();
+        polygonChild.append_attribute("stroke-width") = currentPen.GetWidth();
     }
     if (currentPen.GetOpacity() != 1.0) {
         polygonChild.append_attribute("stroke-opacity") = StringFormat("%f", currentPen.GetOpacity()).c_str();
@@ -753,11 +846,14 @@ void SvgDeviceContext::DrawPolygon(int n, Point points[], int xOffset, int yOffs
     if (currentBrush.GetOpacity() != 1.0)
         polygonChild.append_attribute("fill-opacity") = StringFormat("%f", currentBrush.GetOpacity()).c_str();
 
-    std::string pointsString;
+    m_valueBuffer.clear();
     for (int i = 0; i < n; ++i) {
-        pointsString += StringFormat("%d,%d ", points[i].x + xOffset, points[i].y + yOffset);
+        AppendInt(m_valueBuffer, points[i].x + xOffset);
+        m_valueBuffer += ',';
+        AppendInt(m_valueBuffer, points[i].y + yOffset);
+        m_valueBuffer += ' ';
     }
-    polygonChild.append_attribute("points") = pointsString.c_str();
+    polygonChild.append_attribute("points") = m_valueBuffer.c_str();
 }
 
 void SvgDeviceContext::DrawRectangle(int x, int y, int width, int height)
@@ -774,7 +870,7 @@ void SvgDeviceContext::DrawRoundedRectangle(int x, int y, int width, int height,
         if (currentPen.GetWidth() > 0)
             rectChild.append_attribute("stroke") = this->GetColour(currentPen.GetColour()).c_str();
         if (currentPen.GetWidth() > 1)
-            rectChild.append_attribute("stroke-width") = StringFormat("%d", currentPen.GetWidth()).c_str();
+            rectChild.append_attribute("stroke-width") = currentPen.GetWidth();
         if (currentPen.GetOpacity() != 1.0)
             rectChild.append_attribute("stroke-opacity") = StringFormat("%f", currentPen.GetOpacity()).c_str();
     }
@@ -909,7 +1005,7 @@ void SvgDeviceContext::DrawText(const std::string &text, const std::wstring &wte
         if (fontFaceName == "VerovioText") this->VrvTextFont();
     }
     if (m_fontStack.top()->GetPointSize() != 0) {
-        textChild.append_attribute("font-size") = StringFormat("%dpx", m_fontStack.top()->GetPointSize()).c_str();
+        textChild.append_attribute("font-size") = (std::to_string(m_fontStack.top()->GetPointSize()) + "px").c_str();
     }
     if (m_fontStack.top()->GetStyle() != FONTSTYLE_NONE) {
         if (m_fontStack.top()->GetStyle() == FONTSTYLE_italic) {
@@ -930,15 +1026,15 @@ void SvgDeviceContext::DrawText(const std::string &text, const std::wstring &wte
         pugi::xml_node g = m_currentNode.parent().parent();
         pugi::xml_node rectChild = g.append_child("rect");
         rectChild.append_attribute("class") = "sylTextRect";
-        rectChild.append_attribute("x") = StringFormat("%d", x).c_str();
-        rectChild.append_attribute("y") = StringFormat("%d", y).c_str();
-        rectChild.append_attribute("width") = StringFormat("%d", width).c_str();
-        rectChild.append_attribute("height") = StringFormat("%d", height).c_str();
+        rectChild.append_attribute("x") = x;
+        rectChild.append_attribute("y") = y;
+        rectChild.append_attribute("width") = width;
+        rectChild.append_attribute("height") = height;
         rectChild.append_attribute("opacity") = "0.0";
     }
     else if ((x != 0) && (y != 0) && (x != VRV_UNSET) && (y != VRV_UNSET)) {
-        textChild.append_attribute("x") = StringFormat("%d", x).c_str();
-        textChild.append_attribute("y") = StringFormat("%d", y).c_str();
+        textChild.append_attribute("x") = x;
+        textChild.append_attribute("y") = y;
     }
 }
 
@@ -962,6 +1058,9 @@ void SvgDeviceContext::DrawMusicText(const std::wstring &text, int x, int y, boo
         hrefAttrib.insert(0, "xlink:");
     }
 
+    // the size is the same for all the chars
+    std::string pointSize = std::to_string(m_fontStack.top()->GetPointSize()) + "px";
+
     // print chars one by one
     for (unsigned int i = 0; i < text.length(); ++i) {
         wchar_t c = text.at(i);
@@ -971,16 +1070,20 @@ void SvgDeviceContext::DrawMusicText(const std::wstring &text, int x, int y, boo
         }
 
         // Add the glyph to the array for the <defs>
-        m_smuflGlyphs.insert(glyph);
+        m_smuflGlyphs.emplace(c, glyph);
 
         // Write the char in the SVG
         pugi::xml_node useChild = AppendChild("use");
-        useChild.append_attribute(hrefAttrib.c_str())
-            = StringFormat("#%s-%s", glyph->GetCodeStr().c_str(), m_glyphPostfixId.c_str()).c_str();
+        m_valueBuffer = m_glyphHref;
+        m_valueBuffer += "#";
+        m_valueBuffer += glyph->GetCodeStr();
+        m_valueBuffer += '-';
+        m_valueBuffer += m_glyphPostfixId;
+        useChild.append_attribute(hrefAttrib.c_str()) = m_valueBuffer.c_str();
         useChild.append_attribute("x") = x;
         useChild.append_attribute("y") = y;
-        useChild.append_attribute("height") = StringFormat("%dpx", m_fontStack.top()->GetPointSize()).c_str();
-        useChild.append_attribute("width") = StringFormat("%dpx", m_fontStack.top()->GetPointSize()).c_str();
+        useChild.append_attribute("height") = pointSize.c_str();
+        useChild.append_attribute("width") = pointSize.c_str();
         if (m_fontStack.top()->GetWidthToHeightRatio() != 1.0f) {
             useChild.append_attribute("transform") = StringFormat("matrix(%f,0,0,1,%f,0)",
                 m_fontStack.top()->GetWidthToHeightRatio(), x * (1. - m_fontStack.top()->GetWidthToHeightRatio()))
@@ -1017,6 +1120,15 @@ void SvgDeviceContext::AddDescription(const std::string &text)
     desc.append_child(pugi::node_pcdata).set_value(text.c_str());
 }
 
+std::string SvgDeviceContext::GetGraphicId(const Object *object, const std::string &gId) const
+{
+    if (!m_multiPage || gId.empty()) return gId;
+    if (!object->IsRunningElement() && !object->GetFirstAncestorInRange(RUNNING_ELEMENT, RUNNING_ELEMENT_max)) {
+        return gId;
+    }
+    return StringFormat("%s-p%d", gId.c_str(), m_pageCount);
+}
+
 void SvgDeviceContext::AppendIdAndClass(std::string gId, std::string baseClass, std::string addedClasses, bool primary)
 {
     std::transform(baseClass.begin(), baseClass.begin() + 1, baseClass.begin(), ::tolower);
@@ -1061,10 +1173,6 @@ void SvgDeviceContext::AppendAdditionalAttributes(Object *object)
 
 std::string SvgDeviceContext::GetColour(int colour)
 {
-    std::ostringstream ss;
-    ss << "#";
-    ss << std::hex;
-
     switch (colour) {
         case (AxNONE): return "currentColor";
         case (AxBLACK): return "#000000";
@@ -1075,6 +1183,9 @@ std::string SvgDeviceContext::GetColour(int colour)
         case (AxCYAN): return "#00FFFF";
         case (AxLIGHT_GREY): return "#777777";
         default:
+            std::ostringstream ss;
+            ss << "#";
+            ss << std::hex;
             int blue = (colour & 255);
             int green = (colour >> 8) & 255;
             int red = (colour >> 16) & 255;
@@ -1084,11 +1195,37 @@ std::string SvgDeviceContext::GetColour(int colour)
     }
 }
 
+void SvgDeviceContext::AppendInt(std::string &str, int value)
+{
+    char buffer[16];
+    char *end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    str.append(buffer, end);
+}
+
+void SvgDeviceContext::AppendPoint(std::string &str, const Point &point)
+{
+    AppendInt(str, point.x);
+    str += ',';
+    AppendInt(str, point.y);
+}
+
 std::string SvgDeviceContext::GetStringSVG(bool xml_declaration)
 {
     if (!m_committed) Commit(xml_declaration);
 
-    return m_outdata.str();
+    return m_outdata;
+}
+
+std::string SvgDeviceContext::GetStringGlyphSprite(bool xml_declaration)
+{
+    if (!m_committed) {
+        // the sprite has only the <defs>
+        this->AppendGlyphDefinitions(m_svgNode.append_child("defs"));
+        this->SaveDocument(xml_declaration);
+        m_committed = true;
+    }
+
+    return m_outdata;
 }
 
 void SvgDeviceContext::DrawSvgBoundingBoxRectangle(int x, int y, int width, int height)
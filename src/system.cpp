@@ -9,7 +9,9 @@
 
 //----------------------------------------------------------------------------
 
+#include <algorithm>
 #include <cassert>
+#include <climits>
 
 //----------------------------------------------------------------------------
 
@@ -21,6 +23,7 @@
 #include "ending.h"
 #include "functorparams.h"
 #include "layer.h"
+#include "layerelement.h"
 #include "measure.h"
 #include "page.h"
 #include "pages.h"
@@ -36,6 +39,100 @@
 
 namespace vrv {
 
+//----------------------------------------------------------------------------
+// SpannedElementIndex
+//----------------------------------------------------------------------------
+
+void SpannedElementIndex::Reset()
+{
+    m_entries.clear();
+    m_maxWidths.clear();
+    m_measureIdx.clear();
+    m_classIds.clear();
+    m_currentMeasureIdx = -1;
+    m_currentOrder = 0;
+    m_isInitialized = false;
+}
+
+void SpannedElementIndex::Init(const System *system, const std::vector<ClassId> &classIds)
+{
+    assert(system);
+
+    this->Reset();
+    m_classIds = classIds;
+
+    InitSpannedElementIndexParams initSpannedElementIndexParams(this);
+    Functor initSpannedElementIndex(&Object::InitSpannedElementIndex);
+    system->Process(&initSpannedElementIndex, &initSpannedElementIndexParams);
+
+    // Stable sort to keep the document order for elements with the same left position
+    for (auto &[staffN, entries] : m_entries) {
+        std::stable_sort(entries.begin(), entries.end(),
+            [](const IndexEntry &entry1, const IndexEntry &entry2) { return (entry1.m_left < entry2.m_left); });
+    }
+
+    m_isInitialized = true;
+}
+
+void SpannedElementIndex::AddMeasure(const Measure *measure)
+{
+    assert(measure);
+
+    ++m_currentMeasureIdx;
+    m_measureIdx[measure] = m_currentMeasureIdx;
+}
+
+void SpannedElementIndex::AddElement(const LayerElement *element, int staffN, int crossStaffN)
+{
+    assert(element);
+
+    const int left = element->GetContentLeft();
+    const int right = element->GetContentRight();
+    // Both entries share the same order so the element is reported only once
+    m_entries[staffN].push_back({ left, right, m_currentMeasureIdx, m_currentOrder, element });
+    m_maxWidths[staffN] = std::max(m_maxWidths[staffN], right - left);
+    if ((crossStaffN != VRV_UNSET) && (crossStaffN != staffN)) {
+        m_entries[crossStaffN].push_back({ left, right, m_currentMeasureIdx, m_currentOrder, element });
+        m_maxWidths[crossStaffN] = std::max(m_maxWidths[crossStaffN], right - left);
+    }
+    ++m_currentOrder;
+}
+
+void SpannedElementIndex::FindSpannedLayerElements(FindSpannedLayerElementsParams *params) const
+{
+    assert(params);
+    assert(m_isInitialized);
+
+    // Measures before the start measure or after the end measure are skipped, as in Measure::FindSpannedLayerElements
+    auto measureIter = m_measureIdx.find(params->m_interface->GetStartMeasure());
+    const int startMeasureIdx = (measureIter != m_measureIdx.end()) ? measureIter->second : 0;
+    measureIter = m_measureIdx.find(params->m_interface->GetEndMeasure());
+    const int endMeasureIdx = (measureIter != m_measureIdx.end()) ? measureIter->second : INT_MAX;
+
+    std::vector<std::pair<int, const LayerElement *>> spanned;
+    for (const auto &[staffN, entries] : m_entries) {
+        if (!params->m_staffNs.empty() && (params->m_staffNs.count(staffN) == 0)) continue;
+
+        // Elements with a left position before this cannot reach the minimum position
+        const int minLeft = params->m_minPos - m_maxWidths.at(staffN);
+        auto iter = std::upper_bound(entries.begin(), entries.end(), minLeft,
+            [](int left, const IndexEntry &entry) { return (left < entry.m_left); });
+        for (; (iter != entries.end()) && (iter->m_left < params->m_maxPos); ++iter) {
+            if (iter->m_right <= params->m_minPos) continue;
+            if ((iter->m_measureIdx < startMeasureIdx) || (iter->m_measureIdx > endMeasureIdx)) continue;
+            if (!iter->m_element->IsSpannedElement(params)) continue;
+            spanned.push_back({ iter->m_order, iter->m_element });
+        }
+    }
+
+    // Restore the document order and remove cross-staff elements found twice
+    std::sort(spanned.begin(), spanned.end());
+    spanned.erase(std::unique(spanned.begin(), spanned.end()), spanned.end());
+    for (const auto &entry : spanned) {
+        params->m_elements.push_back(entry.second);
+    }
+}
+
 //----------------------------------------------------------------------------
 // System
 //----------------------------------------------------------------------------
@@ -82,6 +179,8 @@ void System::Reset()
     m_castOffJustifiableWidth = 0;
     m_drawingAbbrLabelsWidth = 0;
     m_drawingIsOptimized = false;
+
+    m_spannedElementIndex.Reset();
 }
 
 bool System::IsSupportedChild(Object *child)
@@ -306,6 +405,24 @@ curvature_CURVEDIR System::GetPreferredCurveDirection(
     return preferredDirection;
 }
 
+void System::FindSpannedLayerElements(FindSpannedLayerElementsParams *params) const
+{
+    assert(params);
+
+    if (!m_spannedElementIndex.IsInitialized()) {
+        m_spannedElementIndex.Init(this, params->m_classIds);
+    }
+
+    // The index is built for one set of class ids - process the system for other ones
+    if (m_spannedElementIndex.GetClassIds() != params->m_classIds) {
+        Functor findSpannedLayerElements(&Object::FindSpannedLayerElements);
+        this->Process(&findSpannedLayerElements, params);
+        return;
+    }
+
+    m_spannedElementIndex.FindSpannedLayerElements(params);
+}
+
 void System::AddToDrawingListIfNecessary(Object *object)
 {
     assert(object);
@@ -535,6 +652,7 @@ int System::ResetHorizontalAlignment(FunctorParams *functorParams)
 {
     this->SetDrawingXRel(0);
     m_drawingAbbrLabelsWidth = 0;
+    m_spannedElementIndex.Reset();
 
     return FUNCTOR_CONTINUE;
 }
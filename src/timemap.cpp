@@ -14,6 +14,7 @@
 //----------------------------------------------------------------------------
 
 #include "functorparams.h"
+#include "jsonwriter.h"
 #include "measure.h"
 #include "note.h"
 #include "rest.h"
@@ -52,10 +53,13 @@ void Timemap::AddEntry(Object *object, GenerateTimemapParams *params)
         DurationInterface *interface = object->GetDurationInterface();
         assert(interface);
 
-        double realTimeStart = params->m_realTimeOffsetMilliseconds + interface->GetRealTimeOnsetMilliseconds();
+        // The real times are scaled when the measure is played with another tempo than the one of its first pass
+        double realTimeStart = params->m_realTimeOffsetMilliseconds
+            + interface->GetRealTimeOnsetMilliseconds() * params->m_realTimeFactor;
         double scoreTimeStart = params->m_scoreTimeOffset + interface->GetScoreTimeOnset();
 
-        double realTimeEnd = params->m_realTimeOffsetMilliseconds + interface->GetRealTimeOffsetMilliseconds();
+        double realTimeEnd = params->m_realTimeOffsetMilliseconds
+            + interface->GetRealTimeOffsetMilliseconds() * params->m_realTimeFactor;
         double scoreTimeEnd = params->m_scoreTimeOffset + interface->GetScoreTimeOffset();
 
         bool isRest = (object->Is(REST));
@@ -119,58 +123,44 @@ void Timemap::AddEntry(Object *object, GenerateTimemapParams *params)
 void Timemap::ToJson(std::string &output, bool includeRests, bool includeMeasures)
 {
     double currentTempo = -1000.0;
-    double newTempo;
 
-    jsonxx::Array timemap;
+    output.clear();
+    JsonWriter writer(output);
+    writer.StartArray();
 
+    // The keys are written in alphabetical order
     for (auto &[tstamp, entry] : m_map) {
-        jsonxx::Object o;
-        o << "tstamp" << tstamp;
-        o << "qstamp" << entry.qstamp;
+        writer.StartObject();
 
-        // on / off
-        if (!entry.notesOn.empty()) {
-            jsonxx::Array notesOn;
-            for (auto note : entry.notesOn) notesOn << note;
-            o << "on" << notesOn;
-        }
-        if (!entry.notesOff.empty()) {
-            jsonxx::Array notesOff;
-            for (auto note : entry.notesOff) notesOff << note;
-            o << "off" << notesOff;
+        // measureOn
+        if (includeMeasures && !entry.measureOn.empty()) {
+            writer.AddString("measureOn", entry.measureOn);
         }
 
+        // on / off
+        if (!entry.notesOff.empty()) writer.AddStringArray("off", entry.notesOff);
+        if (!entry.notesOn.empty()) writer.AddStringArray("on", entry.notesOn);
+
+        writer.AddNumber("qstamp", entry.qstamp);
+
         // restsOn / restsOff
         if (includeRests) {
-            if (!entry.restsOn.empty()) {
-                jsonxx::Array restsOn;
-                for (auto rest : entry.restsOn) restsOn << rest;
-                o << "restsOn" << restsOn;
-            }
-            if (!entry.restsOff.empty()) {
-                jsonxx::Array restsOff;
-                for (auto rest : entry.restsOff) restsOff << rest;
-                o << "restsOff" << restsOff;
-            }
+            if (!entry.restsOff.empty()) writer.AddStringArray("restsOff", entry.restsOff);
+            if (!entry.restsOn.empty()) writer.AddStringArray("restsOn", entry.restsOn);
         }
 
         // tempo
-        if (entry.tempo != -1000.0) {
-            newTempo = entry.tempo;
-            if (newTempo != currentTempo) {
-                currentTempo = newTempo;
-                o << "tempo" << std::to_string(currentTempo);
-            }
+        if ((entry.tempo != -1000.0) && (entry.tempo != currentTempo)) {
+            currentTempo = entry.tempo;
+            writer.AddString("tempo", std::to_string(currentTempo));
         }
 
-        // measureOn
-        if (includeMeasures && !entry.measureOn.empty()) {
-            o << "measureOn" << entry.measureOn;
-        }
+        writer.AddNumber("tstamp", tstamp);
 
-        timemap << o;
+        writer.EndObject();
     }
-    output = timemap.json();
+
+    writer.EndArray();
 }
 
 } // namespace vrv
@@ -13,11 +13,14 @@
 #include <codecvt>
 #include <locale>
 #include <regex>
+#include <unordered_map>
 
 //----------------------------------------------------------------------------
 
+#include "binarydevicecontext.h"
 #include "comparison.h"
 #include "custos.h"
+#include "displaylistdevicecontext.h"
 #include "editortoolkit_cmn.h"
 #include "editortoolkit_mensural.h"
 #include "editortoolkit_neume.h"
@@ -28,13 +31,16 @@
 #include "iomei.h"
 #include "iomusxml.h"
 #include "iopae.h"
+#include "jsonwriter.h"
 #include "layer.h"
 #include "measure.h"
+#include "midiext.h"
 #include "nc.h"
 #include "neume.h"
 #include "note.h"
 #include "options.h"
 #include "page.h"
+#include "rasterdevicecontext.h"
 #include "runtimeclock.h"
 #include "score.h"
 #include "slur.h"
@@ -88,6 +94,8 @@ Toolkit::Toolkit(bool initFont)
 
     m_editorToolkit = NULL;
 
+    m_displayListGeneration = 0;
+
 #ifndef NO_RUNTIME
     m_runtimeClock = NULL;
 #endif
@@ -129,6 +137,9 @@ std::string Toolkit::GetResourcePath() const
 
 bool Toolkit::SetResourcePath(const std::string &path)
 {
+    this->ResetDisplayListCache();
+    m_displayListFont.clear();
+
     Resources &resources = m_doc.GetResourcesForModification();
     resources.SetPath(path);
     return resources.InitFonts();
@@ -136,6 +147,12 @@ bool Toolkit::SetResourcePath(const std::string &path)
 
 bool Toolkit::SetFont(const std::string &fontName)
 {
+    // The font is set again with every call to SetOptions
+    if (fontName != m_displayListFont) {
+        this->ResetDisplayListCache();
+        m_displayListFont = fontName;
+    }
+
     Resources &resources = m_doc.GetResourcesForModification();
     const bool ok = resources.SetFont(fontName);
     if (!ok) LogWarning("Font '%s' could not be loaded", fontName.c_str());
@@ -182,6 +199,15 @@ bool Toolkit::SetOutputTo(std::string const &outputTo)
     else if (outputTo == "pae") {
         m_outputTo = PAE;
     }
+    else if (outputTo == "binary") {
+        m_outputTo = BINARY;
+    }
+    else if (outputTo == "png") {
+        m_outputTo = PNG;
+    }
+    else if (outputTo == "svgz") {
+        m_outputTo = SVGZ;
+    }
     else if (outputTo != "svg") {
         LogError("Output format '%s' is not supported", outputTo.c_str());
         return false;
@@ -785,6 +811,7 @@ bool Toolkit::LoadData(const std::string &data)
             m_doc.CastOffDoc();
             // LogElapsedTimeEnd("cast-off");
         }
+        m_doc.CacheCastOffDoc();
     }
 
     delete input;
@@ -1065,6 +1092,9 @@ bool Toolkit::SetOptions(const std::string &jsonOptions)
 
         // Mapped options
 
+        // The display lists are kept by global styling, which is changed by the mm output
+        if (!m_options->IsOutputOnly(iter->first)) this->ResetDisplayListCache();
+
         Option *opt = m_options->GetItems()->at(iter->first);
         assert(opt);
 
@@ -1128,6 +1158,8 @@ bool Toolkit::SetOption(const std::string &option, const std::string &value)
         LogError("Unsupported option '%s'", option.c_str());
         return false;
     }
+    if (!m_options->IsOutputOnly(option)) this->ResetDisplayListCache();
+
     Option *opt = m_options->GetItems()->at(option);
     assert(opt);
     return opt->SetValue(value);
@@ -1135,6 +1167,8 @@ bool Toolkit::SetOption(const std::string &option, const std::string &value)
 
 void Toolkit::ResetOptions()
 {
+    this->ResetDisplayListCache();
+
     std::for_each(m_options->GetItems()->begin(), m_options->GetItems()->end(),
         [](const MapOfStrOptions::value_type &opt) { opt.second->Reset(); });
 
@@ -1233,6 +1267,42 @@ bool Toolkit::Edit(const std::string &editorAction)
 {
     this->ResetLogBuffer();
 
+    // The editor toolkit is not created with Humdrum support
+    if (!m_editorToolkit) {
+        LogError("The editor is not available");
+        return false;
+    }
+
+    // The cached cast offs and display lists are not valid anymore once the content is edited
+    m_doc.ResetCastOffCache();
+    this->ResetDisplayListCache();
+
+    // The timemap needs to be recalculated only from the measure edited when a single element within it is edited
+    Measure *editedMeasure = NULL;
+    jsonxx::Object json;
+    if (json.parse(editorAction) && json.has<jsonxx::String>("action") && json.has<jsonxx::Object>("param")) {
+        const std::string action = json.get<jsonxx::String>("action");
+        const jsonxx::Object &param = json.get<jsonxx::Object>("param");
+        std::string elementId;
+        if ((action == "delete") || (action == "drag") || (action == "keyDown") || (action == "set")) {
+            if (param.has<jsonxx::String>("elementId")) elementId = param.get<jsonxx::String>("elementId");
+        }
+        else if (action == "insert") {
+            if (param.has<jsonxx::String>("startid")) elementId = param.get<jsonxx::String>("startid");
+        }
+        Object *element = (elementId.empty()) ? NULL : m_doc.FindDescendantByID(elementId);
+        // Meter signatures and mensurs change the durations in the following measures
+        if (element && !element->Is({ MEASURE, METERSIG, MENSUR })) {
+            editedMeasure = vrv_cast<Measure *>(element->GetFirstAncestor(MEASURE));
+        }
+    }
+    if (editedMeasure) {
+        m_doc.InvalidateTimemap(editedMeasure);
+    }
+    else {
+        m_doc.ResetTimemap();
+    }
+
     return m_editorToolkit->ParseEditorAction(editorAction);
 }
 
@@ -1267,6 +1337,11 @@ void Toolkit::ResetLogBuffer()
     logBuffer.clear();
 }
 
+void Toolkit::ResetDisplayListCache()
+{
+    m_displayLists.clear();
+}
+
 void Toolkit::RedoLayout(const std::string &jsonOptions)
 {
     bool resetCache = true;
@@ -1297,6 +1372,9 @@ void Toolkit::RedoLayout(const std::string &jsonOptions)
         m_doc.UnCastOffDoc(resetCache);
     }
 
+    // Reuse the cast off of a previous layout with the same options
+    if ((m_options->m_breaks.GetValue() != BREAKS_none) && m_doc.CastOffFromCacheDoc()) return;
+
     if (m_options->m_breaks.GetValue() == BREAKS_line) {
         m_doc.CastOffLineDoc();
     }
@@ -1309,6 +1387,7 @@ void Toolkit::RedoLayout(const std::string &jsonOptions)
     else if (m_options->m_breaks.GetValue() != BREAKS_none) {
         m_doc.CastOffDoc();
     }
+    m_doc.CacheCastOffDoc();
 }
 
 void Toolkit::RedoPagePitchPosLayout()
@@ -1322,6 +1401,7 @@ void Toolkit::RedoPagePitchPosLayout()
         return;
     }
 
+    this->ResetDisplayListCache();
     page->LayOutPitchPos();
 }
 
@@ -1376,7 +1456,37 @@ bool Toolkit::RenderToDeviceContext(int pageNo, DeviceContext *deviceContext)
     }
 
     // render the page
-    m_view.DrawCurrentPage(deviceContext, false);
+    if ((!deviceContext->Is(SVG_DEVICE_CONTEXT) && !deviceContext->Is(BINARY_DEVICE_CONTEXT)
+            && !deviceContext->Is(RASTER_DEVICE_CONTEXT))
+        || m_view.HasDrawingRegion()) {
+        m_view.DrawCurrentPage(deviceContext, false);
+        return true;
+    }
+
+    // With SVG, binary or PNG, draw the page once into a display list and replay it for the following renderings
+    // The display lists point to the layout objects and are dropped once these have been rebuilt, which can be
+    // done by the layout of the page itself
+    if (m_displayListGeneration != m_doc.GetLayoutGeneration()) {
+        this->ResetDisplayListCache();
+        m_displayListGeneration = m_doc.GetLayoutGeneration();
+    }
+    // The View draws differently with global styling, which changes with the mm output
+    const std::pair<int, bool> key = { pageNo, deviceContext->UseGlobalStyling() };
+    auto iter = m_displayLists.find(key);
+    if ((iter != m_displayLists.end()) && (iter->second->GetWidth() == deviceContext->GetWidth())
+        && (iter->second->GetHeight() == deviceContext->GetHeight())) {
+        iter->second->Replay(deviceContext);
+        return true;
+    }
+
+    auto displayList = std::make_unique<DisplayListDeviceContext>(deviceContext->UseGlobalStyling());
+    displayList->SetResources(&m_doc.GetResources());
+    displayList->SetUserScale(deviceContext->GetUserScaleX(), deviceContext->GetUserScaleY());
+    displayList->SetWidth(deviceContext->GetWidth());
+    displayList->SetHeight(deviceContext->GetHeight());
+    m_view.DrawCurrentPage(displayList.get(), false);
+    displayList->Replay(deviceContext);
+    m_displayLists[key] = std::move(displayList);
 
     return true;
 }
@@ -1391,42 +1501,288 @@ std::string Toolkit::RenderToSVG(int pageNo, bool xmlDeclaration)
     SvgDeviceContext svg;
     svg.SetResources(&m_doc.GetResources());
 
+    this->SetSvgOptions(&svg);
+
+    // render the page
+    this->RenderToDeviceContext(pageNo, &svg);
+
+    std::string out_str = svg.GetStringSVG(xmlDeclaration);
+    if (initialPageNo >= 0) m_doc.SetDrawingPage(initialPageNo);
+    return out_str;
+}
+
+std::string Toolkit::RenderToSVGZ(int pageNo)
+{
+    std::vector<unsigned char> output;
+    this->RenderToSVGZ(output, pageNo);
+
+    return Base64Encode(output.data(), (unsigned int)output.size());
+}
+
+void Toolkit::RenderToSVGZ(std::vector<unsigned char> &output, int pageNo)
+{
+    // The compressed SVG is a file and has the xml declaration
+    if (!GzipCompress(this->RenderToSVG(pageNo, true), output)) {
+        LogError("The SVG could not be compressed");
+    }
+}
+
+bool Toolkit::RenderToSVGZFile(const std::string &filename, int pageNo)
+{
+    std::vector<unsigned char> output;
+    this->RenderToSVGZ(output, pageNo);
+    if (output.empty()) {
+        return false;
+    }
+
+    std::ofstream outfile(filename.c_str(), std::ios::binary);
+    if (!outfile.is_open()) {
+        return false;
+    }
+
+    outfile.write(reinterpret_cast<const char *>(output.data()), output.size());
+    outfile.close();
+    return true;
+}
+
+bool Toolkit::GzipCompress(const std::string &data, std::vector<unsigned char> &output)
+{
+    output.clear();
+
+#ifndef NO_MXL_SUPPORT
+    // Raw deflate stream (negative window bits) wrapped in a gzip member
+    const int flags
+        = tdefl_create_comp_flags_from_zip_params(MZ_DEFAULT_LEVEL, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+    size_t size = 0;
+    void *deflated = tdefl_compress_mem_to_heap(data.data(), data.size(), &size, flags);
+    if (!deflated) return false;
+
+    // Header with the magic number, the deflate method, no flags, no time, and an unknown OS
+    output = { 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff };
+    output.reserve(output.size() + size + 8);
+    output.insert(output.end(), (unsigned char *)deflated, (unsigned char *)deflated + size);
+    mz_free(deflated);
+
+    // Trailer with the CRC-32 and the size of the input, both little-endian
+    const unsigned int crc = (unsigned int)mz_crc32(MZ_CRC32_INIT, (const unsigned char *)data.data(), data.size());
+    const unsigned int inputSize = (unsigned int)data.size();
+    for (unsigned int value : { crc, inputSize }) {
+        for (int i = 0; i < 4; ++i) {
+            output.push_back((value >> (8 * i)) & 0xff);
+        }
+    }
+    return true;
+#else
+    LogError("Gzip compression is not supported in this build.");
+    return false;
+#endif
+}
+
+void Toolkit::SetSvgOptions(SvgDeviceContext *svg)
+{
+    assert(svg);
+
     int indent = (m_options->m_outputIndentTab.GetValue()) ? -1 : m_options->m_outputIndent.GetValue();
-    svg.SetIndent(indent);
+    svg->SetIndent(indent);
 
     if (m_options->m_mmOutput.GetValue()) {
-        svg.SetMMOutput(true);
+        svg->SetMMOutput(true);
     }
 
     if (m_doc.GetType() == Facs) {
-        svg.SetFacsimile(true);
+        svg->SetFacsimile(true);
     }
 
     // set the option to use viewbox on svg root
     if (m_options->m_svgBoundingBoxes.GetValue()) {
-        svg.SetSvgBoundingBoxes(true);
+        svg->SetSvgBoundingBoxes(true);
     }
 
     // set the additional CSS if any
     if (!m_options->m_svgCss.GetValue().empty()) {
-        svg.SetCss(m_options->m_svgCss.GetValue());
+        svg->SetCss(m_options->m_svgCss.GetValue());
     }
 
     if (m_options->m_svgViewBox.GetValue()) {
-        svg.SetSvgViewBox(true);
+        svg->SetSvgViewBox(true);
     }
 
-    svg.SetHtml5(m_options->m_svgHtml5.GetValue());
-    svg.SetFormatRaw(m_options->m_svgFormatRaw.GetValue());
-    svg.SetRemoveXlink(m_options->m_svgRemoveXlink.GetValue());
-    svg.SetAdditionalAttributes(m_options->m_svgAdditionalAttribute.GetValue());
+    svg->SetHtml5(m_options->m_svgHtml5.GetValue());
+    svg->SetFormatRaw(m_options->m_svgFormatRaw.GetValue());
+    svg->SetRemoveXlink(m_options->m_svgRemoveXlink.GetValue());
+    svg->SetAdditionalAttributes(m_options->m_svgAdditionalAttribute.GetValue());
+}
 
-    // render the page
-    this->RenderToDeviceContext(pageNo, &svg);
+bool Toolkit::GetPageRange(const std::string &jsonOptions, int &fromPage, int &toPage)
+{
+    fromPage = 1;
+    toPage = this->GetPageCount();
+
+    jsonxx::Object json;
+
+    // Read JSON options if not empty
+    if (!jsonOptions.empty()) {
+        if (!json.parse(jsonOptions)) {
+            LogWarning("Cannot parse JSON std::string. Rendering all the pages.");
+        }
+        else {
+            if (json.has<jsonxx::Number>("from")) fromPage = json.get<jsonxx::Number>("from");
+            if (json.has<jsonxx::Number>("to")) toPage = json.get<jsonxx::Number>("to");
+        }
+    }
+
+    fromPage = std::max(1, fromPage);
+    toPage = std::min(this->GetPageCount(), toPage);
+    if (fromPage > toPage) {
+        LogWarning("No page to render in the range %d to %d", fromPage, toPage);
+        return false;
+    }
+    return true;
+}
+
+std::string Toolkit::RenderToSVGDocument(const std::string &jsonOptions)
+{
+    this->ResetLogBuffer();
+
+    int fromPage, toPage;
+    if (!this->GetPageRange(jsonOptions, fromPage, toPage)) return "";
+
+    int initialPageNo = (m_doc.GetDrawingPage() == NULL) ? -1 : m_doc.GetDrawingPage()->GetIdx();
+
+    // All the pages are drawn into the same device context
+    SvgDeviceContext svg;
+    svg.SetResources(&m_doc.GetResources());
+    this->SetSvgOptions(&svg);
+    svg.SetMultiPage(true);
+
+    for (int pageNo = fromPage; pageNo <= toPage; ++pageNo) {
+        this->RenderToDeviceContext(pageNo, &svg);
+    }
+
+    std::string output = svg.GetStringSVG();
+    if (initialPageNo >= 0) m_doc.SetDrawingPage(initialPageNo);
+    return output;
+}
+
+std::string Toolkit::RenderToSVGPages(const std::string &jsonOptions)
+{
+    int fromPage, toPage;
+    if (!this->GetPageRange(jsonOptions, fromPage, toPage)) return "{}";
+
+    std::string spriteHref = "glyphs.svg";
+    jsonxx::Object json;
+    if (!jsonOptions.empty() && json.parse(jsonOptions) && json.has<jsonxx::String>("spriteHref")) {
+        spriteHref = json.get<jsonxx::String>("spriteHref");
+    }
+
+    std::vector<std::string> pages;
+    std::string sprite;
+    this->RenderToSVGPages(fromPage, toPage, spriteHref, pages, sprite);
+
+    jsonxx::Array pageArray;
+    for (const std::string &page : pages) {
+        pageArray << page;
+    }
+    jsonxx::Object output;
+    output << "sprite" << sprite;
+    output << "pages" << pageArray;
+    return output.json();
+}
+
+void Toolkit::RenderToSVGPages(int fromPage, int toPage, const std::string &spriteHref,
+    std::vector<std::string> &pages, std::string &sprite, bool xmlDeclaration)
+{
+    this->ResetLogBuffer();
+
+    pages.clear();
+    sprite.clear();
+
+    int initialPageNo = (m_doc.GetDrawingPage() == NULL) ? -1 : m_doc.GetDrawingPage()->GetIdx();
+
+    // The glyph ids have to be the same in all the pages and in the sprite
+    const std::string glyphPostfixId = Object::GenerateRandID();
+    SvgDeviceContext spriteSvg;
+    spriteSvg.SetResources(&m_doc.GetResources());
+    spriteSvg.SetIndent((m_options->m_outputIndentTab.GetValue()) ? -1 : m_options->m_outputIndent.GetValue());
+    spriteSvg.SetFormatRaw(m_options->m_svgFormatRaw.GetValue());
+    spriteSvg.SetGlyphPostfixId(glyphPostfixId);
+
+    for (int pageNo = fromPage; pageNo <= toPage; ++pageNo) {
+        SvgDeviceContext svg;
+        svg.SetResources(&m_doc.GetResources());
+        this->SetSvgOptions(&svg);
+        svg.SetGlyphHref(spriteHref);
+        svg.SetGlyphPostfixId(glyphPostfixId);
+        this->RenderToDeviceContext(pageNo, &svg);
+        pages.push_back(svg.GetStringSVG(xmlDeclaration));
+        spriteSvg.AddGlyphs(svg);
+    }
+    sprite = spriteSvg.GetStringGlyphSprite(xmlDeclaration);
 
-    std::string out_str = svg.GetStringSVG(xmlDeclaration);
     if (initialPageNo >= 0) m_doc.SetDrawingPage(initialPageNo);
-    return out_str;
+}
+
+std::string Toolkit::RenderToSVGRegion(int pageNo, const std::string &jsonOptions)
+{
+    int x = 0;
+    int y = 0;
+    int width = VRV_UNSET;
+    int height = VRV_UNSET;
+    std::string startMeasure;
+    std::string endMeasure;
+
+    jsonxx::Object json;
+
+    // Read JSON options if not empty
+    if (!jsonOptions.empty()) {
+        if (!json.parse(jsonOptions)) {
+            LogWarning("Cannot parse JSON std::string. Rendering the full page.");
+        }
+        else {
+            if (json.has<jsonxx::Number>("x")) x = json.get<jsonxx::Number>("x");
+            if (json.has<jsonxx::Number>("y")) y = json.get<jsonxx::Number>("y");
+            if (json.has<jsonxx::Number>("width")) width = json.get<jsonxx::Number>("width");
+            if (json.has<jsonxx::Number>("height")) height = json.get<jsonxx::Number>("height");
+            if (json.has<jsonxx::String>("startMeasure")) startMeasure = json.get<jsonxx::String>("startMeasure");
+            if (json.has<jsonxx::String>("endMeasure")) endMeasure = json.get<jsonxx::String>("endMeasure");
+        }
+    }
+
+    if (!startMeasure.empty()) {
+        if ((pageNo < 1) || (pageNo > this->GetPageCount())) {
+            LogWarning("Page %d does not exist", pageNo);
+            return "";
+        }
+        // Make sure the page is laid out for getting the bounding boxes of the measures
+        m_view.SetPage(pageNo - 1);
+        Page *page = m_doc.GetDrawingPage();
+        assert(page);
+        if (endMeasure.empty()) endMeasure = startMeasure;
+        Object *start = page->FindDescendantByID(startMeasure);
+        Object *end = page->FindDescendantByID(endMeasure);
+        if (!start || !start->Is(MEASURE) || !end || !end->Is(MEASURE)) {
+            LogWarning("Measure '%s' or '%s' not found on page %d", startMeasure.c_str(), endMeasure.c_str(), pageNo);
+            return "";
+        }
+        if (!start->HasContentBB() || !end->HasContentBB()) {
+            LogWarning("Measure '%s' or '%s' has no bounding box", startMeasure.c_str(), endMeasure.c_str());
+            return "";
+        }
+        // The y axis is flipped in the output
+        const int pageHeight = m_doc.m_drawingPageContentHeight;
+        x = std::min(start->GetContentLeft(), end->GetContentLeft());
+        y = pageHeight - std::max(start->GetContentTop(), end->GetContentTop());
+        width = std::max(start->GetContentRight(), end->GetContentRight()) - x;
+        height = pageHeight - std::min(start->GetContentBottom(), end->GetContentBottom()) - y;
+    }
+
+    if ((width != VRV_UNSET) && (height != VRV_UNSET)) {
+        m_view.SetDrawingRegion(x, y, x + width, y + height);
+    }
+
+    std::string output = this->RenderToSVG(pageNo);
+    m_view.ResetDrawingRegion();
+    return output;
 }
 
 bool Toolkit::RenderToSVGFile(const std::string &filename, int pageNo)
@@ -1448,6 +1804,123 @@ bool Toolkit::RenderToSVGFile(const std::string &filename, int pageNo)
     return true;
 }
 
+std::string Toolkit::RenderToBinary(int pageNo)
+{
+    std::vector<unsigned char> output;
+    this->RenderToBinary(output, pageNo);
+
+    return Base64Encode(output.data(), (unsigned int)output.size());
+}
+
+void Toolkit::RenderToBinary(std::vector<unsigned char> &output, int pageNo)
+{
+    this->ResetLogBuffer();
+
+    int initialPageNo = (m_doc.GetDrawingPage() == NULL) ? -1 : m_doc.GetDrawingPage()->GetIdx();
+
+    BinaryDeviceContext binary;
+    binary.SetResources(&m_doc.GetResources());
+
+    if (m_doc.GetType() == Facs) {
+        binary.SetFacsimile(true);
+    }
+
+    // render the page
+    output.clear();
+    if (this->RenderToDeviceContext(pageNo, &binary)) {
+        binary.GetBinary(output);
+    }
+
+    if (initialPageNo >= 0) m_doc.SetDrawingPage(initialPageNo);
+}
+
+bool Toolkit::RenderToBinaryFile(const std::string &filename, int pageNo)
+{
+    std::vector<unsigned char> output;
+    this->RenderToBinary(output, pageNo);
+
+    std::ofstream outfile(filename.c_str(), std::ios::binary);
+    if (!outfile.is_open()) {
+        return false;
+    }
+
+    outfile.write(reinterpret_cast<const char *>(output.data()), output.size());
+    outfile.close();
+    return true;
+}
+
+std::string Toolkit::RenderToPNG(int pageNo)
+{
+    std::vector<unsigned char> output;
+    this->RenderToPNG(output, pageNo);
+
+    return Base64Encode(output.data(), (unsigned int)output.size());
+}
+
+void Toolkit::RenderToPNG(std::vector<unsigned char> &output, int pageNo)
+{
+    this->ResetLogBuffer();
+
+    int initialPageNo = (m_doc.GetDrawingPage() == NULL) ? -1 : m_doc.GetDrawingPage()->GetIdx();
+
+    RasterDeviceContext raster;
+    raster.SetResources(&m_doc.GetResources());
+
+    if (m_doc.GetType() == Facs) {
+        raster.SetFacsimile(true);
+    }
+
+    if (!m_options->m_pngBackground.GetValue().empty()) {
+        const int colour = RasterDeviceContext::ParseColour(m_options->m_pngBackground.GetValue());
+        if (colour == AxNONE) {
+            LogWarning("Invalid PNG background colour '%s'", m_options->m_pngBackground.GetValue().c_str());
+        }
+        raster.SetBackground(colour);
+    }
+
+    // render the page
+    output.clear();
+    if (this->RenderToDeviceContext(pageNo, &raster)) {
+#ifndef NO_MXL_SUPPORT
+        std::vector<unsigned char> rgba;
+        raster.GetRGBA(rgba);
+        // Use the deflate of the embedded miniz
+        size_t size = 0;
+        void *png = tdefl_write_image_to_png_file_in_memory_ex(
+            rgba.data(), raster.GetPixelWidth(), raster.GetPixelHeight(), 4, &size, MZ_DEFAULT_LEVEL, MZ_FALSE);
+        if (png) {
+            output.assign((unsigned char *)png, (unsigned char *)png + size);
+            mz_free(png);
+        }
+        else {
+            LogError("The PNG image could not be encoded");
+        }
+#else
+        LogError("PNG output is not supported in this build.");
+#endif
+    }
+
+    if (initialPageNo >= 0) m_doc.SetDrawingPage(initialPageNo);
+}
+
+bool Toolkit::RenderToPNGFile(const std::string &filename, int pageNo)
+{
+    std::vector<unsigned char> output;
+    this->RenderToPNG(output, pageNo);
+    if (output.empty()) {
+        return false;
+    }
+
+    std::ofstream outfile(filename.c_str(), std::ios::binary);
+    if (!outfile.is_open()) {
+        return false;
+    }
+
+    outfile.write(reinterpret_cast<const char *>(output.data()), output.size());
+    outfile.close();
+    return true;
+}
+
 std::string Toolkit::GetHumdrum()
 {
     return this->GetHumdrumBuffer();
@@ -1498,6 +1971,101 @@ void Toolkit::RenderToMIDI(smf::MidiFile* midiFile, MidiExt* midiExt) {
     midiFile->sortTracks();
 }
 
+std::string Toolkit::RenderToMIDIEvents()
+{
+    MidiStream midiStream;
+    this->RenderToMIDIEvents(&midiStream);
+
+    std::string output;
+    midiStream.ToJson(output);
+    return output;
+}
+
+void Toolkit::RenderToMIDIEvents(MidiStream *midiStream)
+{
+    assert(midiStream);
+
+    this->ResetLogBuffer();
+
+    // The tracks are filled in memory only and the stream sorts the events itself
+    midiStream->Reset();
+    smf::MidiFile midiFile;
+    midiFile.absoluteTicks();
+    m_doc.ExportMIDI(&midiFile, nullptr, NULL, midiStream);
+}
+
+std::string Toolkit::RenderToMIDIChunk(const std::string &jsonOptions)
+{
+    this->ResetLogBuffer();
+
+    std::string firstMeasureID;
+    std::string lastMeasureID;
+    int firstRepeat = 0;
+    int lastRepeat = 0;
+    int startTime = VRV_UNSET;
+    int endTime = VRV_UNSET;
+    bool continued = false;
+
+    jsonxx::Object json;
+
+    if (!json.parse(jsonOptions)) {
+        LogError("Cannot parse JSON std::string.");
+        return "";
+    }
+    if (json.has<jsonxx::String>("firstMeasure")) firstMeasureID = json.get<jsonxx::String>("firstMeasure");
+    if (json.has<jsonxx::String>("lastMeasure")) lastMeasureID = json.get<jsonxx::String>("lastMeasure");
+    if (json.has<jsonxx::Number>("firstRepeat")) firstRepeat = json.get<jsonxx::Number>("firstRepeat");
+    if (json.has<jsonxx::Number>("lastRepeat")) lastRepeat = json.get<jsonxx::Number>("lastRepeat");
+    if (json.has<jsonxx::Number>("startTime")) startTime = json.get<jsonxx::Number>("startTime");
+    if (json.has<jsonxx::Number>("endTime")) endTime = json.get<jsonxx::Number>("endTime");
+    if (json.has<jsonxx::Boolean>("continued")) continued = json.get<jsonxx::Boolean>("continued");
+
+    // Here we need to check that the midi timemap is done
+    if (!m_doc.HasTimemap()) {
+        // generate MIDI timemap before progressing
+        m_doc.CalculateTimemap();
+    }
+
+    Measure *firstMeasure = NULL;
+    Measure *lastMeasure = NULL;
+    if (!firstMeasureID.empty()) {
+        firstMeasure = dynamic_cast<Measure *>(m_doc.FindDescendantByID(firstMeasureID));
+        lastMeasure = (lastMeasureID.empty()) ? firstMeasure
+                                              : dynamic_cast<Measure *>(m_doc.FindDescendantByID(lastMeasureID));
+        if (lastMeasureID.empty()) lastRepeat = firstRepeat;
+    }
+    else if ((startTime != VRV_UNSET) && (endTime != VRV_UNSET)) {
+        std::vector<const TimemapIndex::MeasureEntry *> measureEntries;
+        m_doc.FindMeasuresInTimeRange(startTime, endTime, measureEntries);
+        // The entries are sorted by onset and the chunk goes from the pass played first to the one played last
+        if (!measureEntries.empty()) {
+            firstMeasure = measureEntries.front()->m_measure;
+            firstRepeat = measureEntries.front()->m_repeat;
+            lastMeasure = measureEntries.back()->m_measure;
+            lastRepeat = measureEntries.back()->m_repeat;
+        }
+    }
+
+    if (!firstMeasure || !lastMeasure) {
+        LogError("The measures of the MIDI chunk could not be found.");
+        return "";
+    }
+
+    smf::MidiFile outputfile;
+    outputfile.absoluteTicks();
+    if (!m_doc.ExportMIDIChunk(&outputfile, firstMeasure, firstRepeat, lastMeasure, lastRepeat, continued)) {
+        return "";
+    }
+    outputfile.sortTracks();
+
+    std::stringstream stream;
+    outputfile.write(stream);
+    std::string outputstr = Base64Encode(
+        reinterpret_cast<const unsigned char *>(stream.str().c_str()), (unsigned int)stream.str().length());
+
+    return outputstr;
+}
+
 std::string Toolkit::RenderToPAE()
 {
     this->ResetLogBuffer();
@@ -1560,10 +2128,9 @@ std::string Toolkit::GetElementsAtTime(int millisec)
 {
     this->ResetLogBuffer();
 
-    jsonxx::Object o;
-    jsonxx::Array noteArray;
-    jsonxx::Array chordArray;
-    jsonxx::Array restArray;
+    std::string output;
+    JsonWriter writer(output);
+    writer.StartObject();
 
     // Here we need to check that the midi timemap is done
     if (!m_doc.HasTimemap()) {
@@ -1571,52 +2138,137 @@ std::string Toolkit::GetElementsAtTime(int millisec)
         m_doc.CalculateTimemap();
     }
 
-    MeasureOnsetOffsetComparison matchMeasureTime(millisec);
-    Measure *measure = dynamic_cast<Measure *>(m_doc.FindDescendantByComparison(&matchMeasureTime));
+    const TimemapIndex::MeasureEntry *measureEntry = m_doc.FindMeasureAtTime(millisec);
 
-    if (!measure) {
-        return o.json();
+    if (!measureEntry) {
+        writer.EndObject();
+        return output;
     }
 
-    int repeat = measure->EnclosesTime(millisec);
-    int measureTimeOffset = measure->GetRealTimeOffsetMilliseconds(repeat);
+    Measure *measure = measureEntry->m_measure;
 
     // Get the pageNo from the first note (if any)
     int pageNo = -1;
     Page *page = dynamic_cast<Page *>(measure->GetFirstAncestor(PAGE));
     if (page) pageNo = page->GetIdx() + 1;
 
-    NoteOrRestOnsetOffsetComparison matchTime(millisec - measureTimeOffset);
     ListOfObjects notesOrRests;
     ListOfObjects chords;
 
-    measure->FindAllDescendantsByComparison(&notesOrRests, &matchTime);
+    m_doc.FindNotesOrRestsAtTime(measureEntry, millisec, notesOrRests);
 
-    // Fill the JSON object
     for (auto const item : notesOrRests) {
-        if (item->Is(NOTE)) {
-            noteArray << item->GetID();
-            Note *note = vrv_cast<Note *>(item);
-            assert(note);
-            Chord *chord = note->IsChordTone();
-            if (chord) chords.push_back(chord);
-        }
-        else if (item->Is(REST)) {
-            restArray << item->GetID();
-        }
+        if (!item->Is(NOTE)) continue;
+        Note *note = vrv_cast<Note *>(item);
+        assert(note);
+        Chord *chord = note->IsChordTone();
+        if (chord) chords.push_back(chord);
     }
     chords.unique();
+
+    // Fill the JSON object, with the keys in alphabetical order
+    writer.StartArray("chords");
     for (auto const item : chords) {
-        chordArray << item->GetID();
+        writer.AddString(item->GetID());
+    }
+    writer.EndArray();
+    writer.AddString("measure", measure->GetID());
+    writer.StartArray("notes");
+    for (auto const item : notesOrRests) {
+        if (item->Is(NOTE)) writer.AddString(item->GetID());
+    }
+    writer.EndArray();
+    writer.AddNumber("page", pageNo);
+    writer.StartArray("rests");
+    for (auto const item : notesOrRests) {
+        if (item->Is(REST)) writer.AddString(item->GetID());
     }
+    writer.EndArray();
 
-    o << "notes" << noteArray;
-    o << "chords" << chordArray;
-    o << "rests" << restArray;
-    o << "page" << pageNo;
-    o << "measure" << measure->GetID();
+    writer.EndObject();
+    return output;
+}
 
-    return o.json();
+std::string Toolkit::GetElementsInTimeRange(int startMillisec, int endMillisec)
+{
+    this->ResetLogBuffer();
+
+    std::string output;
+    JsonWriter writer(output);
+    writer.StartArray();
+
+    // Here we need to check that the midi timemap is done
+    if (!m_doc.HasTimemap()) {
+        // generate MIDI timemap before progressing
+        m_doc.CalculateTimemap();
+    }
+
+    std::vector<const TimemapIndex::MeasureEntry *> measureEntries;
+    m_doc.FindMeasuresInTimeRange(startMillisec, endMillisec, measureEntries);
+
+    // Write the id, onset and offset of an element, with the keys in alphabetical order
+    auto writeElement = [&writer](const Object *object, double onset, double offset) {
+        writer.StartObject();
+        writer.AddString("id", object->GetID());
+        writer.AddNumber("off", offset);
+        writer.AddNumber("on", onset);
+        writer.EndObject();
+    };
+
+    for (const TimemapIndex::MeasureEntry *measureEntry : measureEntries) {
+        int pageNo = -1;
+        Page *page = dynamic_cast<Page *>(measureEntry->m_measure->GetFirstAncestor(PAGE));
+        if (page) pageNo = page->GetIdx() + 1;
+
+        std::vector<const TimemapIndex::NoteOrRestEntry *> notesOrRests;
+        m_doc.FindNotesOrRestsInTimeRange(measureEntry, startMillisec, endMillisec, notesOrRests);
+
+        // The times of the notes and rests are given in absolute time as in the timemap
+        const double measureOffset = measureEntry->m_onset;
+        std::vector<std::pair<Chord *, std::pair<double, double>>> chords;
+        for (const TimemapIndex::NoteOrRestEntry *entry : notesOrRests) {
+            if (!entry->m_object->Is(NOTE)) continue;
+            Note *note = vrv_cast<Note *>(entry->m_object);
+            assert(note);
+            Chord *chord = note->IsChordTone();
+            if (!chord) continue;
+            // A chord is played from the onset of its first note to the offset of its last one
+            if (chords.empty() || (chords.back().first != chord)) {
+                chords.push_back({ chord, { entry->m_onset, entry->m_offset } });
+            }
+            else {
+                chords.back().second.first = std::min(chords.back().second.first, entry->m_onset);
+                chords.back().second.second = std::max(chords.back().second.second, entry->m_offset);
+            }
+        }
+
+        writer.StartObject();
+        writer.StartArray("chords");
+        for (auto const &chord : chords) {
+            writeElement(chord.first, chord.second.first + measureOffset, chord.second.second + measureOffset);
+        }
+        writer.EndArray();
+        writer.AddString("measure", measureEntry->m_measure->GetID());
+        writer.StartArray("notes");
+        for (const TimemapIndex::NoteOrRestEntry *entry : notesOrRests) {
+            if (!entry->m_object->Is(NOTE)) continue;
+            writeElement(entry->m_object, entry->m_onset + measureOffset, entry->m_offset + measureOffset);
+        }
+        writer.EndArray();
+        writer.AddNumber("off", measureEntry->m_offset);
+        writer.AddNumber("on", measureEntry->m_onset);
+        writer.AddNumber("page", pageNo);
+        writer.StartArray("rests");
+        for (const TimemapIndex::NoteOrRestEntry *entry : notesOrRests) {
+            if (!entry->m_object->Is(REST)) continue;
+            writeElement(entry->m_object, entry->m_onset + measureOffset, entry->m_offset + measureOffset);
+        }
+        writer.EndArray();
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+    return output;
 }
 
 bool Toolkit::RenderToMIDIFile(const std::string &filename)
@@ -1724,53 +2376,191 @@ std::string Toolkit::GetTimesForElement(const std::string &xmlId)
     this->ResetLogBuffer();
 
     Object *element = m_doc.FindDescendantByID(xmlId);
-    jsonxx::Object o;
+    std::string output;
+    JsonWriter writer(output);
+    writer.StartObject();
 
     if (!element) {
         LogWarning("Element '%s' not found", xmlId.c_str());
-        return o.json();
+        writer.EndObject();
+        return output;
     }
 
-    jsonxx::Array scoreTimeOnset;
-    jsonxx::Array scoreTimeOffset;
-    jsonxx::Array scoreTimeDuration;
-    jsonxx::Array scoreTimeTiedDuration;
-    jsonxx::Array realTimeOnsetMilliseconds;
-    jsonxx::Array realTimeOffsetMilliseconds;
-
     if (!m_doc.HasTimemap()) {
         // generate MIDI timemap before progressing
         m_doc.CalculateTimemap();
     }
     if (!m_doc.HasTimemap()) {
         LogWarning("Calculation of MIDI timemap failed, time value is invalid.");
-        return o.json();
+        writer.EndObject();
+        return output;
     }
     if (element->Is(NOTE)) {
 
         Note *note = vrv_cast<Note *>(element);
         assert(note);
-        Measure *measure = vrv_cast<Measure *>(note->GetFirstAncestor(MEASURE));
-        assert(measure);
 
-        // For now ignore repeats and access always the first
-        double offset = measure->GetRealTimeOffsetMilliseconds(1);
-        realTimeOffsetMilliseconds << offset + note->GetRealTimeOffsetMilliseconds();
-        realTimeOnsetMilliseconds << offset + note->GetRealTimeOnsetMilliseconds();
-
-        scoreTimeOnset << note->GetScoreTimeOnset();
-        scoreTimeOffset << note->GetScoreTimeOffset();
-        scoreTimeDuration << note->GetScoreTimeDuration();
-        scoreTimeTiedDuration << note->GetScoreTimeTiedDuration();
-
-        o << "scoreTimeOnset" << scoreTimeOnset;
-        o << "scoreTimeOffset" << scoreTimeOffset;
-        o << "scoreTimeDuration" << scoreTimeDuration;
-        o << "scoreTimeTiedDuration" << scoreTimeTiedDuration;
-        o << "realTimeOnsetMilliseconds" << realTimeOnsetMilliseconds;
-        o << "realTimeOffsetMilliseconds" << realTimeOffsetMilliseconds;
+        // The real times are given for each time the note is played, with the keys in alphabetical order
+        const TimemapIndex::ElementEntry *elementEntry = m_doc.FindElementTimes(xmlId);
+        std::vector<TimemapIndex::ElementTimes> realTimes;
+        if (elementEntry) {
+            for (int repeat = 1; repeat <= elementEntry->m_measure->GetRealTimeRepeatCount(); ++repeat) {
+                realTimes.push_back(m_doc.GetElementTimes(elementEntry, repeat));
+            }
+        }
+        writer.StartArray("realTimeOffsetMilliseconds");
+        for (const TimemapIndex::ElementTimes &times : realTimes) writer.AddNumber(times.m_offset);
+        writer.EndArray();
+        writer.StartArray("realTimeOnsetMilliseconds");
+        for (const TimemapIndex::ElementTimes &times : realTimes) writer.AddNumber(times.m_onset);
+        writer.EndArray();
+
+        const std::pair<std::string, double> values[] = {
+            { "scoreTimeDuration", note->GetScoreTimeDuration() },
+            { "scoreTimeOffset", note->GetScoreTimeOffset() },
+            { "scoreTimeOnset", note->GetScoreTimeOnset() },
+            { "scoreTimeTiedDuration", note->GetScoreTimeTiedDuration() },
+        };
+        for (const auto &value : values) {
+            writer.StartArray(value.first);
+            writer.AddNumber(value.second);
+            writer.EndArray();
+        }
     }
-    return o.json();
+    writer.EndObject();
+    return output;
+}
+
+std::string Toolkit::GetTimesForElements(const std::string &jsonOptions)
+{
+    this->ResetLogBuffer();
+
+    std::vector<std::string> ids;
+    std::string type = "note";
+    std::string firstMeasureID;
+    std::string lastMeasureID;
+    bool repeats = false;
+
+    jsonxx::Object json;
+
+    std::string output;
+    JsonWriter writer(output);
+    writer.StartObject();
+
+    if (!json.parse(jsonOptions)) {
+        LogError("Cannot parse JSON std::string.");
+        writer.EndObject();
+        return output;
+    }
+    if (json.has<jsonxx::Array>("ids")) {
+        const jsonxx::Array &array = json.get<jsonxx::Array>("ids");
+        for (int i = 0; i < (int)array.size(); ++i) {
+            if (array.has<jsonxx::String>(i)) ids.push_back(array.get<jsonxx::String>(i));
+        }
+    }
+    if (json.has<jsonxx::String>("type")) type = json.get<jsonxx::String>("type");
+    if (json.has<jsonxx::String>("firstMeasure")) firstMeasureID = json.get<jsonxx::String>("firstMeasure");
+    if (json.has<jsonxx::String>("lastMeasure")) lastMeasureID = json.get<jsonxx::String>("lastMeasure");
+    if (json.has<jsonxx::Boolean>("repeats")) repeats = json.get<jsonxx::Boolean>("repeats");
+
+    ClassId classId = NOTE;
+    if (type == "chord") {
+        classId = CHORD;
+    }
+    else if (type == "rest") {
+        classId = REST;
+    }
+    else if (type != "note") {
+        LogWarning("Type '%s' not supported, looking for notes", type.c_str());
+    }
+
+    if (!m_doc.HasTimemap()) {
+        // generate MIDI timemap before progressing
+        m_doc.CalculateTimemap();
+    }
+    if (!m_doc.HasTimemap()) {
+        LogWarning("Calculation of MIDI timemap failed, time value is invalid.");
+        writer.EndObject();
+        return output;
+    }
+
+    const TimemapIndex &timemapIndex = m_doc.GetTimemapIndex();
+
+    // The measures in the range are looked for with their first repeat
+    std::set<const Measure *> measures;
+    if (!firstMeasureID.empty() || !lastMeasureID.empty()) {
+        bool inRange = firstMeasureID.empty();
+        for (const TimemapIndex::MeasureEntry &measureEntry : timemapIndex.m_measures) {
+            if (measureEntry.m_repeat != 1) continue;
+            if (!inRange && (measureEntry.m_measure->GetID() == firstMeasureID)) inRange = true;
+            if (!inRange) continue;
+            measures.insert(measureEntry.m_measure);
+            if (measureEntry.m_measure->GetID() == lastMeasureID) break;
+        }
+    }
+    auto isInRange = [&firstMeasureID, &lastMeasureID, &measures](const TimemapIndex::ElementEntry *element) {
+        if (firstMeasureID.empty() && lastMeasureID.empty()) return true;
+        return (measures.count(element->m_measure) > 0);
+    };
+
+    // With IDs, the elements are given in the same order and the ones not found are skipped
+    std::vector<const TimemapIndex::ElementEntry *> selected;
+    if (ids.empty()) {
+        for (const std::vector<TimemapIndex::ElementEntry> &elements : timemapIndex.m_elements) {
+            for (const TimemapIndex::ElementEntry &element : elements) {
+                if (element.m_object->Is(classId) && isInRange(&element)) selected.push_back(&element);
+            }
+        }
+    }
+    else {
+        for (const std::string &id : ids) {
+            const TimemapIndex::ElementEntry *element = m_doc.FindElementTimes(id);
+            if (element && isInRange(element)) {
+                selected.push_back(element);
+            }
+            else {
+                LogWarning("Element '%s' not found", id.c_str());
+            }
+        }
+    }
+
+    // The times of each pass, or of the first one only
+    struct ElementTimes {
+        const TimemapIndex::ElementEntry *m_element;
+        TimemapIndex::ElementTimes m_times;
+        int m_repeat;
+    };
+    std::vector<ElementTimes> elementTimes;
+    for (const TimemapIndex::ElementEntry *element : selected) {
+        const int passCount = (repeats) ? element->m_measure->GetRealTimeRepeatCount() : 1;
+        for (int repeat = 1; repeat <= passCount; ++repeat) {
+            elementTimes.push_back({ element, m_doc.GetElementTimes(element, repeat), repeat });
+        }
+    }
+
+    writer.StartArray("ids");
+    for (const ElementTimes &times : elementTimes) writer.AddString(times.m_element->m_object->GetID());
+    writer.EndArray();
+    writer.StartArray("offsets");
+    for (const ElementTimes &times : elementTimes) writer.AddNumber(times.m_times.m_offset);
+    writer.EndArray();
+    writer.StartArray("onsets");
+    for (const ElementTimes &times : elementTimes) writer.AddNumber(times.m_times.m_onset);
+    writer.EndArray();
+    writer.StartArray("pitches");
+    for (const ElementTimes &times : elementTimes) {
+        const Object *object = times.m_element->m_object;
+        writer.AddNumber((object->Is(NOTE)) ? vrv_cast<const Note *>(object)->GetMIDIPitch() : -1);
+    }
+    writer.EndArray();
+    if (repeats) {
+        writer.StartArray("repeats");
+        for (const ElementTimes &times : elementTimes) writer.AddNumber(times.m_repeat);
+        writer.EndArray();
+    }
+
+    writer.EndObject();
+    return output;
 }
 
 std::string Toolkit::GetMIDIValuesForElement(const std::string &xmlId)
@@ -1871,6 +2661,12 @@ const char *Toolkit::GetCString()
     }
 }
 
+void Toolkit::SetCBuffer(std::vector<unsigned char> &data)
+{
+    m_cBuffer.swap(data);
+    data.clear();
+}
+
 void Toolkit::ClearHumdrumBuffer()
 {
 #ifndef NO_HUMDRUM_SUPPORT
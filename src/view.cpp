@@ -30,6 +30,7 @@ View::View()
     m_options = NULL;
     m_pageIdx = 0;
     m_slurHandling = SlurHandling::Initialize;
+    this->ResetDrawingRegion();
 
     m_currentColour = AxNONE;
     m_currentElement = NULL;
@@ -41,6 +42,22 @@ View::View()
 
 View::~View() {}
 
+void View::SetDrawingRegion(int x1, int y1, int x2, int y2)
+{
+    m_regionX1 = std::min(x1, x2);
+    m_regionY1 = std::min(y1, y2);
+    m_regionX2 = std::max(x1, x2);
+    m_regionY2 = std::max(y1, y2);
+}
+
+void View::ResetDrawingRegion()
+{
+    m_regionX1 = VRV_UNSET;
+    m_regionY1 = VRV_UNSET;
+    m_regionX2 = VRV_UNSET;
+    m_regionY2 = VRV_UNSET;
+}
+
 void View::SetDoc(Doc *doc)
 {
     // Unset the doc
@@ -97,6 +97,7 @@ void View::DrawCurrentPage(DeviceContext *dc, bool background)
         }
         else if (child->Is(SYSTEM)) {
             System *system = dynamic_cast<System *>(child);
+            if (!this->IsInDrawingRegion(system)) continue;
             this->DrawSystem(dc, system);
         }
         else {
@@ -197,8 +198,11 @@ void View::DrawSystem(DeviceContext *dc, System *system)
 
     // first we need to clear the drawing list of postponed elements
     system->ResetDrawingList();
+    // and the spanned element index that is rebuilt once the layer elements are drawn
+    system->ResetSpannedElementIndex();
 
-    if (firstMeasure) {
+    // The initial scoreDef is drawn only if the region starts before the first measure
+    if (firstMeasure && (!this->HasDrawingRegion() || (m_regionX1 <= firstMeasure->GetDrawingX()))) {
         this->DrawScoreDef(dc, system->GetDrawingScoreDef(), firstMeasure, system->GetDrawingX(), NULL);
     }
 
@@ -1578,7 +1582,12 @@ void View::DrawSystemChildren(DeviceContext *dc, Object *parent, System *system)
     for (auto current : parent->GetChildren()) {
         if (current->Is(MEASURE)) {
             // cast to Measure check in DrawMeasure
-            this->DrawMeasure(dc, dynamic_cast<Measure *>(current), system);
+            if (this->IsInDrawingRegion(current)) {
+                this->DrawMeasure(dc, dynamic_cast<Measure *>(current), system);
+            }
+            else {
+                this->AddMeasureToDrawingList(vrv_cast<Measure *>(current), system);
+            }
         }
         // scoreDef are not drawn directly, but anything else should not be possible
         else if (current->Is(SCOREDEF)) {
@@ -1607,6 +1616,44 @@ void View::DrawSystemChildren(DeviceContext *dc, Object *parent, System *system)
     }
 }
 
+bool View::IsInDrawingRegion(Object *object)
+{
+    assert(object);
+
+    if (!this->HasDrawingRegion() || !object->HasContentBB()) return true;
+
+    // The y axis is flipped in the output
+    if (object->GetContentRight() < m_regionX1) return false;
+    if (object->GetContentLeft() > m_regionX2) return false;
+    if (this->ToDeviceContextY(object->GetContentTop()) > m_regionY2) return false;
+    if (this->ToDeviceContextY(object->GetContentBottom()) < m_regionY1) return false;
+
+    return true;
+}
+
+void View::AddMeasureToDrawingList(Measure *measure, System *system)
+{
+    assert(measure);
+    assert(system);
+
+    for (Object *child : measure->GetChildren()) {
+        if (child->Is(STAFF)) {
+            Staff *staff = vrv_cast<Staff *>(child);
+            assert(staff);
+            for (auto &spanningElement : staff->m_timeSpanningElements) {
+                system->AddToDrawingListIfNecessary(spanningElement);
+            }
+        }
+        else if (child->IsControlElement()) {
+            system->AddToDrawingListIfNecessary(child);
+        }
+    }
+
+    if (measure->GetDrawingEnding()) {
+        system->AddToDrawingList(measure->GetDrawingEnding());
+    }
+}
+
 void View::DrawMeasureChildren(DeviceContext *dc, Object *parent, Measure *measure, System *system)
 {
     assert(dc);
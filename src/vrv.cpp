@@ -15,6 +15,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <locale>
+#include <mutex>
 #include <sstream>
 #include <stdarg.h>
 #include <stdio.h>
@@ -72,6 +73,9 @@ bool loggingToBuffer = false;
 
 std::vector<std::string> logBuffer;
 
+/** For logging to the buffer from several threads */
+std::mutex logBufferMutex;
+
 void LogElapsedTimeStart()
 {
     gettimeofday(&start, NULL);
@@ -150,6 +154,7 @@ void EnableLogToBuffer(bool value)
 void LogString(std::string message, consoleLogLevel level)
 {
     if (loggingToBuffer) {
+        const std::lock_guard<std::mutex> lock(logBufferMutex);
         if (LogBufferContains(message)) return;
         logBuffer.push_back(message);
     }
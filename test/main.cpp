@@ -0,0 +1,143 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        main.cpp
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+#include "test.h"
+#include "toolkit.h"
+#include "vrv.h"
+
+//----------------------------------------------------------------------------
+
+namespace vrv {
+
+static std::string s_resourcePath = "../data";
+
+void TestSetResourcePath(Toolkit *toolkit)
+{
+    toolkit->SetResourcePath(s_resourcePath);
+}
+
+bool TestFail(const std::string &check, const std::string &message)
+{
+    std::cerr << check << ": " << message << std::endl;
+    return false;
+}
+
+std::string TestGenerateMEI(int measureCount, int staffCount, bool expansion)
+{
+    const std::string pnames = "cdefgab";
+    std::string mei = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                      "<mei xmlns=\"http://www.music-encoding.org/ns/mei\" meiversion=\"5.0.0-dev\">"
+                      "<meiHead><fileDesc><titleStmt><title/></titleStmt><pubStmt/></fileDesc></meiHead>"
+                      "<music><body><mdiv><score><scoreDef midi.bpm=\"100\" meter.count=\"4\" meter.unit=\"4\">"
+                      "<staffGrp>";
+    for (int staff = 1; staff <= staffCount; ++staff) {
+        const std::string clef
+            = (staff % 2) ? "clef.shape=\"G\" clef.line=\"2\"" : "clef.shape=\"F\" clef.line=\"4\"";
+        mei += "<staffDef n=\"" + std::to_string(staff) + "\" lines=\"5\" " + clef + "/>";
+    }
+    mei += "</staffGrp></scoreDef><section>";
+    if (expansion) mei += "<expansion xml:id=\"exp\" plist=\"#A #A #B #A\"/><section xml:id=\"A\">";
+
+    const int half = measureCount / 2;
+    for (int measure = 1; measure <= measureCount; ++measure) {
+        if (measure == half + 1) {
+            if (expansion) mei += "</section><section xml:id=\"B\">";
+            mei += "<scoreDef key.sig=\"2s\"/>";
+        }
+        const std::string measureID = "m" + std::to_string(measure);
+        mei += "<measure xml:id=\"" + measureID + "\" n=\"" + std::to_string(measure) + "\">";
+        for (int staff = 1; staff <= staffCount; ++staff) {
+            mei += "<staff n=\"" + std::to_string(staff) + "\"><layer n=\"1\">";
+            for (int note = 1; note <= 4; ++note) {
+                const std::string id
+                    = "n" + std::to_string(measure) + "-" + std::to_string(staff) + "-" + std::to_string(note);
+                // The first note of a measure repeats the last one of the previous measure for the ties
+                const int step = measure + staff + ((note == 1) ? 3 : note);
+                const std::string oct = std::to_string(((staff % 2) ? 4 : 3) + (step % 14) / 7);
+                mei += "<note xml:id=\"" + id + "\" dur=\"4\" pname=\"" + pnames.at(step % 7) + "\" oct=\"" + oct
+                    + "\"/>";
+            }
+            mei += "</layer></staff>";
+        }
+        if (measure == half) mei += "<tempo tstamp=\"1\" staff=\"1\" midi.bpm=\"140\">Allegro</tempo>";
+        // Ties to the next measure, which is in the same section
+        if ((measure % 3 == 0) && (measure != half) && (measure != measureCount)) {
+            for (int staff = 1; staff <= staffCount; ++staff) {
+                const std::string suffix = "-" + std::to_string(staff);
+                mei += "<tie startid=\"#n" + std::to_string(measure) + suffix + "-4\" endid=\"#n"
+                    + std::to_string(measure + 1) + suffix + "-1\"/>";
+            }
+        }
+        mei += "</measure>";
+    }
+    if (expansion) mei += "</section>";
+    mei += "</section></score></mdiv></body></music></mei>\n";
+    return mei;
+}
+
+} // namespace vrv
+
+//----------------------------------------------------------------------------
+
+// The checks by name, run all or by their names given on the command line
+static const std::map<std::string, bool (*)()> s_checks = {
+    { "breaksestimate", &vrv::TestBreaksEstimate },
+    { "jsonwriter", &vrv::TestJsonWriter },
+    { "midichunks", &vrv::TestMIDIChunks },
+    { "midithreads", &vrv::TestMIDIThreads },
+    { "svgdocument", &vrv::TestSVGDocument },
+    { "timemap", &vrv::TestTimemap },
+};
+
+// The benchmarks, only run by their names
+static const std::map<std::string, void (*)()> s_benchmarks = {
+    { "slurs", &vrv::BenchmarkSlurs },
+};
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> names;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if ((arg == "-r") && (i + 1 < argc)) {
+            vrv::s_resourcePath = argv[++i];
+        }
+        else {
+            names.push_back(arg);
+        }
+    }
+    if (names.empty()) {
+        for (const auto &check : s_checks) names.push_back(check.first);
+    }
+
+    vrv::EnableLog(false);
+
+    int failed = 0;
+    for (const std::string &name : names) {
+        if (s_benchmarks.count(name) != 0) {
+            s_benchmarks.at(name)();
+            continue;
+        }
+        if (s_checks.count(name) == 0) {
+            std::cerr << "Unknown check '" << name << "'" << std::endl;
+            ++failed;
+            continue;
+        }
+        const bool passed = s_checks.at(name)();
+        std::cout << name << ": " << (passed ? "passed" : "FAILED") << std::endl;
+        if (!passed) ++failed;
+    }
+
+    return (failed > 0) ? 1 : 0;
+}
@@ -0,0 +1,59 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        test.h
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef __VRV_TEST_H__
+#define __VRV_TEST_H__
+
+#include <string>
+
+//----------------------------------------------------------------------------
+
+namespace vrv {
+
+class Toolkit;
+
+//----------------------------------------------------------------------------
+// Helpers for the regression checks
+//----------------------------------------------------------------------------
+
+/**
+ * Set the resource path of a toolkit to the one given to the test program.
+ */
+void TestSetResourcePath(Toolkit *toolkit);
+
+/**
+ * Log a failure of the check and return false.
+ */
+bool TestFail(const std::string &check, const std::string &message);
+
+/**
+ * Generate an MEI document with the number of measures and staves given, with four quarter notes in each staff and
+ * measure, ties from the last note of every third measure, a tempo change and a key change halfway through.
+ * With an expansion, the measures are in two sections A and B, played with the expansion "exp" as A A B A.
+ */
+std::string TestGenerateMEI(int measureCount, int staffCount, bool expansion);
+
+//----------------------------------------------------------------------------
+// Regression checks, returning true when they pass
+//----------------------------------------------------------------------------
+
+bool TestBreaksEstimate();
+bool TestJsonWriter();
+bool TestMIDIChunks();
+bool TestMIDIThreads();
+bool TestSVGDocument();
+bool TestTimemap();
+
+//----------------------------------------------------------------------------
+// Benchmarks, printing their timings
+//----------------------------------------------------------------------------
+
+void BenchmarkSlurs();
+
+} // namespace vrv
+
+#endif // __VRV_TEST_H__
@@ -0,0 +1,96 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        test_jsonwriter.cpp
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "test.h"
+
+//----------------------------------------------------------------------------
+
+#include <limits>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+#include "jsonwriter.h"
+
+//----------------------------------------------------------------------------
+
+#include "jsonxx.h"
+
+namespace vrv {
+
+//----------------------------------------------------------------------------
+// JsonWriter
+//----------------------------------------------------------------------------
+
+bool TestJsonWriter()
+{
+    // Values that need the full precision, escaped strings and nested containers, with the keys in alphabetical
+    // order as jsonxx writes them
+    const std::vector<double> numbers = { 0.0, -1.0, 1.0 / 3.0, 1234.5678901234567, 6.02214076e23, -2.5e-12,
+        std::numeric_limits<double>::max(), 1000.0 * 60.0 / 97.0 };
+    const std::vector<std::string> strings = { "", "note-0001", "quote \" and backslash \\", "tab\tand\nnewline",
+        "UTF-8 \xC3\xA9t\xC3\xA9" };
+
+    jsonxx::Object expected;
+    jsonxx::Array expectedNumbers;
+    for (double number : numbers) expectedNumbers << number;
+    jsonxx::Array expectedStrings;
+    for (const std::string &string : strings) expectedStrings << string;
+    jsonxx::Object expectedEmpty;
+    jsonxx::Array expectedNested;
+    for (int i = 0; i < 3; ++i) {
+        jsonxx::Object item;
+        item << "id" << strings.at(i + 1);
+        item << "on" << numbers.at(i + 2);
+        expectedNested << item;
+    }
+    expected << "empty" << expectedEmpty;
+    expected << "false" << false;
+    expected << "nested" << expectedNested;
+    expected << "numbers" << expectedNumbers;
+    expected << "strings" << expectedStrings;
+    expected << "true" << true;
+
+    std::string output;
+    JsonWriter writer(output);
+    writer.StartObject();
+    writer.StartObject("empty");
+    writer.EndObject();
+    writer.AddBool("false", false);
+    writer.StartArray("nested");
+    for (int i = 0; i < 3; ++i) {
+        writer.StartObject();
+        writer.AddString("id", strings.at(i + 1));
+        writer.AddNumber("on", numbers.at(i + 2));
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.StartArray("numbers");
+    for (double number : numbers) writer.AddNumber(number);
+    writer.EndArray();
+    writer.AddStringArray("strings", strings);
+    writer.AddBool("true", true);
+    writer.EndObject();
+
+    if (output != expected.json()) {
+        return TestFail("jsonwriter", "the output differs from jsonxx:\n" + output + "\n" + expected.json());
+    }
+
+    // The numbers need to be read back exactly
+    jsonxx::Object parsed;
+    if (!parsed.parse(output)) return TestFail("jsonwriter", "the output cannot be parsed");
+    const jsonxx::Array &parsedNumbers = parsed.get<jsonxx::Array>("numbers");
+    for (int i = 0; i < (int)numbers.size(); ++i) {
+        if ((double)parsedNumbers.get<jsonxx::Number>(i) != numbers.at(i)) {
+            return TestFail("jsonwriter", "the number " + std::to_string(numbers.at(i)) + " is not read back exactly");
+        }
+    }
+
+    return true;
+}
+
+} // namespace vrv
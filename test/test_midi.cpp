@@ -0,0 +1,153 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        test_midi.cpp
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "test.h"
+
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+#include "toolkit.h"
+#include "vrv.h"
+
+//----------------------------------------------------------------------------
+
+#include "MidiFile.h"
+#include "jsonxx.h"
+
+namespace vrv {
+
+// The note on and off events as tick, track, on and key
+typedef std::multiset<std::tuple<int, int, bool, int>> MIDINoteEvents;
+
+static void CollectNoteEvents(smf::MidiFile &midiFile, int shift, MIDINoteEvents &events)
+{
+    for (int track = 0; track < midiFile.getTrackCount(); ++track) {
+        for (int i = 0; i < midiFile[track].size(); ++i) {
+            const smf::MidiEvent &event = midiFile[track][i];
+            if (event.isNoteOn() || event.isNoteOff()) {
+                events.insert({ event.tick + shift, track, event.isNoteOn(), event.getKeyNumber() });
+            }
+        }
+    }
+}
+
+static bool ReadBase64MIDI(const std::string &base64, smf::MidiFile &midiFile)
+{
+    const std::vector<unsigned char> bytes = Base64Decode(base64);
+    std::stringstream stream(std::string(bytes.begin(), bytes.end()));
+    if (!midiFile.read(stream)) return false;
+    midiFile.absoluteTicks();
+    return true;
+}
+
+// Render the document in chunks of consecutive measure passes, following the timemap, and check that the chunks give
+// the note events of the whole performance
+static bool CheckMIDIChunks(const std::string &options, int chunkSize)
+{
+    const std::string check = "midichunks";
+
+    Toolkit toolkit(false);
+    TestSetResourcePath(&toolkit);
+    toolkit.SetOptions(options);
+    if (!toolkit.LoadData(TestGenerateMEI(16, 2, true))) return TestFail(check, "the data cannot be loaded");
+
+    smf::MidiFile full;
+    toolkit.RenderToMIDI(&full, NULL);
+    full.absoluteTicks();
+    const int tpq = full.getTPQ();
+    MIDINoteEvents fullEvents;
+    CollectNoteEvents(full, 0, fullEvents);
+
+    jsonxx::Array timemap;
+    if (!timemap.parse(toolkit.RenderToTimemap("{\"includeMeasures\": true}"))) {
+        return TestFail(check, "the timemap cannot be parsed");
+    }
+    // The measure passes in the order played, with their score time
+    std::vector<std::tuple<std::string, int, double>> passes;
+    std::map<std::string, int> repeats;
+    for (int i = 0; i < (int)timemap.size(); ++i) {
+        const jsonxx::Object &entry = timemap.get<jsonxx::Object>(i);
+        if (!entry.has<jsonxx::String>("measureOn")) continue;
+        const std::string measureID = entry.get<jsonxx::String>("measureOn");
+        passes.push_back({ measureID, ++repeats[measureID], entry.get<jsonxx::Number>("qstamp") });
+    }
+    if (passes.empty()) return TestFail(check, "the timemap has no measures");
+
+    MIDINoteEvents chunkEvents;
+    for (int i = 0; i < (int)passes.size(); i += chunkSize) {
+        const auto &[firstMeasureID, firstRepeat, qstamp] = passes.at(i);
+        const auto &[lastMeasureID, lastRepeat, lastQstamp]
+            = passes.at(std::min(i + chunkSize, (int)passes.size()) - 1);
+        const std::string chunkOptions = "{\"firstMeasure\": \"" + firstMeasureID
+            + "\", \"firstRepeat\": " + std::to_string(firstRepeat) + ", \"lastMeasure\": \"" + lastMeasureID
+            + "\", \"lastRepeat\": " + std::to_string(lastRepeat)
+            + ", \"continued\": " + std::string((i > 0) ? "true" : "false") + "}";
+        smf::MidiFile chunk;
+        if (!ReadBase64MIDI(toolkit.RenderToMIDIChunk(chunkOptions), chunk)) {
+            return TestFail(check, "the chunk " + chunkOptions + " cannot be read");
+        }
+        CollectNoteEvents(chunk, (int)(qstamp * tpq + 0.5), chunkEvents);
+    }
+
+    if (chunkEvents != fullEvents) {
+        return TestFail(check,
+            "the chunks of " + std::to_string(chunkSize) + " measures with " + options + " have "
+                + std::to_string(chunkEvents.size()) + " note events and the whole document "
+                + std::to_string(fullEvents.size()));
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// MIDI chunks
+//----------------------------------------------------------------------------
+
+bool TestMIDIChunks()
+{
+    const std::vector<std::string> options
+        = { "{}", "{\"expand\": \"exp\"}", "{\"expand\": \"exp\", \"expandTimeline\": true}" };
+    for (const std::string &option : options) {
+        if (!CheckMIDIChunks(option, 1)) return false;
+        if (!CheckMIDIChunks(option, 3)) return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// MIDI threads
+//----------------------------------------------------------------------------
+
+bool TestMIDIThreads()
+{
+    // Enough notes for the staves to be exported concurrently
+    const std::string data = TestGenerateMEI(200, 4, false);
+    std::string sequential;
+    for (int threads : { 1, 2, 4 }) {
+        Toolkit toolkit(false);
+        TestSetResourcePath(&toolkit);
+        toolkit.SetOptions("{\"midiThreads\": " + std::to_string(threads) + "}");
+        if (!toolkit.LoadData(data)) return TestFail("midithreads", "the data cannot be loaded");
+        const std::string midi = toolkit.RenderToMIDI();
+        if (threads == 1) {
+            sequential = midi;
+        }
+        else if (midi != sequential) {
+            return TestFail("midithreads", "the MIDI file with " + std::to_string(threads) + " threads differs");
+        }
+    }
+    return true;
+}
+
+} // namespace vrv
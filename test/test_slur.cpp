@@ -0,0 +1,159 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        test_slur.cpp
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "test.h"
+
+//----------------------------------------------------------------------------
+
+#include <chrono>
+#include <iostream>
+
+//----------------------------------------------------------------------------
+
+#include "toolkit.h"
+
+namespace vrv {
+
+// Generate a piano score with eight eighth notes in each staff and measure, a slur over each half measure and a
+// phrase over every two measures
+static std::string GenerateSlurMEI(int measureCount)
+{
+    const std::string pnames = "cdefgab";
+    std::string mei = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                      "<mei xmlns=\"http://www.music-encoding.org/ns/mei\" meiversion=\"5.0.0-dev\">"
+                      "<meiHead><fileDesc><titleStmt><title/></titleStmt><pubStmt/></fileDesc></meiHead>"
+                      "<music><body><mdiv><score><scoreDef meter.count=\"4\" meter.unit=\"4\">"
+                      "<staffGrp symbol=\"brace\" bar.thru=\"true\">"
+                      "<staffDef n=\"1\" lines=\"5\" clef.shape=\"G\" clef.line=\"2\"/>"
+                      "<staffDef n=\"2\" lines=\"5\" clef.shape=\"F\" clef.line=\"4\"/>"
+                      "</staffGrp></scoreDef><section>";
+    for (int measure = 1; measure <= measureCount; ++measure) {
+        const std::string prefix = "n" + std::to_string(measure) + "-";
+        mei += "<measure n=\"" + std::to_string(measure) + "\">";
+        for (int staff = 1; staff <= 2; ++staff) {
+            mei += "<staff n=\"" + std::to_string(staff) + "\"><layer n=\"1\">";
+            for (int beam = 0; beam < 2; ++beam) {
+                mei += "<beam>";
+                for (int note = beam * 4 + 1; note <= beam * 4 + 4; ++note) {
+                    // Arpeggios going up and down over two octaves
+                    const int step = (measure * 3 + note * ((beam == measure % 2) ? 2 : -2) + 28) % 14;
+                    const std::string oct = std::to_string(((staff == 1) ? 4 : 2) + step / 7);
+                    mei += "<note xml:id=\"" + prefix + std::to_string(staff) + "-" + std::to_string(note)
+                        + "\" dur=\"8\" pname=\"" + pnames.at(step % 7) + "\" oct=\"" + oct + "\"/>";
+                }
+                mei += "</beam>";
+            }
+            mei += "</layer></staff>";
+        }
+        for (int staff = 1; staff <= 2; ++staff) {
+            const std::string note = prefix + std::to_string(staff) + "-";
+            mei += "<slur startid=\"#" + note + "1\" endid=\"#" + note + "4\"/>";
+            mei += "<slur startid=\"#" + note + "5\" endid=\"#" + note + "8\"/>";
+            if ((measure % 2 == 1) && (measure < measureCount)) {
+                const std::string nextNote = "n" + std::to_string(measure + 1) + "-" + std::to_string(staff) + "-";
+                mei += "<phrase startid=\"#" + note + "1\" endid=\"#" + nextNote + "8\"/>";
+            }
+        }
+        mei += "</measure>";
+    }
+    mei += "</section></score></mdiv></body></music></mei>\n";
+    return mei;
+}
+
+// Remove the postfix of the glyph ids, which is generated for each rendering
+static std::string RemoveGlyphPostfix(const std::string &svg)
+{
+    const size_t symbol = svg.find("<symbol id=\"");
+    if (symbol == std::string::npos) return svg;
+    const size_t start = svg.find('-', symbol);
+    const std::string postfix = svg.substr(start, svg.find('"', start) - start);
+    std::string result = svg;
+    for (size_t pos = result.find(postfix); pos != std::string::npos; pos = result.find(postfix, pos)) {
+        result.erase(pos, postfix.size());
+    }
+    return result;
+}
+
+// Render a page twice and check that the page replayed is the one drawn
+static bool CheckPageRendered(Toolkit &toolkit, int page, const std::string &order)
+{
+    const std::string svg = RemoveGlyphPostfix(toolkit.RenderToSVG(page));
+    if (svg != RemoveGlyphPostfix(toolkit.RenderToSVG(page))) {
+        return TestFail("breaksestimate",
+            "the page " + std::to_string(page) + " replayed when " + order + " differs from the one drawn");
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// Breaks estimate
+//----------------------------------------------------------------------------
+
+bool TestBreaksEstimate()
+{
+    const std::string data = GenerateSlurMEI(120);
+    for (bool backward : { false, true }) {
+        const std::string order = (backward) ? "rendering back to front" : "rendering in order";
+        Toolkit toolkit(false);
+        TestSetResourcePath(&toolkit);
+        // Small pages with slurs for the estimated system heights to be too low
+        toolkit.SetOptions("{\"breaksEstimate\": true, \"pageHeight\": 1000}");
+        if (!toolkit.LoadData(data)) return TestFail("breaksestimate", "the data cannot be loaded");
+        const int estimatedPageCount = toolkit.GetPageCount();
+
+        // The systems moved to the following pages rebuild the drawing scoreDefs of all of them, and the page count
+        // changes with the pages rendered
+        if (backward) {
+            for (int page = estimatedPageCount; page > 0; --page) {
+                if (!CheckPageRendered(toolkit, page, order)) return false;
+            }
+        }
+        else {
+            for (int page = 1; page <= toolkit.GetPageCount(); ++page) {
+                if (!CheckPageRendered(toolkit, page, order)) return false;
+            }
+        }
+        // Render all the pages again once laid out
+        for (int page = 1; page <= toolkit.GetPageCount(); ++page) {
+            if (!CheckPageRendered(toolkit, page, "rendering again")) return false;
+        }
+        if (toolkit.GetPageCount() <= estimatedPageCount) {
+            return TestFail("breaksestimate", "no system was moved to a following page " + order);
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// Slur layout benchmark
+//----------------------------------------------------------------------------
+
+void BenchmarkSlurs()
+{
+    Toolkit toolkit(false);
+    TestSetResourcePath(&toolkit);
+    toolkit.SetOptions("{\"pageHeight\": 2970, \"pageWidth\": 2100}");
+    if (!toolkit.LoadData(GenerateSlurMEI(200))) {
+        TestFail("slurs", "the data cannot be loaded");
+        return;
+    }
+
+    // The layout of the pages is redone for every iteration
+    const int iterations = 5;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        toolkit.RedoLayout();
+        for (int page = 1; page <= toolkit.GetPageCount(); ++page) toolkit.RenderToSVG(page);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double milliseconds = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+    std::cout << "slurs: " << toolkit.GetPageCount() << " pages laid out and rendered in " << milliseconds << " ms"
+              << std::endl;
+}
+
+} // namespace vrv
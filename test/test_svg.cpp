@@ -0,0 +1,50 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        test_svg.cpp
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "test.h"
+
+//----------------------------------------------------------------------------
+
+#include <set>
+
+//----------------------------------------------------------------------------
+
+#include "toolkit.h"
+
+namespace vrv {
+
+//----------------------------------------------------------------------------
+// SVG document
+//----------------------------------------------------------------------------
+
+bool TestSVGDocument()
+{
+    const std::string check = "svgdocument";
+
+    Toolkit toolkit(false);
+    TestSetResourcePath(&toolkit);
+    // The footer is drawn on every page
+    toolkit.SetOptions("{\"footer\": \"always\"}");
+    if (!toolkit.LoadData(TestGenerateMEI(100, 4, false))) return TestFail(check, "the data cannot be loaded");
+    if (toolkit.GetPageCount() < 2) return TestFail(check, "the data has only one page");
+
+    const std::string svg = toolkit.RenderToSVGDocument();
+    const std::string attribute = " id=\"";
+    std::set<std::string> ids;
+    for (size_t pos = svg.find(attribute); pos != std::string::npos; pos = svg.find(attribute, pos)) {
+        pos += attribute.size();
+        const std::string id = svg.substr(pos, svg.find('"', pos) - pos);
+        if (!ids.insert(id).second) {
+            return TestFail(check,
+                "the id '" + id + "' is not unique in the document of " + std::to_string(toolkit.GetPageCount())
+                    + " pages");
+        }
+    }
+    return true;
+}
+
+} // namespace vrv
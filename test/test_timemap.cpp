@@ -0,0 +1,101 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        test_timemap.cpp
+// Author:      agent
+// Created:     18/10/2026
+// Copyright (c) Authors and others. All rights reserved.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "test.h"
+
+//----------------------------------------------------------------------------
+
+#include <iostream>
+#include <vector>
+
+//----------------------------------------------------------------------------
+
+#include "toolkit.h"
+
+namespace vrv {
+
+static bool SetAttribute(
+    Toolkit &toolkit, const std::string &elementID, const std::string &attribute, const std::string &value)
+{
+    return toolkit.Edit("{\"action\": \"set\", \"param\": {\"elementId\": \"" + elementID + "\", \"attribute\": \""
+        + attribute + "\", \"value\": \"" + value + "\"}}");
+}
+
+// Check the timemap updated after a change against the one of a toolkit loading the changed data
+static bool CheckTimemap(Toolkit &toolkit, const std::string &options, const std::string &change)
+{
+    const std::string check = "timemap";
+    const std::string timemapOptions = "{\"includeMeasures\": true, \"includeRests\": true}";
+    const std::string elementsOptions = "{\"repeats\": true}";
+
+    const std::string timemap = toolkit.RenderToTimemap(timemapOptions);
+    const std::string times = toolkit.GetTimesForElements(elementsOptions);
+
+    Toolkit reference(false);
+    TestSetResourcePath(&reference);
+    reference.SetOptions(toolkit.GetOptions(false));
+    if (!reference.LoadData(toolkit.GetMEI())) return TestFail(check, "the changed data cannot be loaded");
+
+    if (timemap != reference.RenderToTimemap(timemapOptions)) {
+        return TestFail(check, "the timemap after " + change + " with " + options + " is not the one of the data");
+    }
+    if (times != reference.GetTimesForElements(elementsOptions)) {
+        return TestFail(
+            check, "the element times after " + change + " with " + options + " are not the ones of the data");
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// Timemap
+//----------------------------------------------------------------------------
+
+bool TestTimemap()
+{
+    // The editor toolkit is not created with Humdrum support
+#ifdef NO_HUMDRUM_SUPPORT
+    const bool edits = true;
+#else
+    const bool edits = false;
+    std::cout << "timemap: the edits are skipped since the editor is not available with Humdrum support" << std::endl;
+#endif
+
+    const std::vector<std::string> options = { "{}", "{\"expand\": \"exp\", \"expandTimeline\": true}" };
+    for (const std::string &option : options) {
+        Toolkit toolkit(false);
+        TestSetResourcePath(&toolkit);
+        toolkit.SetOptions(option);
+        if (!toolkit.LoadData(TestGenerateMEI(16, 2, true))) return TestFail("timemap", "the data cannot be loaded");
+        toolkit.RenderToSVG(1);
+        // Calculate the timemap first for the updates to be incremental
+        toolkit.RenderToTimemap();
+
+        if (!CheckTimemap(toolkit, option, "nothing")) return false;
+
+        if (edits) {
+            if (!SetAttribute(toolkit, "n5-1-2", "dur", "8")) return TestFail("timemap", "the edit cannot be applied");
+            toolkit.RenderToSVG(1);
+            if (!CheckTimemap(toolkit, option, "an edit in section A")) return false;
+
+            // The duration of the measure is left unchanged since it is not updated without laying out the page again
+            if (!SetAttribute(toolkit, "n12-2-3", "dur", "8") || !SetAttribute(toolkit, "n12-2-4", "dots", "1")) {
+                return TestFail("timemap", "the edits cannot be applied");
+            }
+            toolkit.RenderToSVG(1);
+            if (!CheckTimemap(toolkit, option, "edits in section B")) return false;
+        }
+        else if (SetAttribute(toolkit, "n5-1-2", "dur", "8")) {
+            return TestFail("timemap", "an edit is applied without the editor");
+        }
+
+        toolkit.SetOptions("{\"midiTempoAdjustment\": 1.5}");
+        if (!CheckTimemap(toolkit, option, "a tempo adjustment")) return false;
+    }
+    return true;
+}
+
+} // namespace vrv
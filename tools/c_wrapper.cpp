@@ -63,6 +63,12 @@ const char *vrvToolkit_getAvailableOptions(void *tkPtr)
     return tk->GetCString();
 }
 
+int vrvToolkit_getBinaryBufferSize(void *tkPtr)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    return tk->GetCBufferSize();
+}
+
 const char *vrvToolkit_getDescriptiveFeatures(void *tkPtr, const char *options)
 {
     Toolkit *tk = static_cast<Toolkit *>(tkPtr);
@@ -84,6 +90,13 @@ const char *vrvToolkit_getElementsAtTime(void *tkPtr, int millisec)
     return tk->GetCString();
 }
 
+const char *vrvToolkit_getElementsInTimeRange(void *tkPtr, int startMillisec, int endMillisec)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    tk->SetCString(tk->GetElementsInTimeRange(startMillisec, endMillisec));
+    return tk->GetCString();
+}
+
 const char *vrvToolkit_getExpansionIdsForElement(void *tkPtr, const char *xmlId)
 {
     Toolkit *tk = static_cast<Toolkit *>(tkPtr);
@@ -181,6 +194,13 @@ const char *vrvToolkit_getTimesForElement(void *tkPtr, const char *xmlId)
     return tk->GetCString();
 }
 
+const char *vrvToolkit_getTimesForElements(void *tkPtr, const char *c_options)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    tk->SetCString(tk->GetTimesForElements(c_options));
+    return tk->GetCString();
+}
+
 const char *vrvToolkit_getVersion(void *tkPtr)
 {
     Toolkit *tk = static_cast<Toolkit *>(tkPtr);
@@ -206,6 +226,22 @@ bool vrvToolkit_loadZipDataBuffer(void *tkPtr, const unsigned char *data, int le
     return tk->LoadZipDataBuffer(data, length);
 }
 
+const char *vrvToolkit_renderToBinary(void *tkPtr, int page_no)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    tk->SetCString(tk->RenderToBinary(page_no));
+    return tk->GetCString();
+}
+
+const unsigned char *vrvToolkit_renderToBinaryBuffer(void *tkPtr, int page_no)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    std::vector<unsigned char> output;
+    tk->RenderToBinary(output, page_no);
+    tk->SetCBuffer(output);
+    return tk->GetCBuffer();
+}
+
 const char *vrvToolkit_renderToMIDI(void *tkPtr, const char *c_options)
 {
     Toolkit *tk = static_cast<Toolkit *>(tkPtr);
@@ -213,6 +249,20 @@ const char *vrvToolkit_renderToMIDI(void *tkPtr, const char *c_options)
     return tk->GetCString();
 }
 
+const char *vrvToolkit_renderToMIDIChunk(void *tkPtr, const char *c_options)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    tk->SetCString(tk->RenderToMIDIChunk(c_options));
+    return tk->GetCString();
+}
+
+const char *vrvToolkit_renderToMIDIEvents(void *tkPtr)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    tk->SetCString(tk->RenderToMIDIEvents());
+    return tk->GetCString();
+}
+
 const char *vrvToolkit_renderToPAE(void *tkPtr)
 {
     Toolkit *tk = static_cast<Toolkit *>(tkPtr);
@@ -220,6 +270,22 @@ const char *vrvToolkit_renderToPAE(void *tkPtr)
     return tk->GetCString();
 }
 
+const char *vrvToolkit_renderToPNG(void *tkPtr, int page_no)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    tk->SetCString(tk->RenderToPNG(page_no));
+    return tk->GetCString();
+}
+
+const unsigned char *vrvToolkit_renderToPNGBuffer(void *tkPtr, int page_no)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    std::vector<unsigned char> output;
+    tk->RenderToPNG(output, page_no);
+    tk->SetCBuffer(output);
+    return tk->GetCBuffer();
+}
+
 const char *vrvToolkit_renderToSVG(void *tkPtr, int page_no, bool xmlDeclaration)
 {
     Toolkit *tk = static_cast<Toolkit *>(tkPtr);
@@ -227,6 +293,43 @@ const char *vrvToolkit_renderToSVG(void *tkPtr, int page_no, bool xmlDeclaration
     return tk->GetCString();
 }
 
+const char *vrvToolkit_renderToSVGDocument(void *tkPtr, const char *c_options)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    tk->SetCString(tk->RenderToSVGDocument(c_options));
+    return tk->GetCString();
+}
+
+const char *vrvToolkit_renderToSVGPages(void *tkPtr, const char *c_options)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    tk->SetCString(tk->RenderToSVGPages(c_options));
+    return tk->GetCString();
+}
+
+const char *vrvToolkit_renderToSVGRegion(void *tkPtr, int page_no, const char *c_options)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    tk->SetCString(tk->RenderToSVGRegion(page_no, c_options));
+    return tk->GetCString();
+}
+
+const char *vrvToolkit_renderToSVGZ(void *tkPtr, int page_no)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    tk->SetCString(tk->RenderToSVGZ(page_no));
+    return tk->GetCString();
+}
+
+const unsigned char *vrvToolkit_renderToSVGZBuffer(void *tkPtr, int page_no)
+{
+    Toolkit *tk = static_cast<Toolkit *>(tkPtr);
+    std::vector<unsigned char> output;
+    tk->RenderToSVGZ(output, page_no);
+    tk->SetCBuffer(output);
+    return tk->GetCBuffer();
+}
+
 const char *vrvToolkit_renderToTimemap(void *tkPtr, const char *c_options)
 {
     Toolkit *tk = static_cast<Toolkit *>(tkPtr);
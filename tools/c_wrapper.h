@@ -19,9 +19,11 @@ void *vrvToolkit_constructorResourcePath(const char *resourcePath);
 void vrvToolkit_destructor(void *tkPtr);
 bool vrvToolkit_edit(void *tkPtr, const char *editorAction);
 const char *vrvToolkit_getAvailableOptions(void *tkPtr);
+int vrvToolkit_getBinaryBufferSize(void *tkPtr);
 const char *vrvToolkit_getDescriptiveFeatures(void *tkPtr, const char *options);
 const char *vrvToolkit_getElementAttr(void *tkPtr, const char *xmlId);
 const char *vrvToolkit_getElementsAtTime(void *tkPtr, int millisec);
+const char *vrvToolkit_getElementsInTimeRange(void *tkPtr, int startMillisec, int endMillisec);
 const char *vrvToolkit_getExpansionIdsForElement(void *tkPtr, const char *xmlId);
 const char *vrvToolkit_getHumdrum(void *tkPtr);
 const char *vrvToolkit_convertHumdrumToHumdrum(void *tkPtr, const char *humdrumData);
@@ -35,13 +37,25 @@ const char *vrvToolkit_getOptions(void *tkPtr, bool default_values);
 int vrvToolkit_getPageCount(void *tkPtr);
 int vrvToolkit_getPageWithElement(void *tkPtr, const char *xmlId);
 double vrvToolkit_getTimeForElement(void *tkPtr, const char *xmlId);
+const char *vrvToolkit_getTimesForElements(void *tkPtr, const char *c_options);
 const char *vrvToolkit_getVersion(void *tkPtr);
 bool vrvToolkit_loadData(void *tkPtr, const char *data);
 bool vrvToolkit_loadZipDataBase64(void *tkPtr, const char *data);
 bool vrvToolkit_loadZipDataBuffer(void *tkPtr, const unsigned char *data, int length);
+const char *vrvToolkit_renderToBinary(void *tkPtr, int page_no);
+const unsigned char *vrvToolkit_renderToBinaryBuffer(void *tkPtr, int page_no);
 const char *vrvToolkit_renderToMIDI(void *tkPtr, const char *c_options);
+const char *vrvToolkit_renderToMIDIChunk(void *tkPtr, const char *c_options);
+const char *vrvToolkit_renderToMIDIEvents(void *tkPtr);
 const char *vrvToolkit_renderToPAE(void *tkPtr);
+const char *vrvToolkit_renderToPNG(void *tkPtr, int page_no);
+const unsigned char *vrvToolkit_renderToPNGBuffer(void *tkPtr, int page_no);
 const char *vrvToolkit_renderToSVG(void *tkPtr, int page_no, bool xmlDeclaration);
+const char *vrvToolkit_renderToSVGDocument(void *tkPtr, const char *c_options);
+const char *vrvToolkit_renderToSVGPages(void *tkPtr, const char *c_options);
+const char *vrvToolkit_renderToSVGRegion(void *tkPtr, int page_no, const char *c_options);
+const char *vrvToolkit_renderToSVGZ(void *tkPtr, int page_no);
+const unsigned char *vrvToolkit_renderToSVGZBuffer(void *tkPtr, int page_no);
 const char *vrvToolkit_renderToTimemap(void *tkPtr, const char *c_options);
 void vrvToolkit_redoLayout(void *tkPtr, const char *c_options);
 void vrvToolkit_redoPagePitchPosLayout(void *tkPtr);
@@ -167,7 +167,8 @@ void display_usage(const vrv::Options *options, const std::string &category)
     const std::map<vrv::OptionsCategory, std::string> categories = { { vrv::OptionsCategory::Base, "base" },
         { vrv::OptionsCategory::General, "general" }, { vrv::OptionsCategory::Layout, "layout" },
         { vrv::OptionsCategory::Margins, "margins" }, { vrv::OptionsCategory::Midi, "midi" },
-        { vrv::OptionsCategory::Selectors, "selectors" }, { vrv::OptionsCategory::Full, "full" } };
+        { vrv::OptionsCategory::Selectors, "selectors" }, { vrv::OptionsCategory::Output, "output" },
+        { vrv::OptionsCategory::Full, "full" } };
 
     std::cout.precision(2);
 
@@ -427,12 +428,15 @@ int main(int argc, char **argv)
         exit(1);
     }
 
+#ifndef EMBED_RESOURCES
     // Make sure the user uses a valid Resource path
     // Save many headaches for empty SVGs
+    // Not necessary with embedded resources
     if (!dir_exists(resourcePath)) {
         std::cerr << "The resource path " << resourcePath << " could not be found; please use -r option." << std::endl;
         exit(1);
     }
+#endif
 
     // Load the music font from the resource directory
     if (!toolkit.SetResourcePath(resourcePath)) {
@@ -451,11 +455,13 @@ int main(int argc, char **argv)
         outformat = "mei-pb";
         vrv::LogWarning("Output to 'pb-mei' is deprecated, use 'mei-pb' instead.");
     }
-    if ((outformat != "svg") && (outformat != "mei") && (outformat != "mei-basic") && (outformat != "mei-pb")
-        && (outformat != "midi") && (outformat != "timemap") && (outformat != "humdrum") && (outformat != "hum")
-        && (outformat != "pae")) {
+    if ((outformat != "svg") && (outformat != "svgz") && (outformat != "binary") && (outformat != "png")
+        && (outformat != "mei") && (outformat != "mei-basic") && (outformat != "mei-pb") && (outformat != "midi")
+        && (outformat != "timemap") && (outformat != "humdrum") && (outformat != "hum") && (outformat != "pae")) {
         std::cerr << "Output format (" << outformat
-                  << ") can only be 'mei', 'mei-basic', 'mei-pb', 'svg', 'midi', 'humdrum' or 'pae'." << std::endl;
+                  << ") can only be 'mei', 'mei-basic', 'mei-pb', 'svg', 'svgz', 'binary', 'png', 'midi', 'humdrum' or "
+                     "'pae'."
+                  << std::endl;
         exit(1);
     }
 
@@ -521,7 +527,34 @@ int main(int argc, char **argv)
         to = toolkit.GetPageCount() + 1;
     }
 
-    if (outformat == "svg") {
+    if ((outformat == "svg") && all_pages && !std_output && options->m_svgGlyphSprite.GetValue()) {
+        // The glyphs are defined once in a sprite file referenced by all the pages
+        std::string spriteFile = outfile + "_glyphs.svg";
+        std::string spriteHref = spriteFile.substr(spriteFile.find_last_of("/\\") + 1);
+        std::vector<std::string> pages;
+        std::string sprite;
+        toolkit.RenderToSVGPages(from, to - 1, spriteHref, pages, sprite, true);
+        std::ofstream spriteStream(spriteFile.c_str());
+        if (!spriteStream.is_open()) {
+            std::cerr << "Unable to write SVG to " << spriteFile << "." << std::endl;
+            exit(1);
+        }
+        spriteStream << sprite;
+        spriteStream.close();
+        std::cerr << "Output written to " << spriteFile << "." << std::endl;
+        for (int p = from; p < to; ++p) {
+            std::string cur_outfile = outfile + vrv::StringFormat("_%03d", p) + ".svg";
+            std::ofstream pageStream(cur_outfile.c_str());
+            if (!pageStream.is_open()) {
+                std::cerr << "Unable to write SVG to " << cur_outfile << "." << std::endl;
+                exit(1);
+            }
+            pageStream << pages.at(p - from);
+            pageStream.close();
+            std::cerr << "Output written to " << cur_outfile << "." << std::endl;
+        }
+    }
+    else if (outformat == "svg") {
         int p;
         for (p = from; p < to; ++p) {
             std::string cur_outfile = outfile;
@@ -542,6 +575,73 @@ int main(int argc, char **argv)
         }
     }
 
+    else if (outformat == "svgz") {
+        int p;
+        for (p = from; p < to; ++p) {
+            std::string cur_outfile = outfile;
+            if (all_pages) {
+                cur_outfile += vrv::StringFormat("_%03d", p);
+            }
+            cur_outfile += ".svgz";
+            if (std_output) {
+                std::vector<unsigned char> output;
+                toolkit.RenderToSVGZ(output, p);
+                std::cout.write(reinterpret_cast<const char *>(output.data()), output.size());
+            }
+            else if (!toolkit.RenderToSVGZFile(cur_outfile, p)) {
+                std::cerr << "Unable to write SVGZ to " << cur_outfile << "." << std::endl;
+                exit(1);
+            }
+            else {
+                std::cerr << "Output written to " << cur_outfile << "." << std::endl;
+            }
+        }
+    }
+
+    else if (outformat == "binary") {
+        int p;
+        for (p = from; p < to; ++p) {
+            std::string cur_outfile = outfile;
+            if (all_pages) {
+                cur_outfile += vrv::StringFormat("_%03d", p);
+            }
+            cur_outfile += ".vrvb";
+            if (std_output) {
+                std::vector<unsigned char> output;
+                toolkit.RenderToBinary(output, p);
+                std::cout.write(reinterpret_cast<const char *>(output.data()), output.size());
+            }
+            else if (!toolkit.RenderToBinaryFile(cur_outfile, p)) {
+                std::cerr << "Unable to write binary output to " << cur_outfile << "." << std::endl;
+                exit(1);
+            }
+            else {
+                std::cerr << "Output written to " << cur_outfile << "." << std::endl;
+            }
+        }
+    }
+    else if (outformat == "png") {
+        int p;
+        for (p = from; p < to; ++p) {
+            std::string cur_outfile = outfile;
+            if (all_pages) {
+                cur_outfile += vrv::StringFormat("_%03d", p);
+            }
+            cur_outfile += ".png";
+            if (std_output) {
+                std::vector<unsigned char> output;
+                toolkit.RenderToPNG(output, p);
+                std::cout.write(reinterpret_cast<const char *>(output.data()), output.size());
+            }
+            else if (!toolkit.RenderToPNGFile(cur_outfile, p)) {
+                std::cerr << "Unable to write PNG to " << cur_outfile << "." << std::endl;
+                exit(1);
+            }
+            else {
+                std::cerr << "Output written to " << cur_outfile << "." << std::endl;
+            }
+        }
+    }
     else if (outformat == "hummidi") {
         std::string humdata;
         if (infile == "-") {